@@ -0,0 +1,31 @@
+// src/ais_class_b_cache.cpp
+//
+// Bounded per-MMSI cache of AIS Type 24 (Class B static data) halves.
+
+#include "ais_class_b_cache.h"
+
+namespace halmet {
+
+AisClassBStatic* AisClassBStaticCache::get(uint32_t mmsi, uint32_t now_ms) {
+  if (mmsi == 0) return nullptr;
+  AisClassBStatic* victim = nullptr;
+  for (AisClassBStatic& e : entries_) {
+    if (e.mmsi == mmsi) {
+      e.updated_ms = now_ms;
+      return &e;
+    }
+    if (e.mmsi == 0) {
+      if (!victim || victim->mmsi != 0) victim = &e;
+    } else if (!victim || (victim->mmsi != 0 &&
+                           now_ms - e.updated_ms > now_ms - victim->updated_ms)) {
+      victim = &e;
+    }
+  }
+  if (victim->mmsi != 0) evicted_++;
+  *victim = AisClassBStatic{};
+  victim->mmsi = mmsi;
+  victim->updated_ms = now_ms;
+  return victim;
+}
+
+}  // namespace halmet
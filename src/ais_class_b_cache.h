@@ -0,0 +1,57 @@
+#ifndef HALMET_SRC_AIS_CLASS_B_CACHE_H_
+#define HALMET_SRC_AIS_CLASS_B_CACHE_H_
+
+#include <cstdint>
+
+namespace halmet {
+
+/**
+ * @brief Class B static data assembled from AIS Type 24 parts A and B.
+ */
+struct AisClassBStatic {
+  uint32_t mmsi = 0;  // 0 marks an unused slot
+  uint32_t updated_ms = 0;
+  bool has_part_a = false;
+  bool has_part_b = false;
+
+  // Part A
+  char name[21] = "";
+
+  // Part B
+  uint8_t ship_type = 0;
+  char vendor[8] = "";
+  char callsign[8] = "";
+  uint16_t to_bow = 0;
+  uint16_t to_stern = 0;
+  uint8_t to_port = 0;
+  uint8_t to_stbd = 0;
+  uint32_t mothership_mmsi = 0;  // auxiliary craft (MMSI 98xxxxxxx) only
+
+  bool complete() const { return has_part_a && has_part_b; }
+};
+
+/**
+ * @brief Bounded cache of Type 24 halves per MMSI.
+ *
+ * Class B units send part A (name) and part B (type, callsign, dimensions)
+ * as separate messages, often minutes apart. Entries live in a fixed
+ * array; when it is full the entry updated least recently is reused, so a
+ * marina full of Class B boats can't grow memory use.
+ */
+class AisClassBStaticCache {
+ public:
+  static constexpr int kCapacity = 128;
+
+  // Find or claim the entry for mmsi and mark it updated at now_ms.
+  AisClassBStatic* get(uint32_t mmsi, uint32_t now_ms);
+
+  uint32_t evicted() const { return evicted_; }
+
+ private:
+  AisClassBStatic entries_[kCapacity];
+  uint32_t evicted_ = 0;
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_AIS_CLASS_B_CACHE_H_
@@ -0,0 +1,171 @@
+// src/ais_collision.cpp
+//
+// Incremental CPA/TCPA assessment over the AIS target set.
+
+#include "ais_collision.h"
+
+#include <cmath>
+
+namespace halmet {
+
+static constexpr float kDegToRad = 0.017453292f;
+static constexpr float kE7ToNm = 60.0f / 1e7f;
+// Below this relative speed the geometry is not changing in any meaningful
+// way: the target is neither closing nor opening, so it is never flagged.
+static constexpr float kMinRelativeKn = 0.1f;
+
+static bool valid_position(int32_t lat_e7, int32_t lon_e7) {
+  return lat_e7 >= -900000000 && lat_e7 <= 900000000 &&
+         lon_e7 >= -1800000000 && lon_e7 <= 1800000000;
+}
+
+// Knots east / north from SOG and COG; zero when either is unknown.
+static void velocity(float sog_kn, float cog_deg, float* ve, float* vn) {
+  if (sog_kn < 0.0f || sog_kn >= 102.3f || cog_deg < 0.0f ||
+      cog_deg >= 360.0f) {
+    *ve = *vn = 0.0f;
+    return;
+  }
+  *ve = sog_kn * std::sin(cog_deg * kDegToRad);
+  *vn = sog_kn * std::cos(cog_deg * kDegToRad);
+}
+
+static int32_t cell(int32_t e7) {
+  return e7 >= 0 ? e7 / AisCollisionEngine::kCellE7
+                 : -((-e7 - 1) / AisCollisionEngine::kCellE7) - 1;
+}
+
+AisCollisionEngine::AisCollisionEngine() {
+  for (int16_t& h : head_) h = -1;
+  for (int i = 0; i < kSlots; i++) next_[i] = bucket_[i] = -1;
+}
+
+int AisCollisionEngine::bucket_of_cell(int32_t cell_lat, int32_t cell_lon) {
+  uint32_t h = (uint32_t)cell_lat * 0x9E3779B1u ^ (uint32_t)cell_lon * 0x85EBCA77u;
+  return (int)(h >> 24) & (kBuckets - 1);
+}
+
+int AisCollisionEngine::bucket(int32_t lat_e7, int32_t lon_e7) {
+  return bucket_of_cell(cell(lat_e7), cell(lon_e7));
+}
+
+void AisCollisionEngine::unlink(int slot) {
+  int b = bucket_[slot];
+  if (b < 0) return;
+  int16_t* link = &head_[b];
+  while (*link >= 0 && *link != slot) link = &next_[*link];
+  if (*link == slot) *link = next_[slot];
+  next_[slot] = bucket_[slot] = -1;
+}
+
+void AisCollisionEngine::assess(int slot) {
+  // Flat-earth offsets from own ship in nautical miles
+  int64_t dlon = (int64_t)lon_e7_[slot] - own_lon_e7_;
+  if (dlon > 1800000000) dlon -= 3600000000LL;
+  if (dlon < -1800000000) dlon += 3600000000LL;
+  float dx = (float)dlon * kE7ToNm * own_cos_lat_;
+  float dy = (float)((int64_t)lat_e7_[slot] - own_lat_e7_) * kE7ToNm;
+  float rvx = ve_[slot] - own_ve_;
+  float rvy = vn_[slot] - own_vn_;
+
+  float range = std::sqrt(dx * dx + dy * dy);
+  float v2 = rvx * rvx + rvy * rvy;
+  bool moving = v2 >= kMinRelativeKn * kMinRelativeKn;
+  float tcpa_h = moving ? -(dx * rvx + dy * rvy) / v2 : 0.0f;
+  float cpa = range;
+  if (tcpa_h > 0.0f) {
+    float cx = dx + rvx * tcpa_h;
+    float cy = dy + rvy * tcpa_h;
+    cpa = std::sqrt(cx * cx + cy * cy);
+  }
+
+  range_nm_[slot] = range;
+  cpa_nm_[slot] = cpa;
+  tcpa_min_[slot] = tcpa_h * 60.0f;
+  danger_[slot] = moving && tcpa_h > 0.0f && cpa < settings_.cpa_alarm_nm &&
+                  tcpa_h * 60.0f <= settings_.tcpa_alarm_min;
+}
+
+void AisCollisionEngine::update_own(int32_t lat_e7, int32_t lon_e7,
+                                    float sog_kn, float cog_deg,
+                                    uint32_t now_ms) {
+  if (!valid_position(lat_e7, lon_e7)) return;
+  own_lat_e7_ = lat_e7;
+  own_lon_e7_ = lon_e7;
+  own_cos_lat_ = std::cos(lat_e7 * (kDegToRad / 1e7f));
+  velocity(sog_kn, cog_deg, &own_ve_, &own_vn_);
+  own_ms_ = now_ms ? now_ms : 1;
+
+  // Reassess only the targets in the cells around own ship.
+  int32_t clat = cell(lat_e7), clon = cell(lon_e7);
+  for (int i = -kGridReach; i <= kGridReach; i++) {
+    for (int j = -kGridReach; j <= kGridReach; j++) {
+      for (int s = head_[bucket_of_cell(clat + i, clon + j)]; s >= 0;
+           s = next_[s]) {
+        assess(s);
+      }
+    }
+  }
+}
+
+void AisCollisionEngine::update_target(int slot, uint32_t mmsi,
+                                       int32_t lat_e7, int32_t lon_e7,
+                                       float sog_kn, float cog_deg,
+                                       uint32_t now_ms) {
+  if (slot < 0 || slot >= kSlots) return;
+  if (!valid_position(lat_e7, lon_e7)) {
+    release(slot);
+    return;
+  }
+
+  int b = bucket(lat_e7, lon_e7);
+  if (b != bucket_[slot]) {
+    unlink(slot);
+    next_[slot] = head_[b];
+    head_[b] = (int16_t)slot;
+    bucket_[slot] = (int16_t)b;
+  }
+
+  mmsi_[slot] = mmsi;
+  seen_ms_[slot] = now_ms;
+  lat_e7_[slot] = lat_e7;
+  lon_e7_[slot] = lon_e7;
+  velocity(sog_kn, cog_deg, &ve_[slot], &vn_[slot]);
+  if (own_valid(now_ms)) {
+    assess(slot);
+  } else {
+    danger_[slot] = false;
+  }
+}
+
+void AisCollisionEngine::release(int slot) {
+  if (slot < 0 || slot >= kSlots) return;
+  unlink(slot);
+  mmsi_[slot] = 0;
+  danger_[slot] = false;
+}
+
+int AisCollisionEngine::dangerous(uint32_t now_ms,
+                                  AisCollisionInfo* worst) const {
+  int count = 0;
+  int best = -1;
+  if (own_valid(now_ms)) {
+    for (int i = 0; i < kSlots; i++) {
+      if (!danger_[i] || now_ms - seen_ms_[i] >= kStaleMs) continue;
+      count++;
+      if (best < 0 || tcpa_min_[i] < tcpa_min_[best]) best = i;
+    }
+  }
+  if (worst) {
+    *worst = AisCollisionInfo{};
+    if (best >= 0) {
+      worst->mmsi = mmsi_[best];
+      worst->range_nm = range_nm_[best];
+      worst->cpa_nm = cpa_nm_[best];
+      worst->tcpa_min = tcpa_min_[best];
+    }
+  }
+  return count;
+}
+
+}  // namespace halmet
@@ -0,0 +1,107 @@
+#ifndef HALMET_SRC_AIS_COLLISION_H_
+#define HALMET_SRC_AIS_COLLISION_H_
+
+#include <cstdint>
+
+#include "ais_target_table.h"
+
+namespace halmet {
+
+struct AisCollisionSettings {
+  float cpa_alarm_nm = 0.5f;     // closer than this at CPA is dangerous...
+  float tcpa_alarm_min = 12.0f;  // ...if CPA is no further ahead than this
+};
+
+/**
+ * @brief Closest-approach result for one target.
+ */
+struct AisCollisionInfo {
+  uint32_t mmsi = 0;
+  float range_nm = 0.0f;
+  float cpa_nm = 0.0f;
+  float tcpa_min = 0.0f;  // negative once the target is opening
+};
+
+/**
+ * @brief Incremental CPA/TCPA assessment of AIS targets against own ship.
+ *
+ * Target state is kept as a structure of arrays indexed by the target's
+ * AisTargetTable slot, so there is no second MMSI lookup and the hot
+ * fields of many targets share cache lines. Each report recomputes CPA
+ * for that one target only, in single-precision float on flat-earth
+ * offsets from own ship.
+ *
+ * A coarse grid (0.1° cells hashed into kBuckets chains) indexes targets
+ * by position. When own ship's fix changes, only targets in the cells
+ * around it are reassessed; distant targets are reassessed when they
+ * next report.
+ */
+class AisCollisionEngine {
+ public:
+  static constexpr int kSlots = AisTargetTable::kCapacity;
+  static constexpr int kBuckets = 256;
+  static constexpr int32_t kCellE7 = 1000000;  // 0.1° ≈ 6 nm of latitude
+  static constexpr int kGridReach = 2;         // cells each side of own ship
+  static constexpr uint32_t kStaleMs = 180000;
+
+  AisCollisionEngine();
+
+  void configure(const AisCollisionSettings& settings) {
+    settings_ = settings;
+  }
+
+  // Own-ship fix in 1e-7 degrees; sog/cog negative when unknown.
+  void update_own(int32_t lat_e7, int32_t lon_e7, float sog_kn,
+                  float cog_deg, uint32_t now_ms);
+
+  // One target report. slot is the target's AisTargetTable slot.
+  void update_target(int slot, uint32_t mmsi, int32_t lat_e7, int32_t lon_e7,
+                     float sog_kn, float cog_deg, uint32_t now_ms);
+
+  // Forget whatever the slot held, e.g. when AisTargetTable hands it to a
+  // new MMSI.
+  void release(int slot);
+
+  // Number of dangerous targets and the one with the earliest CPA.
+  int dangerous(uint32_t now_ms, AisCollisionInfo* worst) const;
+
+ private:
+  bool own_valid(uint32_t now_ms) const {
+    return own_ms_ != 0 && now_ms - own_ms_ < kStaleMs;
+  }
+  static int bucket(int32_t lat_e7, int32_t lon_e7);
+  static int bucket_of_cell(int32_t cell_lat, int32_t cell_lon);
+  void unlink(int slot);
+  void assess(int slot);
+
+  AisCollisionSettings settings_;
+
+  // Own ship
+  int32_t own_lat_e7_ = 0;
+  int32_t own_lon_e7_ = 0;
+  float own_cos_lat_ = 1.0f;
+  float own_ve_ = 0.0f;  // knots east / north
+  float own_vn_ = 0.0f;
+  uint32_t own_ms_ = 0;
+
+  // Targets, structure of arrays
+  uint32_t mmsi_[kSlots] = {};  // 0 marks an unused slot
+  uint32_t seen_ms_[kSlots] = {};
+  int32_t lat_e7_[kSlots] = {};
+  int32_t lon_e7_[kSlots] = {};
+  float ve_[kSlots] = {};
+  float vn_[kSlots] = {};
+  float range_nm_[kSlots] = {};
+  float cpa_nm_[kSlots] = {};
+  float tcpa_min_[kSlots] = {};
+  bool danger_[kSlots] = {};
+
+  // Grid: bucket heads and per-slot chain links, -1 terminated
+  int16_t head_[kBuckets];
+  int16_t next_[kSlots];
+  int16_t bucket_[kSlots];
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_AIS_COLLISION_H_
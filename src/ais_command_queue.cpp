@@ -0,0 +1,101 @@
+// src/ais_command_queue.cpp
+//
+// Non-blocking command/response queue for the AIS transponder.
+
+#include "ais_command_queue.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace halmet {
+
+bool AisCommandQueue::push(const char* cmd, const char* reply_key,
+                           AisCommandCallback callback, uint32_t timeout_ms,
+                           uint8_t retries) {
+  if (count_ == kMaxCommands || strlen(cmd) >= kMaxCommandLen ||
+      (reply_key && strlen(reply_key) >= kReplyKeyLen)) {
+    stats_.dropped++;
+    return false;
+  }
+  Command& c = queue_[(head_ + count_) % kMaxCommands];
+  strcpy(c.text, cmd);
+  strcpy(c.reply_key, reply_key ? reply_key : "");
+  c.callback = callback;
+  c.timeout_ms = timeout_ms;
+  c.retries_left = retries;
+  count_++;
+  return true;
+}
+
+bool AisCommandQueue::transmit(const Command& c) {
+  // NMEA checksum: XOR of characters after the leading '$'/'!' up to '*'
+  uint8_t cksum = 0;
+  for (const char* p = c.text + 1; *p && *p != '*'; p++) cksum ^= (uint8_t)*p;
+  char framed[kMaxCommandLen + 6];
+  int len = snprintf(framed, sizeof(framed), "%s*%02X\r\n", c.text, cksum);
+  if (len <= 0 || (size_t)len > kTxRingSize - (tx_head_ - tx_tail_)) {
+    return false;
+  }
+  for (int i = 0; i < len; i++) tx_[(tx_head_ + i) & (kTxRingSize - 1)] = framed[i];
+  tx_head_ += len;
+  sent_mark_ = tx_head_;
+  stats_.sent++;
+  return true;
+}
+
+void AisCommandQueue::finish(AisCommandStatus status,
+                             const Nmea0183Sentence* reply) {
+  AisCommandCallback cb = queue_[head_].callback;
+  head_ = (head_ + 1) % kMaxCommands;
+  count_--;
+  in_flight_ = false;
+  if (cb) cb(status, reply);
+}
+
+bool AisCommandQueue::on_sentence(const Nmea0183Sentence& s, uint32_t now_ms) {
+  if (!in_flight_ || !queue_[head_].reply_key[0]) return false;
+  if (!s.address().equals("PSRT") ||
+      !s.field(1).equals(queue_[head_].reply_key)) {
+    return false;
+  }
+  stats_.replied++;
+  stats_.last_reply_ms = now_ms ? now_ms : 1;
+  finish(AisCommandStatus::kReplied, &s);
+  return true;
+}
+
+void AisCommandQueue::pump(uint32_t now_ms, AisCommandWriter writer) {
+  if (in_flight_) {
+    Command& c = queue_[head_];
+    bool on_wire = (long)(tx_tail_ - sent_mark_) >= 0;
+    if (!c.reply_key[0]) {
+      if (on_wire) finish(AisCommandStatus::kSent, nullptr);
+    } else if (on_wire && now_ms - sent_ms_ >= c.timeout_ms) {
+      if (c.retries_left > 0 && transmit(c)) {
+        c.retries_left--;
+        stats_.retries++;
+        sent_ms_ = now_ms;
+      } else {
+        stats_.timeouts++;
+        finish(AisCommandStatus::kTimeout, nullptr);
+      }
+    }
+  }
+
+  if (!in_flight_ && count_ > 0 && transmit(queue_[head_])) {
+    in_flight_ = true;
+    sent_ms_ = now_ms;
+  }
+
+  // Drain the TX ring in at most two contiguous pieces.
+  while (writer && tx_tail_ != tx_head_) {
+    size_t off = tx_tail_ & (kTxRingSize - 1);
+    size_t len = tx_head_ - tx_tail_;
+    if (len > kTxRingSize - off) len = kTxRingSize - off;
+    size_t n = writer(tx_ + off, len);
+    tx_tail_ += n;
+    if (n < len) break;
+  }
+}
+
+}  // namespace halmet
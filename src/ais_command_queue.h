@@ -0,0 +1,103 @@
+#ifndef HALMET_SRC_AIS_COMMAND_QUEUE_H_
+#define HALMET_SRC_AIS_COMMAND_QUEUE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "nmea0183_sentence.h"
+
+namespace halmet {
+
+enum class AisCommandStatus : uint8_t {
+  kReplied,  // matching $PSRT reply received
+  kSent,     // no reply expected; fully written to the UART
+  kTimeout,  // no reply after all retries
+};
+
+// Completion callback. reply is the matching sentence for kReplied,
+// otherwise nullptr.
+using AisCommandCallback = void (*)(AisCommandStatus status,
+                                    const Nmea0183Sentence* reply);
+
+// Writes up to len bytes without blocking, returns how many it took.
+using AisCommandWriter = size_t (*)(const char* data, size_t len);
+
+struct AisCommandStats {
+  uint32_t sent = 0;         // transmissions, including retries
+  uint32_t replied = 0;
+  uint32_t retries = 0;
+  uint32_t timeouts = 0;     // commands that never got a reply
+  uint32_t dropped = 0;      // rejected because the queue was full
+  uint32_t last_reply_ms = 0;
+};
+
+/**
+ * @brief Non-blocking command/response queue for the transponder port.
+ *
+ * Commands wait in a fixed queue and go out one at a time: the next one is
+ * framed (checksum + CRLF) into a bounded TX ring only after the current
+ * one has been answered, timed out, or — when no reply is expected — fully
+ * written. pump() hands the ring to the writer as far as the UART FIFO has
+ * room, so nothing ever waits on Serial2.
+ *
+ * A reply matches the command in flight when it is a $PSRT sentence whose
+ * first field equals the command's reply key ("LED" for "$DUAIQ,LED").
+ */
+class AisCommandQueue {
+ public:
+  static constexpr int kMaxCommands = 8;
+  static constexpr int kMaxCommandLen = 72;
+  static constexpr int kReplyKeyLen = 8;
+  static constexpr size_t kTxRingSize = 256;  // power of two
+
+  /**
+   * @brief Queue a command.
+   *
+   * @param cmd Sentence without checksum, e.g. "$DUAIQ,LED".
+   * @param reply_key $PSRT field 1 that answers it, or nullptr if the
+   *   command gets no reply.
+   * @return false if the queue is full or the command too long.
+   */
+  bool push(const char* cmd, const char* reply_key = nullptr,
+            AisCommandCallback callback = nullptr, uint32_t timeout_ms = 1000,
+            uint8_t retries = 2);
+
+  // Offer a received sentence; returns true if it answered the command in
+  // flight.
+  bool on_sentence(const Nmea0183Sentence& s, uint32_t now_ms);
+
+  // Advance timeouts, start the next command and drain the TX ring.
+  void pump(uint32_t now_ms, AisCommandWriter writer);
+
+  int pending() const { return count_; }
+  const AisCommandStats& stats() const { return stats_; }
+
+ private:
+  struct Command {
+    char text[kMaxCommandLen];
+    char reply_key[kReplyKeyLen];
+    AisCommandCallback callback;
+    uint32_t timeout_ms;
+    uint8_t retries_left;
+  };
+
+  bool transmit(const Command& c);
+  void finish(AisCommandStatus status, const Nmea0183Sentence* reply);
+
+  Command queue_[kMaxCommands];
+  int head_ = 0;   // command in flight or next to go
+  int count_ = 0;
+  bool in_flight_ = false;
+  uint32_t sent_ms_ = 0;
+  size_t sent_mark_ = 0;  // tx_tail_ value once the command is on the wire
+
+  char tx_[kTxRingSize];
+  size_t tx_head_ = 0;  // free-running write / read positions
+  size_t tx_tail_ = 0;
+
+  AisCommandStats stats_;
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_AIS_COMMAND_QUEUE_H_
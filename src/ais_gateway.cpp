@@ -8,26 +8,80 @@
 //
 // PGN mapping:
 //   AIS Type  1/2/3  (Class A position)       → PGN 129038
+//   AIS Type  4      (Base station)            → PGN 129793
 //   AIS Type  5      (Class A static/voyage)   → PGN 129794  (2-sentence)
+//   AIS Type  9      (SAR aircraft)            → PGN 129798
 //   AIS Type  18     (Class B CS position)     → PGN 129039
+//   AIS Type  19     (Class B extended)        → PGN 129040
 //   AIS Type  21     (Aid to Navigation)       → PGN 129041
-//   GPRMC / GPGGA    (own-vessel GPS)          → PGN 129026 / 129029
+//   AIS Type  24     (Class B static, A + B)   → PGN 129809 / 129810
+//   AIS Type  27     (Long-range broadcast)    → PGN 129038
+//   --RMC / --GGA    (own-vessel GNSS)         → PGN 129025 + 129026 / 129029
+//   --VTG / --HDT    (course/speed, heading)   → PGN 129026 / 127250
+//   --RMC / --ZDA    (UTC date and time)       → system timebase → PGN 126992
 //
-// Types 4 (base station), 9 (SAR), 14, 24, etc. are logged but not
-// converted — PGN 129793 is not in the bundled NMEA2000 library.
+// Message layouts live in ais_messages.h. PGNs 129040, 129793 and 129798
+// are not in the bundled NMEA2000 library and are encoded in
+// n2k_ais_messages.cpp.
 
 #include <Arduino.h>
 #include <NMEA2000.h>
 #include <N2kMsg.h>
 #include <N2kMessages.h>
 #include <elapsedMillis.h>
+#include <atomic>
 #include "ais_gateway.h"
+#include "ais_class_b_cache.h"
+#include "ais_collision.h"
+#include "ais_command_queue.h"
+#include "ais_messages.h"
+#include "ais_payload.h"
+#include "ais_priority.h"
+#include "ais_reassembly.h"
+#include "ais_signalk.h"
+#include "ais_target_table.h"
+#include "dead_reckoning.h"
+#include "gateway_metrics.h"
+#include "gnss_timebase.h"
+#include "n2k_ais_messages.h"
+#include "n2k_bus.h"
+#include "n2k_fixed_point.h"
+#include "n2k_nav_messages.h"
+#include "nmea0183_dispatch.h"
+#include "nmea0183_sentence.h"
+#include "sentence_ring.h"
+
+using halmet::AisPayload;
+using halmet::Nmea0183Sentence;
+using halmet::NmeaField;
 
 extern tNMEA2000* nmea2000;
 extern bool ais_silent;
 
-int ais_msg_count_a = 0;
-int ais_msg_count_b = 0;
+// ----------------------------------------------------------------
+// N2K OUTPUT
+//
+// Every PGN the gateway produces goes through SendN2k(). Normally that is
+// the shared bus; AISGatewaySetN2kSink() redirects it, e.g. to capture
+// output when replaying a recorded log.
+// ----------------------------------------------------------------
+
+static AISN2kSink s_n2k_sink = nullptr;
+static halmet::GatewayMetrics s_metrics;
+
+// Set while a sentence is being handled, for parse-to-send latency.
+static bool     s_in_parse = false;
+static uint32_t s_parse_start_us = 0;
+
+static bool CanSendN2k() { return s_n2k_sink || nmea2000; }
+
+static bool SendN2k(const tN2kMsg& msg) {
+  bool ok = s_n2k_sink ? s_n2k_sink(msg)
+                       : (nmea2000 && halmet::N2kBusSend(nmea2000, msg));
+  s_metrics.count_send(msg.PGN, ok);
+  if (s_in_parse) s_metrics.record_latency(micros() - s_parse_start_us);
+  return ok;
+}
 
 static elapsedMillis ais_poll_timer = 0;
 
@@ -41,360 +95,1071 @@ static float ais_tx_rev     = 0.0f;
 static float ais_rssi1      = 0.0f;
 static float ais_rssi2      = 0.0f;
 
+static const halmet::AISGatewayConfig* s_config = nullptr;
+static halmet::AisCommandQueue s_commands;
+static halmet::AisTargetTable s_targets;
+static halmet::AisClassBStaticCache s_class_b;
+static halmet::AisPriorityPolicy s_priority;
+static halmet::AisCollisionEngine s_collision;
+static halmet::DeadReckoner s_dead_reckoner;
+static elapsedMillis s_rapid_update_timer = 0;
+static AISGatewayStats s_stats;
+
+// Every lookup goes through here: a slot newly taken or reused for another
+// MMSI drops the collision state its previous occupant left behind.
+static halmet::AisTarget* TouchTarget(uint32_t mmsi, uint32_t now_ms) {
+  bool fresh;
+  halmet::AisTarget* t = s_targets.touch(mmsi, now_ms, &fresh);
+  if (fresh) s_collision.release(s_targets.index_of(t));
+  return t;
+}
+
+// Convert an NMEA [D]DDMM.MMMMM field plus hemisphere to decimal degrees.
+// Returns false for empty or malformed fields.
+static bool nmea_to_deg(const NmeaField& f, const NmeaField& hemi,
+                        double* deg) {
+  int32_t raw;  // DDMM.MMMMM × 10^5
+  if (!halmet::ParseFixed(f, 5, &raw) || raw < 0) return false;
+  int32_t d = raw / 10000000;
+  double v  = d + (raw - d * 10000000) / 6000000.0;
+  *deg = (hemi.ch() == 'S' || hemi.ch() == 'W') ? -v : v;
+  return true;
+}
+
 // ----------------------------------------------------------------
-// 6-BIT VDM PAYLOAD BIT EXTRACTION
-//
-// AIS VDM sentences encode binary data as 6-bit ASCII-armored characters.
-// Each character encodes 6 bits: value = ASCII - 48, then subtract 8 more
-// if the result exceeds 40. Bits are packed MSB-first within each character.
+// FIELD CONVERSIONS
 // ----------------------------------------------------------------
 
-static uint32_t vdm_uint(const char* p, int startBit, int numBits) {
-  uint32_t v = 0;
-  for (int i = startBit; i < startBit + numBits; i++) {
-    int c = (uint8_t)p[i / 6] - 48;
-    if (c > 40) c -= 8;
-    v = (v << 1) | ((c >> (5 - i % 6)) & 1);
-  }
-  return v;
+using halmet::AisDecode;
+using halmet::AisDecodeText;
+using halmet::AisRecord;
+
+// AIS 1/10000-minute coordinates → degrees, with the "not available"
+// sentinels (181° / 91°) mapped to N/A.
+static double ais_lon(int32_t raw) {
+  return (raw == halmet::kAisLon28NA) ? N2kDoubleNA : raw / 600000.0;
+}
+static double ais_lat(int32_t raw) {
+  return (raw == halmet::kAisLat27NA) ? N2kDoubleNA : raw / 600000.0;
 }
 
-static int32_t vdm_int(const char* p, int startBit, int numBits) {
-  uint32_t v = vdm_uint(p, startBit, numBits);
-  if (v & (1u << (numBits - 1)))
-    v |= ~((1u << numBits) - 1u);
-  return (int32_t)v;
+// Same, straight to 1e-7 degree for the integer position-report path.
+static int32_t ais_lon_e7(int32_t raw) {
+  return (raw == halmet::kAisLon28NA) ? N2kInt32NA : halmet::AisCoordToE7(raw);
+}
+static int32_t ais_lat_e7(int32_t raw) {
+  return (raw == halmet::kAisLat27NA) ? N2kInt32NA : halmet::AisCoordToE7(raw);
 }
 
-// Extract a 6-bit ASCII string from the payload. '@' (ASCII 64) is the AIS
-// padding/space character; trailing '@' and spaces are trimmed.
-static void vdm_str(const char* p, int startBit, int nChars,
-                    char* out, int outLen) {
-  int n = (nChars < outLen - 1) ? nChars : outLen - 1;
-  for (int i = 0; i < n; i++) {
-    int c = (int)vdm_uint(p, startBit + i * 6, 6);
-    if (c < 32) c += 64;
-    out[i] = (char)c;
+// AIS EPFD (position fixing device) → N2K GNSS type.
+static tN2kGNSStype ais_gnss_type(uint32_t epfd) {
+  switch (epfd) {
+    case 2: return N2kGNSSt_GLONASS;
+    case 3: return N2kGNSSt_GPSGLONASS;
+    case 5: return N2kGNSSt_Chayka;
+    case 6: return N2kGNSSt_integrated;
+    case 7: return N2kGNSSt_surveyed;
+    case 8: return N2kGNSSt_Galileo;
+    default: return N2kGNSSt_GPS;
   }
-  while (n > 0 && (out[n - 1] == '@' || out[n - 1] == ' ')) n--;
-  out[n] = '\0';
 }
 
-// Convert NMEA DDMM.MMMM format to decimal degrees.
-static double nmea_to_deg(const char* s) {
-  double raw = atof(s);
-  int deg    = (int)(raw / 100);
-  return deg + (raw - deg * 100.0) / 60.0;
+// ----------------------------------------------------------------
+// SIGNAL K TARGETS
+//
+// Every decoded report updates s_sk_targets, whether or not it is
+// forwarded to N2K; AISGatewayFlushSignalK() turns the changes into one
+// delta per target per flush.
+// ----------------------------------------------------------------
+
+#ifdef ENABLE_SIGNALK
+static halmet::AisSignalKTargets s_sk_targets;
+#endif
+
+// Raw AIS units: SOG and COG in tenths (1023 / 3600 = N/A), heading in
+// degrees (511 = N/A).
+static void PublishPosition(uint32_t mmsi, int32_t lat_e7, int32_t lon_e7,
+                            uint32_t sog, uint32_t cog, uint32_t heading,
+                            uint8_t nav_status) {
+#ifdef ENABLE_SIGNALK
+  s_sk_targets.update_position(mmsi, lat_e7, lon_e7,
+                               sog == 1023 ? -1.0f : sog / 10.0f,
+                               cog >= 3600 ? -1.0f : cog / 10.0f,
+                               heading >= 360 ? -1.0f : (float)heading,
+                               nav_status, millis());
+#endif
+}
+
+static void PublishStatic(uint32_t mmsi, const char* name,
+                          const char* callsign, uint8_t ship_type,
+                          uint32_t length_m, uint32_t beam_m) {
+#ifdef ENABLE_SIGNALK
+  s_sk_targets.update_static(mmsi, name, callsign, ship_type,
+                             (uint16_t)length_m, (uint16_t)beam_m, millis());
+#endif
 }
 
 // ----------------------------------------------------------------
 // NMEA 2000 SENDERS
 // ----------------------------------------------------------------
 
-// PGN 129038 — AIS Class A Position Report (Types 1, 2, 3)
+// Position reports are the bulk of AIS traffic, so 129038 / 129039 are
+// built from integer units (n2k_fixed_point.h) with no double math:
+// lat/lon in 1e-7 degree, COG/heading in 1e-4 rad, SOG in 0.01 m/s.
+
+// PGN 129038 — AIS Class A Position Report (Types 1, 2, 3, 27)
 static void SendPGN129038(int msgType, uint32_t mmsi,
-                          double lat, double lon,
-                          float sog_kn, float cog_deg, float hdg_deg,
+                          int32_t lat_e7, int32_t lon_e7,
+                          uint16_t sog, uint16_t cog, uint16_t hdg,
                           uint8_t navStatus) {
-  if (!nmea2000) return;
-  double sog_ms  = (sog_kn  >= 102.3f) ? N2kDoubleNA : (double)sog_kn * 0.514444;
-  double cog_rad = (cog_deg >= 360.0f)  ? N2kDoubleNA : (double)cog_deg * DEG_TO_RAD;
-  double hdg_rad = (hdg_deg >= 360.0f)  ? N2kDoubleNA : (double)hdg_deg * DEG_TO_RAD;
+  if (!CanSendN2k()) return;
   tN2kMsg msg;
-  SetN2kPGN129038(msg, (uint8_t)msgType, N2kaisr_Initial, mmsi,
-                  lat, lon,
-                  false, false, 0xFF,
-                  cog_rad, sog_ms,
-                  N2kaischannel_A_VDL_reception,
-                  hdg_rad,
-                  N2kDoubleNA,
-                  (tN2kAISNavStatus)navStatus);
-  nmea2000->SendMsg(msg);
+  halmet::SetN2kPGN129038(msg, (uint8_t)msgType, N2kaisr_Initial, mmsi,
+                          lat_e7, lon_e7,
+                          false, false, 0xFF,
+                          cog, sog,
+                          N2kaischannel_A_VDL_reception,
+                          hdg,
+                          N2kInt16NA,
+                          (tN2kAISNavStatus)navStatus);
+  SendN2k(msg);
 }
 
 // PGN 129039 — AIS Class B CS Position Report (Type 18)
 static void SendPGN129039(uint32_t mmsi,
-                          double lat, double lon,
-                          float sog_kn, float cog_deg, float hdg_deg) {
-  if (!nmea2000) return;
-  double sog_ms  = (sog_kn  >= 102.3f) ? N2kDoubleNA : (double)sog_kn * 0.514444;
-  double cog_rad = (cog_deg >= 360.0f)  ? N2kDoubleNA : (double)cog_deg * DEG_TO_RAD;
-  double hdg_rad = (hdg_deg >= 360.0f)  ? N2kDoubleNA : (double)hdg_deg * DEG_TO_RAD;
+                          int32_t lat_e7, int32_t lon_e7,
+                          uint16_t sog, uint16_t cog, uint16_t hdg) {
+  if (!CanSendN2k()) return;
   tN2kMsg msg;
-  SetN2kPGN129039(msg, 18, N2kaisr_Initial, mmsi,
-                  lat, lon,
-                  false, false, 0xFF,
-                  cog_rad, sog_ms,
-                  N2kaischannel_A_VDL_reception,
-                  hdg_rad,
-                  N2kaisunit_ClassB_CS,
-                  true, true, true, true,
-                  N2kaismode_Autonomous, true);
-  nmea2000->SendMsg(msg);
+  halmet::SetN2kPGN129039(msg, 18, N2kaisr_Initial, mmsi,
+                          lat_e7, lon_e7,
+                          false, false, 0xFF,
+                          cog, sog,
+                          N2kaischannel_A_VDL_reception,
+                          hdg,
+                          N2kaisunit_ClassB_CS,
+                          true, true, true, true,
+                          N2kaismode_Autonomous, true);
+  SendN2k(msg);
+}
+
+// PGN 129040 — AIS Class B Extended Position Report (Type 19)
+static void SendPGN129040(const AisPayload& p) {
+  if (!CanSendN2k()) return;
+  using L = halmet::AisClassBExtendedLayout;
+  AisRecord<L> r = AisDecode<L>(p);
+  char name[21]; AisDecodeText(p, L::kName, name);
+  float sog = r.scaled<L::kSog>();
+  float cog = r.scaled<L::kCog>();
+  uint32_t hdg = r.get_uint<L::kHeading>();
+  double toBow   = r.get<L::kToBow>();
+  double toStern = r.get<L::kToStern>();
+  double toPort  = r.get<L::kToPort>();
+  double toStbd  = r.get<L::kToStbd>();
+  tN2kMsg msg;
+  halmet::SetN2kPGN129040(
+      msg, 19, N2kaisr_Initial, r.get_uint<L::kMmsi>(),
+      ais_lat(r.get<L::kLat>()), ais_lon(r.get<L::kLon>()),
+      r.get<L::kAccuracy>(), r.get<L::kRaim>(), (uint8_t)r.get<L::kSecond>(),
+      (cog >= 360.0f) ? N2kDoubleNA : cog * DEG_TO_RAD,
+      (sog >= 102.3f) ? N2kDoubleNA : sog * 0.514444,
+      (hdg >= 360) ? N2kDoubleNA : hdg * DEG_TO_RAD,
+      (uint8_t)r.get<L::kShipType>(),
+      toBow + toStern, toPort + toStbd, toStbd, toBow, name,
+      r.get<L::kDte>(), r.get<L::kAssigned>(),
+      ais_gnss_type(r.get_uint<L::kEpfd>()), N2kaischannel_A_VDL_reception);
+  SendN2k(msg);
+}
+
+// PGN 129793 — AIS UTC and Date Report (Type 4, base station)
+static void SendPGN129793(const AisPayload& p) {
+  if (!CanSendN2k()) return;
+  using L = halmet::AisBaseStationLayout;
+  AisRecord<L> r = AisDecode<L>(p);
+  uint32_t y = r.get_uint<L::kYear>(), mo = r.get_uint<L::kMonth>(),
+           d = r.get_uint<L::kDay>(), h = r.get_uint<L::kHour>(),
+           mi = r.get_uint<L::kMinute>(), s = r.get_uint<L::kSecond>();
+  int32_t days = 0;
+  bool date_ok = y >= 1970 && mo >= 1 && mo <= 12 && d >= 1 && d <= 31;
+  if (date_ok) {
+    days = halmet::DaysFromCivil(y, mo, d);
+    date_ok = days < N2kUInt16NA;
+  }
+  bool time_ok = h < 24 && mi < 60 && s < 60;
+  tN2kMsg msg;
+  halmet::SetN2kPGN129793(
+      msg, 4, N2kaisr_Initial, r.get_uint<L::kMmsi>(),
+      ais_lat(r.get<L::kLat>()), ais_lon(r.get<L::kLon>()),
+      r.get<L::kAccuracy>(), r.get<L::kRaim>(),
+      time_ok ? (double)(h * 3600 + mi * 60 + s) : N2kDoubleNA,
+      date_ok ? (uint16_t)days : N2kUInt16NA,
+      ais_gnss_type(r.get_uint<L::kEpfd>()), N2kaischannel_A_VDL_reception);
+  SendN2k(msg);
 }
 
 // PGN 129794 — AIS Class A Static and Voyage Data (Type 5, 2-sentence)
-static void SendPGN129794(const char* payload) {
-  if (!nmea2000) return;
-  uint32_t mmsi    = vdm_uint(payload, 8, 30);
-  uint32_t imo     = vdm_uint(payload, 40, 30);
-  char callsign[8]; vdm_str(payload, 70, 7, callsign, sizeof(callsign));
-  char name[21];    vdm_str(payload, 112, 20, name, sizeof(name));
-  uint8_t shipType = (uint8_t)vdm_uint(payload, 232, 8);
-  double toBow     = (double)vdm_uint(payload, 240, 9);
-  double toStern   = (double)vdm_uint(payload, 249, 9);
-  double toPort    = (double)vdm_uint(payload, 258, 6);
-  double toStbd    = (double)vdm_uint(payload, 264, 6);
+static void SendPGN129794(const AisPayload& p) {
+  if (!CanSendN2k()) return;
+  using L = halmet::AisStaticVoyageLayout;
+  AisRecord<L> r = AisDecode<L>(p);
+  char callsign[8]; AisDecodeText(p, L::kCallsign, callsign);
+  char name[21];    AisDecodeText(p, L::kName, name);
+  double toBow     = r.get<L::kToBow>();
+  double toStern   = r.get<L::kToStern>();
+  double toPort    = r.get<L::kToPort>();
+  double toStbd    = r.get<L::kToStbd>();
   tN2kMsg msg;
   SetN2kPGN129794(msg,
-                  5, N2kaisr_Initial, mmsi, imo,
-                  callsign, name, shipType,
+                  5, N2kaisr_Initial, r.get_uint<L::kMmsi>(),
+                  r.get_uint<L::kImo>(),
+                  callsign, name, (uint8_t)r.get<L::kShipType>(),
                   toBow + toStern, toPort + toStbd,
                   toStbd, toBow,
                   0, 0.0, 0.0, "",
-                  N2kaisv_ITU_R_M_1371_1, N2kGNSSt_GPS, N2kaisdte_Ready,
+                  N2kaisv_ITU_R_M_1371_1,
+                  ais_gnss_type(r.get_uint<L::kEpfd>()), N2kaisdte_Ready,
                   N2kaischannel_A_VDL_reception);
-  nmea2000->SendMsg(msg);
+  SendN2k(msg);
+}
+
+// PGN 129798 — AIS SAR Aircraft Position Report (Type 9)
+static void SendPGN129798(const AisPayload& p) {
+  if (!CanSendN2k()) return;
+  using L = halmet::AisSarAircraftLayout;
+  AisRecord<L> r = AisDecode<L>(p);
+  uint32_t alt = r.get_uint<L::kAltitude>();
+  uint32_t sog = r.get_uint<L::kSog>();
+  float cog = r.scaled<L::kCog>();
+  tN2kMsg msg;
+  halmet::SetN2kPGN129798(
+      msg, 9, N2kaisr_Initial, r.get_uint<L::kMmsi>(),
+      ais_lat(r.get<L::kLat>()), ais_lon(r.get<L::kLon>()),
+      r.get<L::kAccuracy>(), r.get<L::kRaim>(), (uint8_t)r.get<L::kSecond>(),
+      (cog >= 360.0f) ? N2kDoubleNA : cog * DEG_TO_RAD,
+      (sog >= 1023) ? N2kDoubleNA : sog * 0.514444,
+      (alt >= 4095) ? N2kDoubleNA : (double)alt,
+      r.get<L::kDte>(), N2kaischannel_A_VDL_reception);
+  SendN2k(msg);
+}
+
+// Type 5 is broadcast every 6 minutes per vessel and each 129794 is a
+// multi-frame fast packet, so only forward static data that changed or
+// hasn't been sent for static_refresh_s. The hash covers bits 40..269
+// (IMO, callsign, name, ship type, dimensions) — everything 129794 carries.
+static void ForwardStaticData(const AisPayload& p, halmet::AisTarget* t) {
+  uint32_t now = millis();
+  if (!t) return;
+
+  uint32_t hash = 2166136261u;  // FNV-1a over 30-bit chunks
+  for (int bit = 40; bit < 270; bit += 30) {
+    int n = (270 - bit < 30) ? 270 - bit : 30;
+    hash = (hash ^ p.get_uint(bit, n)) * 16777619u;
+  }
+
+  uint32_t refresh_ms = (s_config ? s_config->static_refresh_s : 300) * 1000;
+  if (t->static_sent_ms != 0 && hash == t->static_hash &&
+      now - t->static_sent_ms < refresh_ms) {
+    s_stats.static_suppressed++;
+    return;
+  }
+  SendPGN129794(p);
+  {
+    using L = halmet::AisStaticVoyageLayout;
+    AisRecord<L> r = AisDecode<L>(p);
+    char callsign[8]; AisDecodeText(p, L::kCallsign, callsign);
+    char name[21];    AisDecodeText(p, L::kName, name);
+    PublishStatic(t->mmsi, name, callsign, (uint8_t)r.get<L::kShipType>(),
+                  r.get_uint<L::kToBow>() + r.get_uint<L::kToStern>(),
+                  r.get_uint<L::kToPort>() + r.get_uint<L::kToStbd>());
+  }
+  t->static_hash = hash;
+  t->static_sent_ms = now ? now : 1;
+  s_stats.static_forwarded++;
+}
+
+// PGN 129809 / 129810 — AIS Class B Static Data parts A and B (Type 24)
+static void SendPGN129809_129810(const halmet::AisClassBStatic& c) {
+  if (!CanSendN2k()) return;
+  char name[21], vendor[8], callsign[8];
+  memcpy(name, c.name, sizeof(name));
+  memcpy(vendor, c.vendor, sizeof(vendor));
+  memcpy(callsign, c.callsign, sizeof(callsign));
+  tN2kMsg msgA;
+  SetN2kPGN129809(msgA, 24, N2kaisr_Initial, c.mmsi, name);
+  SendN2k(msgA);
+  tN2kMsg msgB;
+  SetN2kPGN129810(msgB, 24, N2kaisr_Initial, c.mmsi,
+                  c.ship_type, vendor, callsign,
+                  (double)(c.to_bow + c.to_stern),
+                  (double)(c.to_port + c.to_stbd),
+                  (double)c.to_stbd, (double)c.to_bow,
+                  c.mothership_mmsi);
+  SendN2k(msgB);
+}
+
+// Type 24 arrives as two independent messages: part A carries the name,
+// part B the ship type, vendor, callsign and dimensions. Halves are cached
+// per MMSI and both PGNs go out once the pair is complete, then again only
+// when either half changes or static_refresh_s has passed.
+static void HandleType24(const AisPayload& p, halmet::AisTarget* t) {
+  using L = halmet::AisClassBStaticLayout;
+  AisRecord<L> r = AisDecode<L>(p);
+  uint32_t now  = millis();
+  uint32_t mmsi = r.get_uint<L::kMmsi>();
+  halmet::AisClassBStatic* c = s_class_b.get(mmsi, now);
+  if (!c) return;
+
+  if (r.get<L::kPartNumber>() == 0) {
+    AisDecodeText(p, L::kName, c->name);
+    c->has_part_a = true;
+  } else {
+    c->ship_type = (uint8_t)r.get<L::kShipType>();
+    AisDecodeText(p, L::kVendor, c->vendor);
+    AisDecodeText(p, L::kCallsign, c->callsign);
+    if (mmsi / 10000000 == 98) {  // auxiliary craft: dimensions → mothership
+      c->mothership_mmsi = r.get_uint<L::kMothershipMmsi>();
+      c->to_bow = c->to_stern = c->to_port = c->to_stbd = 0;
+    } else {
+      c->mothership_mmsi = 0;
+      c->to_bow   = (uint16_t)r.get<L::kToBow>();
+      c->to_stern = (uint16_t)r.get<L::kToStern>();
+      c->to_port  = (uint8_t)r.get<L::kToPort>();
+      c->to_stbd  = (uint8_t)r.get<L::kToStbd>();
+    }
+    c->has_part_b = true;
+  }
+  if (!c->complete() || !t) return;
+
+  uint32_t hash = 2166136261u;  // FNV-1a over everything the PGNs carry
+  auto mix = [&hash](const void* data, size_t len) {
+    const uint8_t* b = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) hash = (hash ^ b[i]) * 16777619u;
+  };
+  mix(c->name, strlen(c->name));
+  mix(&c->ship_type, 1);
+  mix(c->vendor, strlen(c->vendor));
+  mix(c->callsign, strlen(c->callsign));
+  mix(&c->to_bow, 2);
+  mix(&c->to_stern, 2);
+  mix(&c->to_port, 1);
+  mix(&c->to_stbd, 1);
+  mix(&c->mothership_mmsi, 4);
+
+  uint32_t refresh_ms = (s_config ? s_config->static_refresh_s : 300) * 1000;
+  if (t->class_b_sent_ms != 0 && hash == t->class_b_hash &&
+      now - t->class_b_sent_ms < refresh_ms) {
+    s_stats.static_suppressed++;
+    return;
+  }
+  SendPGN129809_129810(*c);
+  PublishStatic(mmsi, c->name, c->callsign, c->ship_type,
+                c->to_bow + c->to_stern, c->to_port + c->to_stbd);
+  t->class_b_hash = hash;
+  t->class_b_sent_ms = now ? now : 1;
+  s_stats.static_forwarded++;
 }
 
 // PGN 129041 — AIS Aid-to-Navigation Report (Type 21)
-static void SendPGN129041(const char* payload) {
-  if (!nmea2000) return;
+static void SendPGN129041(const AisPayload& p) {
+  if (!CanSendN2k()) return;
+  using L = halmet::AisAtoNLayout;
+  AisRecord<L> r = AisDecode<L>(p);
   tN2kAISAtoNReportData d;
   d.MessageID = 21;
   d.Repeat    = N2kaisr_Initial;
-  d.UserID    = vdm_uint(payload, 8, 30);
-  d.AtoNType  = (tN2kAISAtoNType)vdm_uint(payload, 38, 5);
-  char name[21]; vdm_str(payload, 43, 20, name, sizeof(name));
+  d.UserID    = r.get_uint<L::kMmsi>();
+  d.AtoNType  = (tN2kAISAtoNType)r.get<L::kAtoNType>();
+  char name[21]; AisDecodeText(p, L::kName, name);
   d.SetAtoNName(name);
-  d.Accuracy         = (bool)vdm_uint(payload, 163, 1);
-  int32_t lon_raw    = vdm_int(payload, 164, 28);
-  int32_t lat_raw    = vdm_int(payload, 192, 27);
-  d.Longitude        = (lon_raw == 0x6791AC0) ? N2kDoubleNA : lon_raw / 600000.0;
-  d.Latitude         = (lat_raw == 0x3412140) ? N2kDoubleNA : lat_raw / 600000.0;
-  double toBow       = (double)vdm_uint(payload, 219, 9);
-  double toStern     = (double)vdm_uint(payload, 228, 9);
-  double toPort      = (double)vdm_uint(payload, 237, 6);
-  double toStbd      = (double)vdm_uint(payload, 243, 6);
+  d.Accuracy         = r.get<L::kAccuracy>();
+  d.Longitude        = ais_lon(r.get<L::kLon>());
+  d.Latitude         = ais_lat(r.get<L::kLat>());
+  double toBow       = r.get<L::kToBow>();
+  double toStern     = r.get<L::kToStern>();
+  double toPort      = r.get<L::kToPort>();
+  double toStbd      = r.get<L::kToStbd>();
   d.Length                    = toBow + toStern;
   d.Beam                      = toPort + toStbd;
   d.PositionReferenceTrueNorth = toBow;
   d.PositionReferenceStarboard = toStbd;
-  d.GNSSType                  = (tN2kGNSStype)vdm_uint(payload, 249, 4);
-  d.Seconds                   = (uint8_t)vdm_uint(payload, 253, 6);
-  d.OffPositionIndicator       = (bool)vdm_uint(payload, 259, 1);
-  d.RAIM                      = (bool)vdm_uint(payload, 268, 1);
-  d.VirtualAtoNFlag            = (bool)vdm_uint(payload, 269, 1);
-  d.AssignedModeFlag           = (bool)vdm_uint(payload, 270, 1);
+  d.GNSSType                  = ais_gnss_type(r.get_uint<L::kEpfd>());
+  d.Seconds                   = (uint8_t)r.get<L::kSecond>();
+  d.OffPositionIndicator       = r.get<L::kOffPosition>();
+  d.RAIM                      = r.get<L::kRaim>();
+  d.VirtualAtoNFlag            = r.get<L::kVirtual>();
+  d.AssignedModeFlag           = r.get<L::kAssigned>();
   d.AISTransceiverInformation  = N2kaischannel_A_VDL_reception;
   d.AtoNStatus                = 0;
   tN2kMsg msg;
   SetN2kPGN129041(msg, d);
-  nmea2000->SendMsg(msg);
+  SendN2k(msg);
+}
+
+// ----------------------------------------------------------------
+// MESSAGE DISPATCH
+// ----------------------------------------------------------------
+
+// Every position report updates the collision engine, then passes through
+// the proximity policy so that, when the bus is busy, distant and
+// stationary targets give way to close ones. lat/lon of N2kInt32NA rank as
+// near (never throttled). Returns whether to forward the report.
+static bool TrackPosition(halmet::AisTarget* t, int32_t lat_e7, int32_t lon_e7,
+                          float sog_kn, float cog_deg) {
+  uint32_t now = millis();
+  if (t) {
+    s_collision.update_target(s_targets.index_of(t), t->mmsi, lat_e7, lon_e7,
+                              sog_kn, cog_deg, now);
+  }
+  return s_priority.admit(t, lat_e7, lon_e7, sog_kn, cog_deg, now);
+}
+
+// Types that describe a vessel and so hold a slot in the target table.
+// Base stations, SAR aircraft, AtoNs and binary or safety messages don't
+// take one, so a busy shore station can't evict the ships around it.
+static bool IsVesselReport(int msgType) {
+  switch (msgType) {
+    case 1: case 2: case 3: case 5: case 18: case 19: case 24: case 27:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static void DecodeAIS(const AisPayload& p, char channel) {
+  int msgType = (int)p.get_uint(0, 6);
+  s_metrics.count_ais(msgType, channel);
+  halmet::AisTarget* t = IsVesselReport(msgType)
+                             ? TouchTarget(p.get_uint(8, 30), millis())
+                             : nullptr;
+
+  switch (msgType) {
+    case 1: case 2: case 3: {  // Class A position
+      using L = halmet::AisClassAPositionLayout;
+      AisRecord<L> r = AisDecode<L>(p);
+      int32_t lat = ais_lat_e7(r.get<L::kLat>());
+      int32_t lon = ais_lon_e7(r.get<L::kLon>());
+      PublishPosition(r.get_uint<L::kMmsi>(), lat, lon, r.get_uint<L::kSog>(),
+                      r.get_uint<L::kCog>(), r.get_uint<L::kHeading>(),
+                      (uint8_t)r.get<L::kNavStatus>());
+      if (!TrackPosition(t, lat, lon, r.scaled<L::kSog>(), r.scaled<L::kCog>())) {
+        break;
+      }
+      SendPGN129038(msgType, r.get_uint<L::kMmsi>(), lat, lon,
+                    halmet::AisSogToN2k(r.get_uint<L::kSog>()),
+                    halmet::AisCogToN2k(r.get_uint<L::kCog>()),
+                    halmet::DegreesToN2k(r.get_uint<L::kHeading>()),
+                    (uint8_t)r.get<L::kNavStatus>());
+      break;
+    }
+    case 4:  // Base station
+      SendPGN129793(p);
+      break;
+    case 5:  // Class A static and voyage data
+      ForwardStaticData(p, t);
+      break;
+    case 9:  // SAR aircraft
+      SendPGN129798(p);
+      break;
+    case 18: {  // Class B CS position
+      using L = halmet::AisClassBPositionLayout;
+      AisRecord<L> r = AisDecode<L>(p);
+      int32_t lat = ais_lat_e7(r.get<L::kLat>());
+      int32_t lon = ais_lon_e7(r.get<L::kLon>());
+      PublishPosition(r.get_uint<L::kMmsi>(), lat, lon, r.get_uint<L::kSog>(),
+                      r.get_uint<L::kCog>(), r.get_uint<L::kHeading>(), 15);
+      if (!TrackPosition(t, lat, lon, r.scaled<L::kSog>(), r.scaled<L::kCog>())) {
+        break;
+      }
+      SendPGN129039(r.get_uint<L::kMmsi>(), lat, lon,
+                    halmet::AisSogToN2k(r.get_uint<L::kSog>()),
+                    halmet::AisCogToN2k(r.get_uint<L::kCog>()),
+                    halmet::DegreesToN2k(r.get_uint<L::kHeading>()));
+      break;
+    }
+    case 19: {  // Class B extended position
+      using L = halmet::AisClassBExtendedLayout;
+      AisRecord<L> r = AisDecode<L>(p);
+      int32_t lat = ais_lat_e7(r.get<L::kLat>());
+      int32_t lon = ais_lon_e7(r.get<L::kLon>());
+      PublishPosition(r.get_uint<L::kMmsi>(), lat, lon, r.get_uint<L::kSog>(),
+                      r.get_uint<L::kCog>(), r.get_uint<L::kHeading>(), 15);
+      if (TrackPosition(t, lat, lon, r.scaled<L::kSog>(), r.scaled<L::kCog>())) {
+        SendPGN129040(p);
+      }
+      break;
+    }
+    case 21:  // Aid to Navigation
+      SendPGN129041(p);
+      break;
+    case 24:  // Class B static data, part A or B
+      HandleType24(p, t);
+      break;
+    case 27: {  // Long-range broadcast: 1/10 min position, whole knots/degrees
+      using L = halmet::AisLongRangeLayout;
+      AisRecord<L> r = AisDecode<L>(p);
+      int32_t lon = r.get<L::kLon>(), lat = r.get<L::kLat>();
+      uint32_t sog = r.get_uint<L::kSog>(), cog = r.get_uint<L::kCog>();
+      int32_t lat_e7 = (lat == 91 * 600) ? N2kInt32NA
+                                         : halmet::AisLongRangeCoordToE7(lat);
+      int32_t lon_e7 = (lon == 181 * 600) ? N2kInt32NA
+                                          : halmet::AisLongRangeCoordToE7(lon);
+      PublishPosition(r.get_uint<L::kMmsi>(), lat_e7, lon_e7,
+                      (sog == 63) ? 1023 : sog * 10,
+                      (cog == 511) ? 3600 : cog * 10, 511,
+                      (uint8_t)r.get<L::kNavStatus>());
+      if (!TrackPosition(t, lat_e7, lon_e7, (sog == 63) ? -1.0f : (float)sog,
+                         (float)cog)) {
+        break;
+      }
+      SendPGN129038(27, r.get_uint<L::kMmsi>(), lat_e7, lon_e7,
+                    (sog == 63) ? N2kUInt16NA : halmet::KnotsToN2k(sog),
+                    halmet::DegreesToN2k(cog), N2kUInt16NA,
+                    (uint8_t)r.get<L::kNavStatus>());
+      break;
+    }
+    default:
+      // Types 6/8 (binary), 14 (safety text), etc. — not converted.
+      break;
+  }
 }
 
 // ----------------------------------------------------------------
 // MULTI-SENTENCE ASSEMBLY
 //
-// AIS Type 5 (Class A static) spans 2 VDM sentences; we buffer the first
-// and combine with the second before parsing. Buffer sized for 71 payload
-// chars + NUL.
+// Type 5 (Class A static) and other long messages span several VDM
+// sentences. Fragments are reassembled per (sequence ID, channel, total)
+// so interleaved messages on channels A and B don't corrupt each other.
 // ----------------------------------------------------------------
 
-static char  s_type5[80] = {0};
-static bool  s_type5_got = false;
+static halmet::AisReassembler s_reassembler;
 
 // ----------------------------------------------------------------
-// SENTENCE PARSER
+// INPUT PORTS
+//
+// Each NMEA 0183 input (Serial2 for the transponder, optionally Serial1
+// for a sounder or dedicated GNSS) is drained in its onReceive callback,
+// which runs in the HardwareSerial UART event task (pinned to core 0 by
+// the ARDUINO_SERIAL_EVENT_TASK_RUNNING_CORE build flag). Complete
+// sentences go into that port's own SPSC ring; the main loop pops
+// finished lines from all ports into the one parser, so a slow
+// event-loop tick no longer backs bytes up into the UART FIFO.
 // ----------------------------------------------------------------
 
-static void ParseNMEA(const char* line) {
-  if (!line || !line[0]) return;
+struct InputPort {
+  HardwareSerial* serial = nullptr;
+  const char* name = "";
+  uint8_t priority = 0;  // lower wins for own-ship data
 
-  // VDM / VDO — standard AIS armored sentences
-  if (strncmp(line, "!AIVDM", 6) == 0 || strncmp(line, "!AIVDO", 6) == 0) {
-    // Sentence format: !AIVDx,<total>,<sentNum>,<seqId>,<channel>,<payload>,<fill>*<cksum>
-
-    // Field 1: total sentence count for this message
-    const char* f = strchr(line, ',');
-    if (!f) return;
-    int total   = atoi(f + 1);
-
-    // Field 2: sentence number within this message
-    f = strchr(f + 1, ',');
-    if (!f) return;
-    int sentNum = atoi(f + 1);
-
-    // Advance to field 5 (the payload)
-    const char* fp = line;
-    for (int i = 0; i < 5; i++) {
-      fp = strchr(fp, ',');
-      if (!fp) return;
-      fp++;
-    }
-    const char* payloadEnd = strchr(fp, ',');
-    if (!payloadEnd) return;
-    int plen = (int)(payloadEnd - fp);
-    if (plen < 1 || plen > 56) return;
-
-    // Decode message type from the first payload character
-    int cv = (uint8_t)fp[0] - 48;
-    if (cv > 40) cv -= 8;
-    int msgType = cv;
-
-    // Multi-sentence messages (Type 5 is always 2 sentences)
-    if (total == 2) {
-      if (sentNum == 1) {
-        memcpy(s_type5, fp, plen);
-        s_type5[plen] = '\0';
-        s_type5_got   = true;
-      } else if (sentNum == 2 && s_type5_got) {
-        int firstLen = (int)strlen(s_type5);
-        if (firstLen + plen < (int)sizeof(s_type5) - 1) {
-          memcpy(s_type5 + firstLen, fp, plen);
-          s_type5[firstLen + plen] = '\0';
+  halmet::SentenceRing<32, 96> ring;  // VDM lines are ≤ 82 chars
+
+  // Producer-side state, touched only from the UART event task.
+  char line[96];
+  int pos = 0;
+  std::atomic<uint32_t> long_lines{0};
+  std::atomic<uint32_t> uart_errors{0};
+  std::atomic<uint32_t> ingest_max_us{0};
+
+  // Consumer side
+  uint32_t sentences = 0;
+  uint32_t superseded = 0;
+};
+
+static InputPort s_ports[kAISMaxPorts];
+static int s_num_ports = 0;
+static int s_current_port = 0;  // port of the sentence being parsed
+
+static void OnPortReceive(InputPort& port) {
+  uint32_t start_us = micros();
+  HardwareSerial& serial = *port.serial;
+  int n;
+  while ((n = serial.available()) > 0) {
+    while (n-- > 0) {
+      char c = (char)serial.read();
+      if (c == '\r' || c == '\n') {
+        if (port.pos > 0 && port.pos < (int)sizeof(port.line)) {
+          port.ring.push(port.line, port.pos);
         }
-        s_type5_got = false;
-        if (msgType == 5) {
-          ais_msg_count_a++;
-          SendPGN129794(s_type5);
+        port.pos = 0;
+      } else if (port.pos < (int)sizeof(port.line) - 1) {
+        port.line[port.pos++] = c;
+      } else {
+        // Overlong line: drop it, resync on the next terminator.
+        if (port.pos != (int)sizeof(port.line)) {
+          port.long_lines.fetch_add(1, std::memory_order_relaxed);
         }
+        port.pos = sizeof(port.line);
       }
-      return;
-    }
-    s_type5_got = false;
-
-    // Single-sentence: copy payload into a local null-terminated buffer
-    char payload[57];
-    memcpy(payload, fp, plen);
-    payload[plen] = '\0';
-
-    uint32_t mmsi = vdm_uint(payload, 8, 30);
-
-    switch (msgType) {
-      case 1: case 2: case 3: {  // Class A position
-        ais_msg_count_a++;
-        float    sog   = (float)vdm_uint(payload, 50, 10) / 10.0f;
-        int32_t  lon_r = vdm_int(payload, 61, 28);
-        int32_t  lat_r = vdm_int(payload, 89, 27);
-        float    cog   = (float)vdm_uint(payload, 116, 12) / 10.0f;
-        uint32_t hdg_r = vdm_uint(payload, 128, 9);
-        float    hdg   = (hdg_r == 511) ? 511.0f : (float)hdg_r;
-        uint8_t  nav   = (uint8_t)vdm_uint(payload, 38, 4);
-        SendPGN129038(msgType, mmsi,
-                      lat_r / 600000.0, lon_r / 600000.0,
-                      sog, cog, hdg, nav);
-        break;
-      }
-      case 18: {  // Class B CS position
-        ais_msg_count_b++;
-        float   sog   = (float)vdm_uint(payload, 46, 10) / 10.0f;
-        int32_t lon_r = vdm_int(payload, 57, 28);
-        int32_t lat_r = vdm_int(payload, 85, 27);
-        float   cog   = (float)vdm_uint(payload, 112, 12) / 10.0f;
-        uint32_t hdg_r = vdm_uint(payload, 124, 9);
-        float   hdg   = (hdg_r == 511) ? 511.0f : (float)hdg_r;
-        SendPGN129039(mmsi,
-                      lat_r / 600000.0, lon_r / 600000.0,
-                      sog, cog, hdg);
-        break;
-      }
-      case 21:  // Aid to Navigation
-        SendPGN129041(payload);
-        break;
-      default:
-        // Types 4 (base station), 9, 14, 24, etc. — not converted.
-        // PGN 129793 (base station) is absent from the bundled N2K library.
-        (void)mmsi;
-        break;
     }
+  }
+  uint32_t took_us = micros() - start_us;
+  if (took_us > port.ingest_max_us.load(std::memory_order_relaxed)) {
+    port.ingest_max_us.store(took_us, std::memory_order_relaxed);
+  }
+}
+
+int AISGatewayAddPort(HardwareSerial& serial, const char* name,
+                      uint8_t priority) {
+  if (s_num_ports == kAISMaxPorts) return -1;
+  InputPort& port = s_ports[s_num_ports];
+  port.serial = &serial;
+  port.name = name;
+  port.priority = priority;
+  // FIFO / RX buffer overflow, framing, parity, break
+  serial.onReceiveError([&port](hardwareSerial_error_t) {
+    port.uart_errors.fetch_add(1, std::memory_order_relaxed);
+  });
+  // Fire on every RX FIFO-full event as well as on the idle timeout.
+  serial.onReceive([&port]() { OnPortReceive(port); }, false);
+  return s_num_ports++;
+}
+
+// Own-ship data (fix, course, heading, time) may arrive on several ports.
+// A sentence kind is taken from one port at a time: another port's copy is
+// ignored while the current one keeps sending it, unless that port has a
+// strictly better priority. Handlers claim only once a sentence has passed
+// its validity checks, so a port without a fix can't hold the claim.
+static constexpr uint32_t kSourceHoldMs = 5000;
+
+struct SourceClaim {
+  int port = -1;
+  uint32_t ms = 0;
+};
+static SourceClaim s_source_claims[halmet::GatewayMetrics::kSentenceKinds];
+
+static bool FromPreferredSource(halmet::GatewayMetrics::Sentence kind) {
+  SourceClaim& claim = s_source_claims[kind];
+  uint32_t now = millis();
+  if (claim.port >= 0 && claim.port != s_current_port &&
+      now - claim.ms < kSourceHoldMs &&
+      s_ports[claim.port].priority <= s_ports[s_current_port].priority) {
+    s_ports[s_current_port].superseded++;
+    return false;
+  }
+  claim.port = s_current_port;
+  claim.ms = now;
+  return true;
+}
+
+// ----------------------------------------------------------------
+// SENTENCE PARSER
+// ----------------------------------------------------------------
+
+// Raw-sentence subscriber (AISGatewaySetLineTap), e.g. the TCP server.
+static AISLineTap s_line_tap = nullptr;
+
+static void ParseSentence(const char* line);
+
+static void ParseNMEA(const char* line) {
+  if (!line || !line[0]) return;
+  s_parse_start_us = micros();
+  s_in_parse = true;
+  ParseSentence(line);
+  s_in_parse = false;
+}
+
+// GNSS system from the talker ID of a GGA sentence.
+static tN2kGNSStype GnssTypeFromTalker(const NmeaField& addr) {
+  char a = addr.p[0], b = addr.p[1];
+  if (a == 'G' && b == 'L') return N2kGNSSt_GLONASS;
+  if (a == 'G' && b == 'A') return N2kGNSSt_Galileo;
+  if (a == 'G' && b == 'N') return N2kGNSSt_GPSGLONASS;
+  return N2kGNSSt_GPS;
+}
+
+// NMEA time of day (hhmmss[.ss]) and date → UTC microseconds since 1970.
+static bool ParseUtc(const NmeaField& hms, uint32_t day, uint32_t month,
+                     uint32_t year, int64_t* utc_us) {
+  int32_t hms_c;                 // hhmmss × 100
+  if (!halmet::ParseFixed(hms, 2, &hms_c) || hms_c < 0) return false;
+  if (day < 1 || day > 31 || month < 1 || month > 12 || year < 1970) {
+    return false;
+  }
+  int32_t hh = hms_c / 1000000, mm = hms_c / 10000 % 100;
+  int32_t ss_c = hms_c % 10000;
+  if (hh > 23 || mm > 59 || ss_c >= 6100) return false;
+  int64_t days = halmet::DaysFromCivil(year, month, day);
+  *utc_us = ((days * 86400 + hh * 3600 + mm * 60) * 100 + ss_c) * 10000;
+  return true;
+}
+
+// When RMC last supplied COG/SOG; VTG only fills in without it.
+static uint32_t s_rmc_motion_ms = 0;
+
+// VDM / VDO — standard AIS armored sentences
+static void HandleVdm(const Nmea0183Sentence& s) {
+  s_metrics.count_sentence(s.address().p[s.address().len - 1] == 'O'
+                               ? halmet::GatewayMetrics::kVdo
+                               : halmet::GatewayMetrics::kVdm);
+  // Sentence format: !AIVDx,<total>,<sentNum>,<seqId>,<channel>,<payload>,<fill>*<cksum>
+  uint32_t total, sentNum;
+  if (!halmet::ParseUnsigned(s.field(1), &total) ||
+      !halmet::ParseUnsigned(s.field(2), &sentNum)) {
     return;
   }
+  // Sequential message ID is empty for single-sentence messages; the
+  // channel is A/B, sometimes 1/2 or empty.
+  char seqId   = s.field(3).ch();
+  char channel = s.field(4).ch();
+  const NmeaField& payload = s.field(5);
+  if (payload.len < 1 || payload.len > 62) return;
 
-  // GPRMC — most common GPS sentence from this AIS hardware.
-  // Sends PGN 129026 (COG/SOG Rapid Update).
-  if (strncmp(line, "$GPRMC", 6) == 0) {
-    const char* p = strchr(line, ',');
-    if (!p) return;
-    p = strchr(p + 1, ',');    // skip time field
-    if (!p) return;
-    if (*(p + 1) != 'A') return;  // V = invalid
-    p = strchr(p + 1, ',') + 1;   // lat
-    double lat = nmea_to_deg(p);
-    p = strchr(p, ',') + 1;       // N/S
-    if (*p == 'S') lat = -lat;
-    p = strchr(p, ',') + 1;       // lon
-    double lon = nmea_to_deg(p);
-    p = strchr(p, ',') + 1;       // E/W
-    if (*p == 'W') lon = -lon;
-    p = strchr(p, ',') + 1;       // SOG in knots
-    double sog_ms = atof(p) * 0.514444;
-    p = strchr(p, ',') + 1;       // COG in degrees true
-    double cog_rad = atof(p) * DEG_TO_RAD;
-    (void)lat; (void)lon;          // position available but 129026 doesn't carry it
-    if (nmea2000) {
-      tN2kMsg msg;
-      SetN2kPGN129026(msg, 0xFF, N2khr_true, cog_rad, sog_ms);
-      nmea2000->SendMsg(msg);
-    }
+  if (total > 1) {
+    const AisPayload* m = s_reassembler.add(seqId, channel, (int)total,
+                                            (int)sentNum, payload.p,
+                                            payload.len, millis());
+    if (m) DecodeAIS(*m, channel);
     return;
   }
 
-  // GPGGA — full position fix with altitude and quality.
-  // Sends PGN 129029 (GNSS Position Data).
-  if (strncmp(line, "$GPGGA", 6) == 0) {
-    const char* p = line;
-    for (int i = 0; i < 2; ++i) { p = strchr(p, ','); if (!p) return; p++; }
-    double lat = nmea_to_deg(p);  p = strchr(p, ',') + 1;
-    if (*p == 'S') lat = -lat;    p = strchr(p, ',') + 1;
-    double lon = nmea_to_deg(p);  p = strchr(p, ',') + 1;
-    if (*p == 'W') lon = -lon;    p = strchr(p, ',') + 1;
-    uint8_t qual = (uint8_t)atoi(p);
-    if (!qual) return;            p = strchr(p, ',') + 1;
-    uint8_t sats = (uint8_t)atoi(p); p = strchr(p, ',') + 1;
-    double hdop = atof(p);        p = strchr(p, ',') + 1;
-    double alt  = atof(p);
-    if (nmea2000) {
-      tN2kMsg msg;
-      SetN2kPGN129029(msg, 0, 0, 0, lat, lon, alt,
-                      N2kGNSSt_GPS, N2kGNSSm_GNSSfix, sats, hdop);
-      nmea2000->SendMsg(msg);
+  // Single-sentence: dearmor once, then pull fields from the bit buffer
+  AisPayload p;
+  if (p.load(payload.p, payload.len)) DecodeAIS(p, channel);
+}
+
+// RMC — most common GPS sentence from this AIS hardware.
+// Sends PGN 129026 (COG/SOG Rapid Update).
+// $--RMC,<time>,<A|V>,<lat>,<N|S>,<lon>,<E|W>,<sog kn>,<cog °T>,<date>,...
+static void HandleRmc(const Nmea0183Sentence& s) {
+  s_metrics.count_sentence(halmet::GatewayMetrics::kRmc);
+  if (s.field(2).ch() != 'A') return;  // V = invalid
+  int32_t lat, lon;              // 1e-7 degree
+  if (!halmet::ParseLatLonE7(s.field(3), s.field(4), &lat) ||
+      !halmet::ParseLatLonE7(s.field(5), s.field(6), &lon)) {
+    return;
+  }
+  if (!FromPreferredSource(halmet::GatewayMetrics::kRmc)) return;
+  uint32_t ddmmyy;
+  int64_t utc_us;
+  if (halmet::ParseUnsigned(s.field(9), &ddmmyy) &&
+      ParseUtc(s.field(1), ddmmyy / 10000, ddmmyy / 100 % 100,
+               2000 + ddmmyy % 100, &utc_us)) {
+    halmet::SystemTimebase().discipline(utc_us, halmet::MonotonicMicros());
+  }
+  int32_t sog_c, cog_c;          // hundredths of a knot / degree
+  bool has_sog = halmet::ParseFixed(s.field(7), 2, &sog_c);
+  bool has_cog = halmet::ParseFixed(s.field(8), 2, &cog_c);
+  // 129026 doesn't carry the position; it ranks AIS targets instead.
+  s_priority.set_own_position(lat, lon, millis());
+  s_priority.set_own_motion(has_sog ? sog_c / 100.0f : -1.0f,
+                            has_cog ? cog_c / 100.0f : -1.0f);
+  s_collision.update_own(lat, lon, has_sog ? sog_c / 100.0f : -1.0f,
+                         has_cog ? cog_c / 100.0f : -1.0f, millis());
+  if (has_sog || has_cog) s_rmc_motion_ms = millis();
+  s_dead_reckoner.on_fix(lat, lon, has_sog ? sog_c / 100.0f : -1.0f,
+                         has_cog ? cog_c / 100.0f : -1.0f, millis());
+  s_rapid_update_timer = 0;  // predictions resume from this fix
+  if (CanSendN2k()) {
+    tN2kMsg pos_msg;
+    halmet::SetN2kPGN129025(pos_msg, lat, lon);
+    SendN2k(pos_msg);
+    tN2kMsg msg;
+    halmet::SetN2kPGN129026(
+        msg, 0xFF, N2khr_true,
+        has_cog ? halmet::DegreesHundredthsToN2k(cog_c) : N2kUInt16NA,
+        has_sog ? halmet::KnotsHundredthsToN2k(sog_c) : N2kUInt16NA);
+    SendN2k(msg);
+  }
+}
+
+// GGA — full position fix with altitude and quality.
+// Sends PGN 129029 (GNSS Position Data).
+// $--GGA,<time>,<lat>,<N|S>,<lon>,<E|W>,<quality>,<sats>,<hdop>,<alt>,M,...
+static void HandleGga(const Nmea0183Sentence& s) {
+  s_metrics.count_sentence(halmet::GatewayMetrics::kGga);
+  double lat, lon;
+  if (!nmea_to_deg(s.field(2), s.field(3), &lat) ||
+      !nmea_to_deg(s.field(4), s.field(5), &lon)) {
+    return;
+  }
+  uint32_t qual, sats;
+  if (!halmet::ParseUnsigned(s.field(6), &qual) || !qual) return;
+  if (!FromPreferredSource(halmet::GatewayMetrics::kGga)) return;
+  // 129029 carries 1e-16 degree, so it keeps the double path; the
+  // priority policy takes the integer fix.
+  int32_t lat_e7, lon_e7;
+  if (halmet::ParseLatLonE7(s.field(2), s.field(3), &lat_e7) &&
+      halmet::ParseLatLonE7(s.field(4), s.field(5), &lon_e7)) {
+    s_priority.set_own_position(lat_e7, lon_e7, millis());
+    s_dead_reckoner.on_fix(lat_e7, lon_e7, -1.0f, -1.0f, millis());
+  }
+  if (!halmet::ParseUnsigned(s.field(7), &sats)) sats = 0;
+  int32_t hdop_c, alt_c;
+  double hdop = halmet::ParseFixed(s.field(8), 2, &hdop_c)
+                    ? hdop_c / 100.0 : N2kDoubleNA;
+  double alt  = halmet::ParseFixed(s.field(9), 2, &alt_c)
+                    ? alt_c / 100.0 : N2kDoubleNA;
+  // GGA has the fix's time of day but no date; the date comes from the
+  // timebase, stepped back a day if the fix is from just before midnight
+  // and forward one if it is from just after. Until an RMC or ZDA has set
+  // the timebase the date is sent as not available, never as 1970-01-01.
+  uint16_t days = N2kUInt16NA;
+  double seconds = N2kDoubleNA;
+  int32_t hms_c;
+  if (halmet::ParseFixed(s.field(1), 2, &hms_c) && hms_c >= 0) {
+    seconds = hms_c / 1000000 * 3600 + hms_c / 10000 % 100 * 60 +
+              hms_c % 10000 / 100.0;
+    int64_t now_us = halmet::UtcMicros();
+    if (now_us) {
+      double now_s;
+      halmet::ToN2kTime(now_us, &days, &now_s);
+      if (seconds - now_s > 43200) {
+        days--;
+      } else if (now_s - seconds > 43200) {
+        days++;
+      }
     }
+  }
+  if (CanSendN2k()) {
+    tN2kMsg msg;
+    SetN2kPGN129029(msg, 0, days, seconds, lat, lon, alt,
+                    GnssTypeFromTalker(s.address()), N2kGNSSm_GNSSfix,
+                    (uint8_t)sats, hdop);
+    SendN2k(msg);
+  }
+}
+
+// VTG — course and speed over ground. Sends PGN 129026 only for receivers
+// that don't also give COG/SOG in RMC.
+// $--VTG,<cog °T>,T,<cog °M>,M,<sog kn>,N,<sog km/h>,K,<mode>
+static void HandleVtg(const Nmea0183Sentence& s) {
+  s_metrics.count_sentence(halmet::GatewayMetrics::kVtg);
+  if (s.field(9).ch() == 'N') return;  // mode: not valid
+  int32_t sog_c, cog_c;
+  bool has_cog = halmet::ParseFixed(s.field(1), 2, &cog_c);
+  bool has_sog = halmet::ParseFixed(s.field(5), 2, &sog_c);
+  if (!has_cog && !has_sog) return;
+  if (!FromPreferredSource(halmet::GatewayMetrics::kVtg)) return;
+  if (s_rmc_motion_ms && millis() - s_rmc_motion_ms < 3000) return;
+  s_priority.set_own_motion(has_sog ? sog_c / 100.0f : -1.0f,
+                            has_cog ? cog_c / 100.0f : -1.0f);
+  if (CanSendN2k()) {
+    tN2kMsg msg;
+    halmet::SetN2kPGN129026(
+        msg, 0xFF, N2khr_true,
+        has_cog ? halmet::DegreesHundredthsToN2k(cog_c) : N2kUInt16NA,
+        has_sog ? halmet::KnotsHundredthsToN2k(sog_c) : N2kUInt16NA);
+    SendN2k(msg);
+  }
+}
+
+// HDT — true heading, e.g. from a dual-antenna GNSS compass.
+// Sends PGN 127250 (Vessel Heading, true reference).
+// $--HDT,<heading °T>,T
+static void HandleHdt(const Nmea0183Sentence& s) {
+  s_metrics.count_sentence(halmet::GatewayMetrics::kHdt);
+  int32_t hdg_c;
+  if (!halmet::ParseFixed(s.field(1), 2, &hdg_c) || hdg_c < 0) return;
+  if (!FromPreferredSource(halmet::GatewayMetrics::kHdt)) return;
+  if (CanSendN2k()) {
+    tN2kMsg msg;
+    halmet::SetN2kPGN127250(msg, 0xFF, halmet::DegreesHundredthsToN2k(hdg_c),
+                            N2kInt16NA, N2kInt16NA, N2khr_true);
+    SendN2k(msg);
+  }
+}
+
+// ZDA — UTC date and time. Disciplines the system timebase, which sends
+// PGN 126992 (see SendSystemTime).
+// $--ZDA,<hhmmss.ss>,<dd>,<mm>,<yyyy>,<zone h>,<zone m>
+static void HandleZda(const Nmea0183Sentence& s) {
+  s_metrics.count_sentence(halmet::GatewayMetrics::kZda);
+  uint32_t day, month, year;
+  int64_t utc_us;
+  if (!halmet::ParseUnsigned(s.field(2), &day) ||
+      !halmet::ParseUnsigned(s.field(3), &month) ||
+      !halmet::ParseUnsigned(s.field(4), &year) ||
+      !ParseUtc(s.field(1), day, month, year, &utc_us)) {
     return;
   }
+  if (!FromPreferredSource(halmet::GatewayMetrics::kZda)) return;
+  halmet::SystemTimebase().discipline(utc_us, halmet::MonotonicMicros());
+}
 
-  // $PSRT responses from the AIS transponder hardware
-  if (strncmp(line, "$PSRT,", 6) == 0) {
-    const char* sub = line + 6;
-    if (strncmp(sub, "LED,", 4) == 0) {
-      ais_led = (uint8_t)atoi(sub + 4);
-    } else if (strncmp(sub, "ADC,", 4) == 0) {
-      const char* p = sub + 4;
-      ais_tx_fwd  = atof(p); p = strchr(p, ',') + 1;
-      ais_tx_rev  = atof(p); p = strchr(p, ',') + 1;
-      ais_rssi1   = atof(p); p = strchr(p, ',') + 1;
-      ais_rssi2   = atof(p); p = strchr(p, ',') + 1;
-      ais_v3v3    = atof(p); p = strchr(p, ',') + 1;
-      ais_v6v     = atof(p); p = strchr(p, ',') + 1;
-      ais_vsupply = atof(p);
-    } else if (strncmp(sub, "SRM,", 4) == 0) {
-      const char* p = sub + 4;
-      p = strchr(p, ',') + 1;
-      ais_silent = (atoi(p) & 0x08) != 0;
+// $PSRT responses from the AIS transponder hardware
+static void HandlePsrt(const Nmea0183Sentence& s) {
+  s_metrics.count_sentence(halmet::GatewayMetrics::kPsrt);
+  s_commands.on_sentence(s, millis());
+  const NmeaField& sub = s.field(1);
+  int32_t v;
+  uint32_t u;
+  if (sub.equals("LED")) {
+    if (halmet::ParseUnsigned(s.field(2), &u)) ais_led = (uint8_t)u;
+  } else if (sub.equals("ADC")) {
+    // $PSRT,ADC,<fwd>,<rev>,<rssi1>,<rssi2>,<3v3>,<6v>,<vsupply>
+    float* dst[] = {&ais_tx_fwd, &ais_tx_rev, &ais_rssi1, &ais_rssi2,
+                    &ais_v3v3, &ais_v6v, &ais_vsupply};
+    for (int i = 0; i < 7; i++) {
+      if (halmet::ParseFixed(s.field(2 + i), 3, &v)) *dst[i] = v / 1000.0f;
     }
+  } else if (sub.equals("SRM")) {
+    if (halmet::ParseUnsigned(s.field(3), &u)) ais_silent = (u & 0x08) != 0;
+  }
+}
+
+// Talker sentences are registered by formatter and accepted from any
+// talker (GP, GN, GL, GA, AI, ...); proprietary ones by full address.
+using SentenceHandler = void (*)(const Nmea0183Sentence&);
+using SentenceDispatcher = halmet::SentenceDispatcher<SentenceHandler, 16>;
+
+static constexpr SentenceDispatcher::Entry kSentenceHandlers[] = {
+    {"VDM", HandleVdm},
+    {"VDO", HandleVdm},
+    {"RMC", HandleRmc},
+    {"GGA", HandleGga},
+    {"VTG", HandleVtg},
+    {"HDT", HandleHdt},
+    {"ZDA", HandleZda},
+    {"PSRT", HandlePsrt},
+};
+
+static constexpr SentenceDispatcher s_dispatcher{kSentenceHandlers};
+static_assert(s_dispatcher.valid(), "sentence keys collide; grow the table");
+
+static void ParseSentence(const char* line) {
+
+  // Checksum first: a corrupt sentence costs one pass and never reaches
+  // the N2K senders.
+  Nmea0183Sentence s;
+  if (!s.parse(line)) {
+    s_metrics.count_checksum_error();
     return;
   }
+  if (s_line_tap) s_line_tap(line, strlen(line));
+
+  SentenceHandler handler = s_dispatcher.find(halmet::SentenceKey(s.address()));
+  if (handler) {
+    handler(s);
+  } else {
+    s_metrics.count_sentence(halmet::GatewayMetrics::kOther);
+  }
+}
+
+// ----------------------------------------------------------------
+// OWN-SHIP RAPID UPDATES
+//
+// RMC gives one fix per second. In between, PGN 129025/129026 are sent
+// from the dead-reckoned position and compass-steered course at
+// rapid_update_hz, so plotters and autopilots see smooth own-ship motion.
+// ----------------------------------------------------------------
+
+static void SendRapidUpdates() {
+  unsigned int hz = s_config ? s_config->rapid_update_hz : 10;
+  if (hz == 0 || !CanSendN2k()) return;
+  if (hz > 10) hz = 10;
+  if (s_rapid_update_timer < 1000 / hz) return;
+  s_rapid_update_timer = 0;
+
+  halmet::DeadReckonedFix fix;
+  if (!s_dead_reckoner.predict(millis(), &fix)) return;
+  tN2kMsg pos_msg;
+  halmet::SetN2kPGN129025(pos_msg, fix.lat_e7, fix.lon_e7);
+  SendN2k(pos_msg);
+  tN2kMsg msg;
+  halmet::SetN2kPGN129026(
+      msg, 0xFF, N2khr_true,
+      fix.cog_deg >= 0
+          ? halmet::DegreesHundredthsToN2k((int32_t)lroundf(fix.cog_deg * 100))
+          : N2kUInt16NA,
+      fix.sog_kn >= 0
+          ? halmet::KnotsHundredthsToN2k((int32_t)lroundf(fix.sog_kn * 100))
+          : N2kUInt16NA);
+  SendN2k(msg);
+}
+
+void AISGatewaySetHeading(float heading_deg) {
+  s_dead_reckoner.on_heading(heading_deg, millis());
+}
+
+// ----------------------------------------------------------------
+// SYSTEM TIME
+//
+// PGN 126992 once a second from the GNSS-disciplined timebase, while it
+// has had a time reference within its holdover window.
+// ----------------------------------------------------------------
+
+static elapsedMillis s_system_time_timer = 0;
+
+static void SendSystemTime() {
+  if (s_system_time_timer < 1000) return;
+  s_system_time_timer = 0;
+  uint64_t mono_us = halmet::MonotonicMicros();
+  const halmet::GnssTimebase& timebase = halmet::SystemTimebase();
+  if (!timebase.locked(mono_us) || !CanSendN2k()) return;
+  uint16_t days;
+  double seconds;
+  halmet::ToN2kTime(timebase.to_utc_us(mono_us), &days, &seconds);
+  tN2kMsg msg;
+  SetN2kPGN126992(msg, 0xFF, days, seconds, N2ktimes_GPS);
+  SendN2k(msg);
 }
 
 // ----------------------------------------------------------------
-// SERIAL READER
+// TRANSPONDER COMMANDS
+//
+// Commands to the transponder go through a non-blocking queue: one in
+// flight at a time, written only as far as the UART TX FIFO has room,
+// and matched to its $PSRT reply (see the PSRT handler above).
 // ----------------------------------------------------------------
 
-static char s_buf[256];
-static int  s_pos = 0;
+static size_t WriteSerial2(const char* data, size_t len) {
+  int room = Serial2.availableForWrite();
+  if (room <= 0) return 0;
+  if ((size_t)room < len) len = room;
+  return Serial2.write((const uint8_t*)data, len);
+}
 
-void AISGatewayInit() {
-  // Serial2 already started in main.cpp; nothing to do here.
+AISGatewayStats AISGatewayGetStats() {
+  AISGatewayStats st = s_stats;
+  st.bad_sentences = s_metrics.checksum_errors();
+  st.reassembly = s_reassembler.stats();
+  st.targets = s_targets.stats();
+  st.priority = s_priority.stats();
+  st.num_ports = s_num_ports;
+  for (int i = 0; i < s_num_ports; i++) {
+    InputPort& port = s_ports[i];
+    AISInputPortStats& ps = st.ports[i];
+    ps.name = port.name;
+    ps.priority = port.priority;
+    ps.sentences = port.sentences;
+    ps.superseded = port.superseded;
+    ps.rx_overruns = port.ring.overruns();
+    ps.rx_high_water = port.ring.high_water();
+    ps.rx_long_lines = port.long_lines.load(std::memory_order_relaxed);
+    ps.uart_errors = port.uart_errors.load(std::memory_order_relaxed);
+    ps.ingest_max_us = port.ingest_max_us.load(std::memory_order_relaxed);
+  }
+  st.commands = s_commands.stats();
+  st.commands_pending = s_commands.pending();
+#ifdef ENABLE_SIGNALK
+  st.signalk = s_sk_targets.stats();
+#endif
+  return st;
+}
+
+// Push the collision and priority settings into their engines. Runs at
+// init and whenever the config is loaded or edited, not per report.
+static void ApplyConfig() {
+  if (!s_config) return;
+  halmet::AisCollisionSettings cs;
+  cs.cpa_alarm_nm   = s_config->cpa_alarm_nm;
+  cs.tcpa_alarm_min = s_config->tcpa_alarm_min;
+  s_collision.configure(cs);
+
+  halmet::AisPrioritySettings ps;
+  ps.near_range_nm   = s_config->near_range_nm;
+  ps.far_range_nm    = s_config->far_range_nm;
+  ps.busy_rate       = s_config->busy_rate;
+  ps.mid_interval_ms = s_config->mid_interval_s * 1000;
+  ps.far_interval_ms = s_config->far_interval_s * 1000;
+  s_priority.configure(ps);
+}
+
+void AISGatewayInit(halmet::AISGatewayConfig* config) {
+  // Serial2 already started in main.cpp; the transponder is always port 0.
+  s_config = config;
+  if (config) config->on_change(ApplyConfig);
+  ApplyConfig();
+  AISGatewayAddPort(Serial2, "AIS", 1);
 }
 
 // Periodic AIS hardware status poll + N2K broadcast.
@@ -405,11 +1170,14 @@ static void PeriodicTasks() {
   if (ais_poll_timer < 30000) return;
   ais_poll_timer = 0;
 
-  AISSendCommand("$DUAIQ,LED");
-  AISSendCommand("$DUAIQ,ADC");
-  AISSendCommand("$DUAIQ,SRM");
+  // Skip a round if the last one is still waiting on a silent transponder.
+  if (s_commands.pending() == 0) {
+    AISQueueCommand("$DUAIQ,LED", "LED");
+    AISQueueCommand("$DUAIQ,ADC", "ADC");
+    AISQueueCommand("$DUAIQ,SRM", "SRM");
+  }
 
-  if (!nmea2000) return;
+  if (!CanSendN2k()) return;
   tN2kMsg msg;
   msg.SetPGN(130001L);
   msg.Priority = 6;
@@ -421,37 +1189,71 @@ static void PeriodicTasks() {
   msg.Add2ByteDouble(ais_tx_rev,  0.1);
   msg.Add2ByteDouble(ais_rssi1,   0.1);
   msg.Add2ByteDouble(ais_rssi2,   0.1);
-  nmea2000->SendMsg(msg);
+  SendN2k(msg);
 }
 
 void AISSendCommand(const char* cmd) {
-  // Compute NMEA checksum: XOR of characters after leading '$'/'!' up to '*'
-  uint8_t cksum = 0;
-  const char* p = cmd + 1;  // skip the '$' or '!' prefix
-  while (*p && *p != '*') cksum ^= (uint8_t)*p++;
-  char buf[128];
-  snprintf(buf, sizeof(buf), "%s*%02X\r\n", cmd, cksum);
-  Serial2.print(buf);
+  s_commands.push(cmd);
+}
+
+bool AISQueueCommand(const char* cmd, const char* reply_key,
+                     halmet::AisCommandCallback callback, uint32_t timeout_ms,
+                     uint8_t retries) {
+  return s_commands.push(cmd, reply_key, callback, timeout_ms, retries);
+}
+
+const halmet::GatewayMetrics& AISGatewayMetrics() {
+  return s_metrics;
+}
+
+int AISGatewayCollisionStatus(halmet::AisCollisionInfo* worst) {
+  return s_collision.dangerous(millis(), worst);
+}
+
+void AISGatewayFeedLine(const char* line) {
+  s_current_port = 0;
+  ParseNMEA(line);
+}
+
+void AISGatewaySetN2kSink(AISN2kSink sink) {
+  s_n2k_sink = sink;
+}
+
+int AISGatewayFlushSignalK(halmet::AisDeltaWriter writer, int max_deltas) {
+#ifdef ENABLE_SIGNALK
+  return s_sk_targets.flush(millis(), halmet::UtcMicros(), writer, max_deltas);
+#else
+  return 0;
+#endif
+}
+
+void AISGatewaySetLineTap(AISLineTap tap) {
+  s_line_tap = tap;
 }
 
 void AISGatewayLoop() {
   PeriodicTasks();
+  SendRapidUpdates();
+  SendSystemTime();
+  s_commands.pump(millis(), WriteSerial2);
 
-  // Process up to 64 bytes per call to avoid blocking the event loop
-  int processed = 0;
-  while (Serial2.available() && processed < 64) {
-    char c = (char)Serial2.read();
-    processed++;
-    if (c == '\r' || c == '\n') {
-      if (s_pos > 0) {
-        s_buf[s_pos] = '\0';
-        ParseNMEA(s_buf);
-        s_pos = 0;
-      }
-    } else if (s_pos < 255) {
-      s_buf[s_pos++] = c;
-    } else {
-      s_pos = 0;  // overflow — discard and resync
+  // Parse at most 16 finished sentences per pass, taking turns between
+  // ports; the rings absorb bursts.
+  int budget = 16;
+  bool more = true;
+  while (more && budget > 0) {
+    more = false;
+    for (int i = 0; i < s_num_ports && budget > 0; i++) {
+      InputPort& port = s_ports[i];
+      const char* line = port.ring.front();
+      if (!line) continue;
+      s_current_port = i;
+      ParseNMEA(line);
+      port.ring.pop();
+      port.sentences++;
+      budget--;
+      more = true;
     }
   }
+  s_current_port = 0;
 }
@@ -1,4 +1,93 @@
 #pragma once
-void AISGatewayInit();          // call once from setup()
+#include <N2kMsg.h>
+#include "ais_collision.h"
+#include "ais_command_queue.h"
+#include "ais_gateway_config.h"
+#include "ais_priority.h"
+#include "ais_reassembly.h"
+#include "ais_signalk.h"
+#include "ais_target_table.h"
+#include "gateway_metrics.h"
+
+class HardwareSerial;
+
+constexpr int kAISMaxPorts = 2;  // NMEA 0183 inputs: Serial2 (AIS) + one aux
+
+struct AISInputPortStats {
+  const char* name = "";
+  uint8_t priority = 0;
+  uint32_t sentences = 0;      // lines handed to the parser
+  uint32_t superseded = 0;     // own-ship sentences left to a preferred port
+  uint32_t rx_overruns = 0;    // sentences lost to a full RX ring
+  uint32_t rx_high_water = 0;  // most sentences ever queued at once
+  uint32_t rx_long_lines = 0;  // over-length lines discarded
+  uint32_t uart_errors = 0;    // UART FIFO/buffer overflow, framing, parity
+  uint32_t ingest_max_us = 0;  // longest single onReceive callback
+};
+
+struct AISGatewayStats {
+  uint32_t bad_sentences = 0;      // checksum/format failures
+  uint32_t static_forwarded = 0;   // PGN 129794 sent
+  uint32_t static_suppressed = 0;  // unchanged Type 5 not re-sent
+  uint32_t commands_pending = 0;   // transponder commands queued or in flight
+  halmet::AisCommandStats commands;
+  halmet::AisSignalKStats signalk;  // zero unless built with ENABLE_SIGNALK
+  halmet::AisReassemblyStats reassembly;
+  halmet::AisTargetTableStats targets;
+  halmet::AisPriorityStats priority;
+  int num_ports = 0;
+  AISInputPortStats ports[kAISMaxPorts];
+};
+
+void AISGatewayInit(halmet::AISGatewayConfig* config);  // call once from setup()
 void AISGatewayLoop();          // call from loop()
-void AISSendCommand(const char* cmd);   // send a $PSRT… command
\ No newline at end of file
+
+// Merge another NMEA 0183 input (already begun) into the gateway. Its
+// sentences share the parser with Serial2, which AISGatewayInit() adds as
+// port 0 with priority 1. When several ports send the same own-ship
+// sentence (RMC, GGA, VTG, HDT, ZDA), the one with the lowest priority
+// number is used and the others' copies are ignored until it falls silent
+// for 5 s. Returns the port index, or -1 if all kAISMaxPorts are taken.
+int AISGatewayAddPort(HardwareSerial& serial, const char* name,
+                      uint8_t priority);
+void AISSendCommand(const char* cmd);   // queue a $PSRT… command, no reply expected
+
+// Queue a transponder command without blocking. The $PSRT reply whose
+// first field equals reply_key completes it; otherwise it is re-sent up to
+// `retries` times, timeout_ms apart, before the callback sees kTimeout.
+// Returns false if the queue is full.
+bool AISQueueCommand(const char* cmd, const char* reply_key,
+                     halmet::AisCommandCallback callback = nullptr,
+                     uint32_t timeout_ms = 1000, uint8_t retries = 2);
+AISGatewayStats AISGatewayGetStats();
+
+// Compass heading (degrees, any reference) for steering the dead-reckoned
+// own-ship course between GNSS fixes.
+void AISGatewaySetHeading(float heading_deg);
+
+// Live pipeline counters: sentences, AIS types/channels, N2K sends per
+// PGN, parse-to-send latency.
+const halmet::GatewayMetrics& AISGatewayMetrics();
+
+// Number of targets currently on a dangerous closest approach; *worst
+// receives the one with the earliest CPA (mmsi 0 when there is none).
+int AISGatewayCollisionStatus(halmet::AisCollisionInfo* worst);
+
+// Write one Signal K delta per AIS target that changed since the last
+// call (at most max_deltas) and expire silent targets. Needs
+// ENABLE_SIGNALK; returns the number of deltas written.
+int AISGatewayFlushSignalK(halmet::AisDeltaWriter writer, int max_deltas);
+
+// Parse one complete NMEA 0183 sentence (no line terminator) exactly as if
+// it had arrived on Serial2 (port 0). Lets recorded logs be replayed
+// through the gateway.
+void AISGatewayFeedLine(const char* line);
+
+// Redirect the gateway's N2K output. nullptr restores the shared bus.
+using AISN2kSink = bool (*)(const tN2kMsg& msg);
+void AISGatewaySetN2kSink(AISN2kSink sink);
+
+// Receive every sentence that passes its checksum, before it is decoded,
+// e.g. to re-publish the raw stream. nullptr disables.
+using AISLineTap = void (*)(const char* line, int len);
+void AISGatewaySetLineTap(AISLineTap tap);
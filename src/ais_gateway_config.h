@@ -0,0 +1,181 @@
+#ifndef HALMET_SRC_AIS_GATEWAY_CONFIG_H_
+#define HALMET_SRC_AIS_GATEWAY_CONFIG_H_
+
+#include <functional>
+
+#include "sensesp/system/saveable.h"
+
+namespace halmet {
+
+/**
+ * @brief Runtime-tunable AIS gateway settings.
+ *
+ * Persisted like the N2K sender configs and edited from the web UI.
+ */
+class AISGatewayConfig : public sensesp::FileSystemSaveable {
+ public:
+  AISGatewayConfig(String config_path)
+      : sensesp::FileSystemSaveable{config_path} {}
+
+  // --------------------------------------------------------------------
+  // SETTINGS
+  // --------------------------------------------------------------------
+  // Unchanged static/voyage data is re-sent at most this often (seconds).
+  unsigned int static_refresh_s = 300;
+
+  // Proximity-prioritized forwarding. Above busy_rate position reports/s,
+  // targets beyond near range that aren't closing are rate-limited: moving
+  // targets inside far range to one report per mid_interval_s, stationary
+  // or distant ones to one per far_interval_s. 0 disables throttling.
+  unsigned int busy_rate = 15;
+  float near_range_nm = 3.0f;
+  float far_range_nm = 12.0f;
+  unsigned int mid_interval_s = 10;
+  unsigned int far_interval_s = 60;
+
+  // Collision assessment: a target is dangerous when its closest point of
+  // approach is under cpa_alarm_nm and no more than tcpa_alarm_min ahead.
+  float cpa_alarm_nm = 0.5f;
+  float tcpa_alarm_min = 12.0f;
+
+  // Own-ship PGN 129025/129026 rate between GNSS fixes, dead-reckoned from
+  // the last fix and the compass (1-10 Hz). 0 sends them once per fix.
+  unsigned int rapid_update_hz = 10;
+
+  // Auxiliary NMEA 0183 input on Serial1; 0 leaves it off. Read at boot.
+  // When aux_gnss_preferred is set, own-ship fix, course, heading and time
+  // come from it rather than from the transponder's GNSS.
+  unsigned int aux_baud = 0;
+  bool aux_gnss_preferred = true;
+
+  // Called after the settings are loaded or edited from the web UI, so
+  // users can re-derive anything they cache from them.
+  using ChangeHandler = std::function<void()>;
+  void on_change(ChangeHandler handler) { on_change_ = std::move(handler); }
+
+  // --------------------------------------------------------------------
+  // CONFIGURATION PERSISTENCE
+  // --------------------------------------------------------------------
+  virtual bool from_json(const JsonObject& config) override {
+    if (config["static_refresh_s"].is<unsigned int>()) {
+      static_refresh_s = config["static_refresh_s"];
+    }
+    if (config["busy_rate"].is<unsigned int>()) {
+      busy_rate = config["busy_rate"];
+    }
+    if (config["near_range_nm"].is<float>()) {
+      near_range_nm = config["near_range_nm"];
+    }
+    if (config["far_range_nm"].is<float>()) {
+      far_range_nm = config["far_range_nm"];
+    }
+    if (config["mid_interval_s"].is<unsigned int>()) {
+      mid_interval_s = config["mid_interval_s"];
+    }
+    if (config["far_interval_s"].is<unsigned int>()) {
+      far_interval_s = config["far_interval_s"];
+    }
+    if (config["cpa_alarm_nm"].is<float>()) {
+      cpa_alarm_nm = config["cpa_alarm_nm"];
+    }
+    if (config["tcpa_alarm_min"].is<float>()) {
+      tcpa_alarm_min = config["tcpa_alarm_min"];
+    }
+    if (config["rapid_update_hz"].is<unsigned int>()) {
+      rapid_update_hz = config["rapid_update_hz"];
+    }
+    if (config["aux_baud"].is<unsigned int>()) {
+      aux_baud = config["aux_baud"];
+    }
+    if (config["aux_gnss_preferred"].is<bool>()) {
+      aux_gnss_preferred = config["aux_gnss_preferred"];
+    }
+    if (on_change_) on_change_();
+    return true;
+  }
+
+  virtual bool to_json(JsonObject& config) override {
+    config["static_refresh_s"] = static_refresh_s;
+    config["busy_rate"] = busy_rate;
+    config["near_range_nm"] = near_range_nm;
+    config["far_range_nm"] = far_range_nm;
+    config["mid_interval_s"] = mid_interval_s;
+    config["far_interval_s"] = far_interval_s;
+    config["cpa_alarm_nm"] = cpa_alarm_nm;
+    config["tcpa_alarm_min"] = tcpa_alarm_min;
+    config["rapid_update_hz"] = rapid_update_hz;
+    config["aux_baud"] = aux_baud;
+    config["aux_gnss_preferred"] = aux_gnss_preferred;
+    return true;
+  }
+
+ private:
+  ChangeHandler on_change_;
+};
+
+inline const String ConfigSchema(const AISGatewayConfig& obj) {
+  return R"###({
+    "type": "object",
+    "properties": {
+      "static_refresh_s": {
+        "title": "Static data refresh interval",
+        "type": "integer",
+        "description": "Seconds between re-sends of unchanged AIS static data (PGN 129794, 129809, 129810)"
+      },
+      "busy_rate": {
+        "title": "Busy threshold",
+        "type": "integer",
+        "description": "AIS position reports per second above which distant targets are throttled (0 = never throttle)"
+      },
+      "near_range_nm": {
+        "title": "Near range (nm)",
+        "type": "number",
+        "description": "Targets closer than this, or closing on own ship, are always forwarded at full rate"
+      },
+      "far_range_nm": {
+        "title": "Far range (nm)",
+        "type": "number",
+        "description": "Moving targets beyond this range are treated like stationary ones"
+      },
+      "mid_interval_s": {
+        "title": "Mid tier interval",
+        "type": "integer",
+        "description": "Seconds between position reports per moving target between near and far range, when busy"
+      },
+      "far_interval_s": {
+        "title": "Far tier interval",
+        "type": "integer",
+        "description": "Seconds between position reports per distant or stationary target, when busy"
+      },
+      "cpa_alarm_nm": {
+        "title": "CPA alarm distance (nm)",
+        "type": "number",
+        "description": "Targets passing closer than this are reported as dangerous"
+      },
+      "tcpa_alarm_min": {
+        "title": "TCPA alarm horizon (min)",
+        "type": "number",
+        "description": "Only closest approaches within this many minutes raise the alarm"
+      },
+      "rapid_update_hz": {
+        "title": "Own-ship rapid update rate (Hz)",
+        "type": "integer",
+        "description": "PGN 129025/129026 rate, dead-reckoned between GNSS fixes (1-10; 0 = once per fix)"
+      },
+      "aux_baud": {
+        "title": "Aux NMEA 0183 baud rate",
+        "type": "integer",
+        "description": "Second NMEA 0183 input on Serial1, e.g. 4800 or 38400 (0 = off; takes effect after restart)"
+      },
+      "aux_gnss_preferred": {
+        "title": "Prefer aux GNSS",
+        "type": "boolean",
+        "description": "Take own-ship position, course, heading and time from the aux input when both inputs send them"
+      }
+    }
+  })###";
+}
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_AIS_GATEWAY_CONFIG_H_
@@ -0,0 +1,297 @@
+#ifndef HALMET_SRC_AIS_MESSAGES_H_
+#define HALMET_SRC_AIS_MESSAGES_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "ais_payload.h"
+
+namespace halmet {
+
+// ========================================================================
+// AIS MESSAGE LAYOUTS
+//
+// Each message type is described by a constexpr table of numeric fields
+// (bit offset, width, signedness, scale) and a handful of text fields.
+// AisDecode<Layout>() expands the table at compile time into straight-line
+// get_uint/get_int calls with constant offsets, so adding a message type
+// is a table, not another hand-written decoder.
+//
+// Offsets and widths follow ITU-R M.1371.
+// ========================================================================
+
+struct AisField {
+  uint8_t id;  // must equal the field's index in its table
+  uint16_t offset;
+  uint8_t width;
+  bool is_signed;
+  float scale;  // raw × scale = value in the field's natural unit
+};
+
+struct AisText {
+  uint16_t offset;
+  uint8_t chars;
+};
+
+template <typename Layout>
+constexpr bool AisLayoutIsOrdered(size_t i = 0) {
+  return i == Layout::kCount ||
+         (Layout::kFields[i].id == i && AisLayoutIsOrdered<Layout>(i + 1));
+}
+
+/**
+ * @brief Raw field values of one decoded message.
+ */
+template <typename Layout>
+struct AisRecord {
+  int32_t raw[Layout::kCount];
+
+  template <size_t I>
+  int32_t get() const {
+    return raw[I];
+  }
+  template <size_t I>
+  uint32_t get_uint() const {
+    return (uint32_t)raw[I];
+  }
+  template <size_t I>
+  float scaled() const {
+    return raw[I] * Layout::kFields[I].scale;
+  }
+};
+
+template <uint16_t Offset, uint8_t Width, bool Signed>
+inline int32_t AisExtract(const AisPayload& p) {
+  static_assert(Width >= 1 && Width <= 32, "AIS field width out of range");
+  return Signed ? p.get_int(Offset, Width) : (int32_t)p.get_uint(Offset, Width);
+}
+
+template <typename Layout, size_t... I>
+inline void AisDecodeFields(const AisPayload& p, AisRecord<Layout>& r,
+                            std::index_sequence<I...>) {
+  ((r.raw[I] = AisExtract<Layout::kFields[I].offset, Layout::kFields[I].width,
+                          Layout::kFields[I].is_signed>(p)),
+   ...);
+}
+
+template <typename Layout>
+inline AisRecord<Layout> AisDecode(const AisPayload& p) {
+  static_assert(AisLayoutIsOrdered<Layout>(), "field ids out of order");
+  AisRecord<Layout> r;
+  AisDecodeFields<Layout>(p, r, std::make_index_sequence<Layout::kCount>{});
+  return r;
+}
+
+template <size_t N>
+inline void AisDecodeText(const AisPayload& p, const AisText& t,
+                          char (&out)[N]) {
+  p.get_string(t.offset, t.chars, out, (int)N);
+}
+
+// Sentinels shared by several layouts
+constexpr int32_t kAisLon28NA = 0x6791AC0;  // 181° in 1/10000 min
+constexpr int32_t kAisLat27NA = 0x3412140;  // 91° in 1/10000 min
+constexpr uint32_t kAisHeadingNA = 511;
+
+// ------------------------------------------------------------------------
+// Types 1, 2, 3 — Class A position report
+// ------------------------------------------------------------------------
+struct AisClassAPositionLayout {
+  enum : uint8_t { kMmsi, kNavStatus, kRot, kSog, kAccuracy, kLon, kLat,
+                   kCog, kHeading, kSecond, kRaim, kCount };
+  static constexpr AisField kFields[kCount] = {
+      {kMmsi, 8, 30, false, 1.0f},
+      {kNavStatus, 38, 4, false, 1.0f},
+      {kRot, 42, 8, true, 1.0f},
+      {kSog, 50, 10, false, 0.1f},  // knots; 1023 = N/A
+      {kAccuracy, 60, 1, false, 1.0f},
+      {kLon, 61, 28, true, 1.0f},  // 1/10000 min
+      {kLat, 89, 27, true, 1.0f},
+      {kCog, 116, 12, false, 0.1f},  // degrees; 3600 = N/A
+      {kHeading, 128, 9, false, 1.0f},
+      {kSecond, 137, 6, false, 1.0f},
+      {kRaim, 148, 1, false, 1.0f},
+  };
+};
+
+// ------------------------------------------------------------------------
+// Type 4 — Base station report (UTC and position)
+// ------------------------------------------------------------------------
+struct AisBaseStationLayout {
+  enum : uint8_t { kMmsi, kYear, kMonth, kDay, kHour, kMinute, kSecond,
+                   kAccuracy, kLon, kLat, kEpfd, kRaim, kCount };
+  static constexpr AisField kFields[kCount] = {
+      {kMmsi, 8, 30, false, 1.0f},
+      {kYear, 38, 14, false, 1.0f},
+      {kMonth, 52, 4, false, 1.0f},
+      {kDay, 56, 5, false, 1.0f},
+      {kHour, 61, 5, false, 1.0f},
+      {kMinute, 66, 6, false, 1.0f},
+      {kSecond, 72, 6, false, 1.0f},
+      {kAccuracy, 78, 1, false, 1.0f},
+      {kLon, 79, 28, true, 1.0f},
+      {kLat, 107, 27, true, 1.0f},
+      {kEpfd, 134, 4, false, 1.0f},
+      {kRaim, 148, 1, false, 1.0f},
+  };
+};
+
+// ------------------------------------------------------------------------
+// Type 5 — Class A static and voyage data (2 sentences)
+// ------------------------------------------------------------------------
+struct AisStaticVoyageLayout {
+  enum : uint8_t { kMmsi, kImo, kShipType, kToBow, kToStern, kToPort,
+                   kToStbd, kEpfd, kCount };
+  static constexpr AisField kFields[kCount] = {
+      {kMmsi, 8, 30, false, 1.0f},
+      {kImo, 40, 30, false, 1.0f},
+      {kShipType, 232, 8, false, 1.0f},
+      {kToBow, 240, 9, false, 1.0f},
+      {kToStern, 249, 9, false, 1.0f},
+      {kToPort, 258, 6, false, 1.0f},
+      {kToStbd, 264, 6, false, 1.0f},
+      {kEpfd, 270, 4, false, 1.0f},
+  };
+  static constexpr AisText kCallsign{70, 7};
+  static constexpr AisText kName{112, 20};
+};
+
+// ------------------------------------------------------------------------
+// Type 9 — Standard SAR aircraft position report
+// ------------------------------------------------------------------------
+struct AisSarAircraftLayout {
+  enum : uint8_t { kMmsi, kAltitude, kSog, kAccuracy, kLon, kLat, kCog,
+                   kSecond, kDte, kRaim, kCount };
+  static constexpr AisField kFields[kCount] = {
+      {kMmsi, 8, 30, false, 1.0f},
+      {kAltitude, 38, 12, false, 1.0f},  // metres; 4095 = N/A
+      {kSog, 50, 10, false, 1.0f},       // knots (not tenths); 1023 = N/A
+      {kAccuracy, 60, 1, false, 1.0f},
+      {kLon, 61, 28, true, 1.0f},
+      {kLat, 89, 27, true, 1.0f},
+      {kCog, 116, 12, false, 0.1f},
+      {kSecond, 128, 6, false, 1.0f},
+      {kDte, 142, 1, false, 1.0f},
+      {kRaim, 147, 1, false, 1.0f},
+  };
+};
+
+// ------------------------------------------------------------------------
+// Type 18 — Class B CS position report
+// ------------------------------------------------------------------------
+struct AisClassBPositionLayout {
+  enum : uint8_t { kMmsi, kSog, kAccuracy, kLon, kLat, kCog, kHeading,
+                   kSecond, kRaim, kCount };
+  static constexpr AisField kFields[kCount] = {
+      {kMmsi, 8, 30, false, 1.0f},
+      {kSog, 46, 10, false, 0.1f},
+      {kAccuracy, 56, 1, false, 1.0f},
+      {kLon, 57, 28, true, 1.0f},
+      {kLat, 85, 27, true, 1.0f},
+      {kCog, 112, 12, false, 0.1f},
+      {kHeading, 124, 9, false, 1.0f},
+      {kSecond, 133, 6, false, 1.0f},
+      {kRaim, 147, 1, false, 1.0f},
+  };
+};
+
+// ------------------------------------------------------------------------
+// Type 19 — Class B extended position report
+// ------------------------------------------------------------------------
+struct AisClassBExtendedLayout {
+  enum : uint8_t { kMmsi, kSog, kAccuracy, kLon, kLat, kCog, kHeading,
+                   kSecond, kShipType, kToBow, kToStern, kToPort, kToStbd,
+                   kEpfd, kRaim, kDte, kAssigned, kCount };
+  static constexpr AisField kFields[kCount] = {
+      {kMmsi, 8, 30, false, 1.0f},
+      {kSog, 46, 10, false, 0.1f},
+      {kAccuracy, 56, 1, false, 1.0f},
+      {kLon, 57, 28, true, 1.0f},
+      {kLat, 85, 27, true, 1.0f},
+      {kCog, 112, 12, false, 0.1f},
+      {kHeading, 124, 9, false, 1.0f},
+      {kSecond, 133, 6, false, 1.0f},
+      {kShipType, 263, 8, false, 1.0f},
+      {kToBow, 271, 9, false, 1.0f},
+      {kToStern, 280, 9, false, 1.0f},
+      {kToPort, 289, 6, false, 1.0f},
+      {kToStbd, 295, 6, false, 1.0f},
+      {kEpfd, 301, 4, false, 1.0f},
+      {kRaim, 305, 1, false, 1.0f},
+      {kDte, 306, 1, false, 1.0f},
+      {kAssigned, 307, 1, false, 1.0f},
+  };
+  static constexpr AisText kName{143, 20};
+};
+
+// ------------------------------------------------------------------------
+// Type 21 — Aid-to-navigation report
+// ------------------------------------------------------------------------
+struct AisAtoNLayout {
+  enum : uint8_t { kMmsi, kAtoNType, kAccuracy, kLon, kLat, kToBow,
+                   kToStern, kToPort, kToStbd, kEpfd, kSecond, kOffPosition,
+                   kRaim, kVirtual, kAssigned, kCount };
+  static constexpr AisField kFields[kCount] = {
+      {kMmsi, 8, 30, false, 1.0f},
+      {kAtoNType, 38, 5, false, 1.0f},
+      {kAccuracy, 163, 1, false, 1.0f},
+      {kLon, 164, 28, true, 1.0f},
+      {kLat, 192, 27, true, 1.0f},
+      {kToBow, 219, 9, false, 1.0f},
+      {kToStern, 228, 9, false, 1.0f},
+      {kToPort, 237, 6, false, 1.0f},
+      {kToStbd, 243, 6, false, 1.0f},
+      {kEpfd, 249, 4, false, 1.0f},
+      {kSecond, 253, 6, false, 1.0f},
+      {kOffPosition, 259, 1, false, 1.0f},
+      {kRaim, 268, 1, false, 1.0f},
+      {kVirtual, 269, 1, false, 1.0f},
+      {kAssigned, 270, 1, false, 1.0f},
+  };
+  static constexpr AisText kName{43, 20};
+};
+
+// ------------------------------------------------------------------------
+// Type 24 — Class B static data (part A: name, part B: the rest)
+// ------------------------------------------------------------------------
+struct AisClassBStaticLayout {
+  enum : uint8_t { kMmsi, kPartNumber, kShipType, kToBow, kToStern,
+                   kToPort, kToStbd, kMothershipMmsi, kCount };
+  static constexpr AisField kFields[kCount] = {
+      {kMmsi, 8, 30, false, 1.0f},
+      {kPartNumber, 38, 2, false, 1.0f},
+      {kShipType, 40, 8, false, 1.0f},  // part B
+      {kToBow, 132, 9, false, 1.0f},
+      {kToStern, 141, 9, false, 1.0f},
+      {kToPort, 150, 6, false, 1.0f},
+      {kToStbd, 156, 6, false, 1.0f},
+      {kMothershipMmsi, 132, 30, false, 1.0f},  // overlays dimensions
+  };
+  static constexpr AisText kName{40, 20};     // part A
+  static constexpr AisText kVendor{48, 7};    // part B
+  static constexpr AisText kCallsign{90, 7};  // part B
+};
+
+// ------------------------------------------------------------------------
+// Type 27 — Long-range AIS broadcast
+// ------------------------------------------------------------------------
+struct AisLongRangeLayout {
+  enum : uint8_t { kMmsi, kAccuracy, kRaim, kNavStatus, kLon, kLat, kSog,
+                   kCog, kGnss, kCount };
+  static constexpr AisField kFields[kCount] = {
+      {kMmsi, 8, 30, false, 1.0f},
+      {kAccuracy, 38, 1, false, 1.0f},
+      {kRaim, 39, 1, false, 1.0f},
+      {kNavStatus, 40, 4, false, 1.0f},
+      {kLon, 44, 18, true, 1.0f},  // 1/10 min; 181° = N/A
+      {kLat, 62, 17, true, 1.0f},  // 1/10 min; 91° = N/A
+      {kSog, 79, 6, false, 1.0f},  // knots; 63 = N/A
+      {kCog, 85, 9, false, 1.0f},  // degrees; 511 = N/A
+      {kGnss, 94, 1, false, 1.0f},
+  };
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_AIS_MESSAGES_H_
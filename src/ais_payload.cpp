@@ -0,0 +1,87 @@
+// src/ais_payload.cpp
+//
+// AIS 6-bit payload dearmoring into a packed bit buffer.
+
+#include "ais_payload.h"
+
+namespace halmet {
+
+namespace {
+
+constexpr uint8_t kInvalid = 0xFF;
+
+// ASCII → 6-bit value: '0'..'W' → 0..39, '`'..'w' → 40..63.
+struct DearmorTable {
+  uint8_t v[128];
+  constexpr DearmorTable() : v{} {
+    for (int c = 0; c < 128; c++) {
+      if (c >= 48 && c <= 87) {
+        v[c] = (uint8_t)(c - 48);
+      } else if (c >= 96 && c <= 119) {
+        v[c] = (uint8_t)(c - 56);
+      } else {
+        v[c] = kInvalid;
+      }
+    }
+  }
+};
+
+constexpr DearmorTable kDearmor;
+
+inline uint8_t dearmor(char c) {
+  return ((uint8_t)c < 128) ? kDearmor.v[(uint8_t)c] : kInvalid;
+}
+
+}  // namespace
+
+bool AisPayload::append(const char* armored, int len) {
+  if (len < 0 || num_bits_ + len * 6 > kMaxBits) return false;
+  int i = 0;
+
+  // Fast path: while the write position is byte aligned, four characters
+  // form exactly three bytes.
+  if ((num_bits_ & 7) == 0) {
+    uint8_t* out = bytes_ + (num_bits_ >> 3);
+    for (; i + 4 <= len; i += 4) {
+      uint8_t a = dearmor(armored[i]);
+      uint8_t b = dearmor(armored[i + 1]);
+      uint8_t c = dearmor(armored[i + 2]);
+      uint8_t d = dearmor(armored[i + 3]);
+      if ((a | b | c | d) & 0xC0) return false;
+      uint32_t w = ((uint32_t)a << 18) | ((uint32_t)b << 12) |
+                   ((uint32_t)c << 6) | d;
+      *out++ = (uint8_t)(w >> 16);
+      *out++ = (uint8_t)(w >> 8);
+      *out++ = (uint8_t)w;
+    }
+    num_bits_ += i * 6;
+  }
+
+  // Tail (or unaligned continuation of a multi-part message): OR each 6-bit
+  // group into a 16-bit window at the current bit offset.
+  for (; i < len; i++) {
+    uint8_t v = dearmor(armored[i]);
+    if (v & 0xC0) return false;
+    int byte = num_bits_ >> 3;
+    uint16_t w = (uint16_t)((uint16_t)v << 10) >> (num_bits_ & 7);
+    bytes_[byte] |= (uint8_t)(w >> 8);
+    bytes_[byte + 1] |= (uint8_t)w;
+    num_bits_ += 6;
+  }
+  return true;
+}
+
+void AisPayload::get_string(int start, int num_chars, char* out,
+                            int out_len) const {
+  if (out_len <= 0) return;
+  int n = (num_chars < out_len - 1) ? num_chars : out_len - 1;
+  for (int i = 0; i < n; i++) {
+    int c = (int)get_uint(start + i * 6, 6);
+    if (c < 32) c += 64;
+    out[i] = (char)c;
+  }
+  while (n > 0 && (out[n - 1] == '@' || out[n - 1] == ' ')) n--;
+  out[n] = '\0';
+}
+
+}  // namespace halmet
@@ -0,0 +1,83 @@
+#ifndef HALMET_SRC_AIS_PAYLOAD_H_
+#define HALMET_SRC_AIS_PAYLOAD_H_
+
+#include <cstdint>
+#include <cstring>
+
+namespace halmet {
+
+/**
+ * @brief Dearmored AIS message payload held as a packed big-endian bit buffer.
+ *
+ * VDM/VDO sentences carry the message as 6-bit ASCII-armored characters.
+ * The payload is dearmored once into bytes_ (MSB-first, exactly as the bits
+ * appear on the air) and every field is then read with a single unaligned
+ * 64-bit load, a shift and a mask instead of walking characters bit by bit.
+ *
+ * Bits past the end of the loaded payload read as zero.
+ */
+class AisPayload {
+ public:
+  // An AIS message occupies at most 5 slots = 1008 bits = 168 characters.
+  static constexpr int kMaxChars = 168;
+  static constexpr int kMaxBits = kMaxChars * 6;
+
+  AisPayload() { clear(); }
+
+  void clear() {
+    memset(bytes_, 0, sizeof(bytes_));
+    num_bits_ = 0;
+  }
+
+  // Dearmor `len` characters and append them to the buffer. Returns false
+  // (leaving the payload in an unspecified state) if a character is outside
+  // the AIS armoring alphabet or the message would exceed kMaxChars.
+  bool append(const char* armored, int len);
+
+  // Replace the buffer contents with `len` armored characters.
+  bool load(const char* armored, int len) {
+    clear();
+    return append(armored, len);
+  }
+
+  int num_bits() const { return num_bits_; }
+
+  // Unsigned field of 1..32 bits starting at bit `start`.
+  uint32_t get_uint(int start, int num_bits) const {
+    if (num_bits <= 0 || start < 0 || start + num_bits > kMaxBits) return 0;
+    uint64_t w = load_be64(bytes_ + (start >> 3));
+    return (uint32_t)((w << (start & 7)) >> (64 - num_bits));
+  }
+
+  // Two's-complement signed field of 1..32 bits.
+  int32_t get_int(int start, int num_bits) const {
+    if (num_bits <= 0) return 0;
+    uint32_t v = get_uint(start, num_bits);
+    return (int32_t)(v << (32 - num_bits)) >> (32 - num_bits);
+  }
+
+  bool get_bool(int start) const { return get_uint(start, 1) != 0; }
+
+  // Extract a 6-bit ASCII string. '@' (ASCII 64) is the AIS padding/space
+  // character; trailing '@' and spaces are trimmed.
+  void get_string(int start, int num_chars, char* out, int out_len) const;
+
+ private:
+  static uint64_t load_be64(const uint8_t* p) {
+    uint64_t w;
+    memcpy(&w, p, sizeof(w));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+    return w;
+  }
+
+  // One 64-bit load may start at the last payload byte, so keep 8 bytes of
+  // zeroed slack past kMaxBits.
+  uint8_t bytes_[kMaxBits / 8 + 8];
+  int num_bits_;
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_AIS_PAYLOAD_H_
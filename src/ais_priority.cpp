@@ -0,0 +1,99 @@
+// src/ais_priority.cpp
+//
+// Range / closing-speed ranking of AIS targets for load shedding.
+
+#include "ais_priority.h"
+
+#include <cmath>
+
+namespace halmet {
+
+static constexpr float kDegToRad = 0.017453292f;
+static constexpr float kE7ToNm = 60.0f / 1e7f;
+
+static bool valid_position(int32_t lat_e7, int32_t lon_e7) {
+  return lat_e7 >= -900000000 && lat_e7 <= 900000000 &&
+         lon_e7 >= -1800000000 && lon_e7 <= 1800000000;
+}
+
+void AisPriorityPolicy::set_own_position(int32_t lat_e7, int32_t lon_e7,
+                                         uint32_t now_ms) {
+  if (!valid_position(lat_e7, lon_e7)) return;
+  own_lat_e7_ = lat_e7;
+  own_lon_e7_ = lon_e7;
+  own_cos_lat_ = std::cos(lat_e7 * (kDegToRad / 1e7f));
+  fix_ms_ = now_ms ? now_ms : 1;
+}
+
+void AisPriorityPolicy::set_own_motion(float sog_kn, float cog_deg) {
+  bool valid = sog_kn >= 0.0f && cog_deg >= 0.0f && cog_deg < 360.0f;
+  own_sog_kn_ = valid ? sog_kn : 0.0f;
+  own_cog_deg_ = valid ? cog_deg : 0.0f;
+}
+
+AisTier AisPriorityPolicy::classify(int32_t lat_e7, int32_t lon_e7,
+                                    float sog_kn, float cog_deg,
+                                    uint32_t now_ms) const {
+  if (!has_fix(now_ms) || !valid_position(lat_e7, lon_e7)) {
+    return AisTier::kNear;
+  }
+
+  // Flat-earth offsets in nautical miles; fine at AIS ranges. Differences
+  // are taken in integers so float only ever sees small numbers.
+  int64_t dlon = (int64_t)lon_e7 - own_lon_e7_;
+  if (dlon > 1800000000) dlon -= 3600000000LL;
+  if (dlon < -1800000000) dlon += 3600000000LL;
+  float dx = (float)dlon * kE7ToNm * own_cos_lat_;
+  float dy = (float)((int64_t)lat_e7 - own_lat_e7_) * kE7ToNm;
+  float range = std::sqrt(dx * dx + dy * dy);
+  if (range < settings_.near_range_nm) return AisTier::kNear;
+
+  bool moving = sog_kn >= kStationaryKn && sog_kn < 102.3f &&
+                cog_deg >= 0.0f && cog_deg < 360.0f;
+  float tvx = moving ? sog_kn * std::sin(cog_deg * kDegToRad) : 0.0f;
+  float tvy = moving ? sog_kn * std::cos(cog_deg * kDegToRad) : 0.0f;
+  float ovx = own_sog_kn_ * std::sin(own_cog_deg_ * kDegToRad);
+  float ovy = own_sog_kn_ * std::cos(own_cog_deg_ * kDegToRad);
+
+  // Closing speed: relative velocity projected onto the line of sight,
+  // positive when the range is shrinking.
+  float closing = -(dx * (tvx - ovx) + dy * (tvy - ovy)) / range;
+  if (range < settings_.far_range_nm) {
+    if (closing >= kClosingKn) return AisTier::kNear;
+    if (moving) return AisTier::kMid;
+  }
+  return AisTier::kFar;
+}
+
+bool AisPriorityPolicy::busy(uint32_t now_ms) {
+  // Rate over the last whole second; the current window only counts.
+  if (now_ms - window_start_ms_ >= 1000) {
+    stats_.rate = (now_ms - window_start_ms_ < 2000) ? window_count_ : 0;
+    window_start_ms_ = now_ms;
+    window_count_ = 0;
+  }
+  window_count_++;
+  return settings_.busy_rate != 0 && stats_.rate > settings_.busy_rate;
+}
+
+bool AisPriorityPolicy::admit(AisTarget* t, int32_t lat_e7, int32_t lon_e7,
+                              float sog_kn, float cog_deg, uint32_t now_ms) {
+  bool under_load = busy(now_ms);
+  if (under_load && t && t->position_sent_ms != 0) {
+    uint32_t interval = 0;
+    switch (classify(lat_e7, lon_e7, sog_kn, cog_deg, now_ms)) {
+      case AisTier::kNear: interval = 0; break;
+      case AisTier::kMid: interval = settings_.mid_interval_ms; break;
+      case AisTier::kFar: interval = settings_.far_interval_ms; break;
+    }
+    if (now_ms - t->position_sent_ms < interval) {
+      stats_.throttled++;
+      return false;
+    }
+  }
+  if (t) t->position_sent_ms = now_ms ? now_ms : 1;
+  stats_.forwarded++;
+  return true;
+}
+
+}  // namespace halmet
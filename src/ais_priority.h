@@ -0,0 +1,93 @@
+#ifndef HALMET_SRC_AIS_PRIORITY_H_
+#define HALMET_SRC_AIS_PRIORITY_H_
+
+#include <cstdint>
+
+#include "ais_target_table.h"
+
+namespace halmet {
+
+enum class AisTier : uint8_t {
+  kNear,  // inside near range, or closing on own ship: always full rate
+  kMid,   // moving, inside far range
+  kFar,   // beyond far range, or stationary outside near range
+};
+
+struct AisPrioritySettings {
+  float near_range_nm = 3.0f;
+  float far_range_nm = 12.0f;
+  uint32_t busy_rate = 15;          // position reports/s that count as busy
+  uint32_t mid_interval_ms = 10000;  // minimum spacing per target when busy
+  uint32_t far_interval_ms = 60000;
+};
+
+struct AisPriorityStats {
+  uint32_t forwarded = 0;  // position reports sent to N2K
+  uint32_t throttled = 0;  // position reports held back under load
+  uint32_t rate = 0;       // position reports offered in the last second
+};
+
+/**
+ * @brief Decides which AIS position reports reach the N2K bus under load.
+ *
+ * Targets are ranked by range and closing speed relative to own ship.
+ * While the offered position-report rate stays below busy_rate everything
+ * is forwarded. Above it, mid and far tier targets are limited to one
+ * report per tier interval; reports inside the interval are dropped, so
+ * the next one that goes out always carries the newest position.
+ *
+ * Without a recent own-ship fix every target ranks as near.
+ */
+class AisPriorityPolicy {
+ public:
+  static constexpr uint32_t kFixTimeoutMs = 10000;
+  static constexpr float kClosingKn = 1.0f;     // counts as approaching
+  static constexpr float kStationaryKn = 0.5f;
+
+  void configure(const AisPrioritySettings& settings) { settings_ = settings; }
+
+  // Own-ship fix in 1e-7 degrees. Pass negative sog_kn / cog_deg when
+  // unknown; GGA-only updates keep the previous speed and course.
+  void set_own_position(int32_t lat_e7, int32_t lon_e7, uint32_t now_ms);
+  void set_own_motion(float sog_kn, float cog_deg);
+
+  AisTier classify(int32_t lat_e7, int32_t lon_e7, float sog_kn,
+                   float cog_deg, uint32_t now_ms) const;
+
+  /**
+   * @brief Rank one position report and record the decision on the target.
+   *
+   * lat/lon in 1e-7 degrees (any value outside ±90° / ±180°, such as
+   * N2kInt32NA, when unknown), sog in knots and cog in degrees (negative
+   * or ≥ 360 when unknown). Math is single precision throughout.
+   *
+   * @return true if the report should be forwarded.
+   */
+  bool admit(AisTarget* t, int32_t lat_e7, int32_t lon_e7, float sog_kn,
+             float cog_deg, uint32_t now_ms);
+
+  const AisPriorityStats& stats() const { return stats_; }
+
+ private:
+  bool has_fix(uint32_t now_ms) const {
+    return fix_ms_ != 0 && now_ms - fix_ms_ < kFixTimeoutMs;
+  }
+  bool busy(uint32_t now_ms);
+
+  AisPrioritySettings settings_;
+  AisPriorityStats stats_;
+
+  int32_t own_lat_e7_ = 0;
+  int32_t own_lon_e7_ = 0;
+  float own_cos_lat_ = 1.0f;
+  float own_sog_kn_ = 0.0f;
+  float own_cog_deg_ = 0.0f;
+  uint32_t fix_ms_ = 0;
+
+  uint32_t window_start_ms_ = 0;
+  uint32_t window_count_ = 0;
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_AIS_PRIORITY_H_
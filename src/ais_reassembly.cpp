@@ -0,0 +1,100 @@
+// src/ais_reassembly.cpp
+//
+// Multi-sentence AIS message reassembly.
+
+#include "ais_reassembly.h"
+
+namespace halmet {
+
+AisReassembler::Slot* AisReassembler::find(char seq_id, char channel,
+                                           int total) {
+  for (Slot& s : slots_) {
+    if (s.in_use && s.seq_id == seq_id && s.channel == channel &&
+        s.total == total) {
+      return &s;
+    }
+  }
+  return nullptr;
+}
+
+AisReassembler::Slot* AisReassembler::allocate(uint32_t now_ms) {
+  Slot* oldest = nullptr;
+  for (Slot& s : slots_) {
+    if (!s.in_use) return &s;
+    if (!oldest || now_ms - s.started_ms > now_ms - oldest->started_ms) {
+      oldest = &s;
+    }
+  }
+  // Every slot busy: the oldest partial message loses.
+  stats_.evicted++;
+  oldest->in_use = false;
+  return oldest;
+}
+
+void AisReassembler::expire(uint32_t now_ms) {
+  uint32_t in_use = 0;
+  for (Slot& s : slots_) {
+    if (!s.in_use) continue;
+    if (now_ms - s.started_ms > kTimeoutMs) {
+      s.in_use = false;
+      stats_.timed_out++;
+    } else {
+      in_use++;
+    }
+  }
+  if (in_use > stats_.high_water) stats_.high_water = in_use;
+}
+
+const AisPayload* AisReassembler::add(char seq_id, char channel, int total,
+                                      int part, const char* armored, int len,
+                                      uint32_t now_ms) {
+  expire(now_ms);
+
+  if (total < 2 || total > kMaxParts || part < 1 || part > total) {
+    stats_.dropped++;
+    return nullptr;
+  }
+
+  Slot* s = find(seq_id, channel, total);
+
+  if (part == 1) {
+    if (s) {
+      // Sequence ID reused before the previous message completed.
+      stats_.dropped++;
+    } else {
+      s = allocate(now_ms);
+    }
+    s->in_use = true;
+    s->seq_id = seq_id;
+    s->channel = channel;
+    s->total = (uint8_t)total;
+    s->next_part = 2;
+    s->started_ms = now_ms;
+    if (!s->payload.load(armored, len)) {
+      s->in_use = false;
+      stats_.dropped++;
+    }
+    return nullptr;
+  }
+
+  if (!s) {
+    // Continuation without a first part (lost, timed out or evicted).
+    stats_.dropped++;
+    return nullptr;
+  }
+  if (part != s->next_part || !s->payload.append(armored, len)) {
+    s->in_use = false;
+    stats_.dropped++;
+    return nullptr;
+  }
+  if (part < s->total) {
+    s->next_part++;
+    return nullptr;
+  }
+
+  s->in_use = false;
+  stats_.completed++;
+  return &s->payload;
+}
+
+}  // namespace halmet
@@ -0,0 +1,64 @@
+#ifndef HALMET_SRC_AIS_REASSEMBLY_H_
+#define HALMET_SRC_AIS_REASSEMBLY_H_
+
+#include <cstdint>
+
+#include "ais_payload.h"
+
+namespace halmet {
+
+struct AisReassemblyStats {
+  uint32_t completed = 0;   // multi-part messages handed to the decoder
+  uint32_t dropped = 0;     // fragments discarded (orphan, gap, bad payload)
+  uint32_t timed_out = 0;   // partial messages expired by timeout
+  uint32_t evicted = 0;     // partial messages evicted because all slots were busy
+  uint32_t high_water = 0;  // most slots ever in use at once
+};
+
+/**
+ * @brief Reassembly table for multi-sentence AIS messages.
+ *
+ * Fragments are keyed on (sequential message ID, channel, total count) so
+ * interleaved messages on channels A and B assemble independently. Each
+ * slot owns a preallocated AisPayload that fragments are dearmored into as
+ * they arrive; nothing is allocated after construction.
+ */
+class AisReassembler {
+ public:
+  static constexpr int kNumSlots = 8;
+  static constexpr int kMaxParts = 5;
+  static constexpr uint32_t kTimeoutMs = 3000;
+
+  /**
+   * @brief Add one fragment.
+   *
+   * @return The completed payload once the last fragment arrives, otherwise
+   *   nullptr. The returned payload stays valid until the next call.
+   */
+  const AisPayload* add(char seq_id, char channel, int total, int part,
+                        const char* armored, int len, uint32_t now_ms);
+
+  const AisReassemblyStats& stats() const { return stats_; }
+
+ private:
+  struct Slot {
+    bool in_use = false;
+    char seq_id = 0;
+    char channel = 0;
+    uint8_t total = 0;
+    uint8_t next_part = 0;
+    uint32_t started_ms = 0;
+    AisPayload payload;
+  };
+
+  Slot* find(char seq_id, char channel, int total);
+  Slot* allocate(uint32_t now_ms);
+  void expire(uint32_t now_ms);
+
+  Slot slots_[kNumSlots];
+  AisReassemblyStats stats_;
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_AIS_REASSEMBLY_H_
@@ -0,0 +1,214 @@
+// src/ais_signalk.cpp
+//
+// Batched Signal K publication of AIS targets.
+
+#include "ais_signalk.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace halmet {
+
+static constexpr int32_t kInt32NA = 0x7fffffff;  // N2kInt32NA
+static constexpr float kKnToMs = 1852.0f / 3600.0f;
+static constexpr float kDegToRad = 0.017453292f;
+
+// Signal K navigation.state for AIS navigational status 0..8, 11..14.
+static const char* NavState(uint8_t status) {
+  static const char* const kStates[] = {
+      "motoring", "anchored", "not under command", "restricted manouverability",
+      "constrained by draft", "moored", "aground", "fishing", "sailing",
+      nullptr, nullptr, "hazardous material high speed",
+      "hazardous material wing in ground", nullptr, "ais-sart"};
+  return status < sizeof(kStates) / sizeof(kStates[0]) ? kStates[status]
+                                                       : nullptr;
+}
+
+// snprintf that appends at *pos and never runs past len
+static void append(char* buf, size_t len, size_t* pos, const char* fmt, ...) {
+  if (*pos >= len) return;
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(buf + *pos, len - *pos, fmt, args);
+  va_end(args);
+  if (n > 0) *pos += (size_t)n;
+  if (*pos >= len) *pos = len - 1;
+}
+
+// Copy AIS text for JSON: drop characters that would need escaping.
+static void JsonSafe(char* dst, const char* src, size_t len) {
+  size_t i = 0;
+  for (; src[i] && i < len - 1; i++) {
+    dst[i] = (src[i] == '"' || src[i] == '\\') ? ' ' : src[i];
+  }
+  dst[i] = '\0';
+}
+
+AisSignalKTargets::Target* AisSignalKTargets::touch(uint32_t mmsi,
+                                                    uint32_t now_ms) {
+  if (mmsi == 0) return nullptr;
+  uint32_t home = (mmsi * 0x9E3779B1u) & (kMaxTargets - 1);
+  Target* free_slot = nullptr;
+  Target* oldest = nullptr;
+  for (int i = 0; i < kMaxProbe; i++) {
+    Target* t = &targets_[(home + i) & (kMaxTargets - 1)];
+    if (t->mmsi == mmsi) {
+      t->heard_ms = now_ms;
+      return t;
+    }
+    if (t->mmsi == 0) {
+      if (!free_slot) free_slot = t;
+    } else if (!oldest || now_ms - t->heard_ms > now_ms - oldest->heard_ms) {
+      oldest = t;
+    }
+  }
+  Target* t = free_slot;
+  if (!t) {
+    t = oldest;
+    stats_.evicted++;
+    stats_.targets--;
+  }
+  *t = Target{};
+  t->mmsi = mmsi;
+  t->heard_ms = now_ms;
+  stats_.targets++;
+  return t;
+}
+
+void AisSignalKTargets::update_position(uint32_t mmsi, int32_t lat_e7,
+                                        int32_t lon_e7, float sog_kn,
+                                        float cog_deg, float heading_deg,
+                                        uint8_t nav_status, uint32_t now_ms) {
+  Target* t = touch(mmsi, now_ms);
+  if (!t) return;
+  t->lat_e7 = lat_e7;
+  t->lon_e7 = lon_e7;
+  t->sog_kn = sog_kn;
+  t->cog_deg = cog_deg;
+  t->heading_deg = heading_deg;
+  t->nav_status = nav_status;
+  t->dirty |= kDirtyPosition;
+  stats_.reports++;
+}
+
+void AisSignalKTargets::update_static(uint32_t mmsi, const char* name,
+                                      const char* callsign, uint8_t ship_type,
+                                      uint16_t length_m, uint16_t beam_m,
+                                      uint32_t now_ms) {
+  Target* t = touch(mmsi, now_ms);
+  if (!t) return;
+  JsonSafe(t->name, name, sizeof(t->name));
+  JsonSafe(t->callsign, callsign, sizeof(t->callsign));
+  t->ship_type = ship_type;
+  t->length_m = length_m;
+  t->beam_m = beam_m;
+  t->has_static = true;
+  t->dirty |= kDirtyStatic;
+  stats_.reports++;
+}
+
+size_t AisSignalKTargets::format(const Target& t, int64_t utc_us,
+                                 char* buf) const {
+  const size_t len = kMaxDeltaLen;
+  size_t pos = 0;
+  append(buf, len, &pos,
+         "{\"context\":\"vessels.urn:mrn:imo:mmsi:%09lu\",\"updates\":[{",
+         (unsigned long)t.mmsi);
+  if (utc_us > 0) {
+    time_t secs = (time_t)(utc_us / 1000000);
+    struct tm tm;
+    gmtime_r(&secs, &tm);
+    char when[24];
+    strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%S", &tm);
+    append(buf, len, &pos, "\"timestamp\":\"%s.%03dZ\",", when,
+           (int)(utc_us / 1000 % 1000));
+  }
+  append(buf, len, &pos, "\"values\":[{\"path\":\"\",\"value\":{\"mmsi\":\"%09lu\"",
+         (unsigned long)t.mmsi);
+  if ((t.dirty & kDirtyStatic) && t.name[0]) {
+    append(buf, len, &pos, ",\"name\":\"%s\"", t.name);
+  }
+  append(buf, len, &pos, "}}");
+
+  if (t.dirty & kDirtyPosition) {
+    if (t.lat_e7 != kInt32NA && t.lon_e7 != kInt32NA) {
+      append(buf, len, &pos,
+             ",{\"path\":\"navigation.position\",\"value\":"
+             "{\"latitude\":%.7f,\"longitude\":%.7f}}",
+             t.lat_e7 * 1e-7, t.lon_e7 * 1e-7);
+    }
+    if (t.sog_kn >= 0) {
+      append(buf, len, &pos,
+             ",{\"path\":\"navigation.speedOverGround\",\"value\":%.2f}",
+             t.sog_kn * kKnToMs);
+    }
+    if (t.cog_deg >= 0) {
+      append(buf, len, &pos,
+             ",{\"path\":\"navigation.courseOverGroundTrue\",\"value\":%.4f}",
+             t.cog_deg * kDegToRad);
+    }
+    if (t.heading_deg >= 0) {
+      append(buf, len, &pos,
+             ",{\"path\":\"navigation.headingTrue\",\"value\":%.4f}",
+             t.heading_deg * kDegToRad);
+    }
+    const char* state = NavState(t.nav_status);
+    if (state) {
+      append(buf, len, &pos,
+             ",{\"path\":\"navigation.state\",\"value\":\"%s\"}", state);
+    }
+  }
+
+  if (t.dirty & kDirtyStatic) {
+    if (t.callsign[0]) {
+      append(buf, len, &pos,
+             ",{\"path\":\"communication.callsignVhf\",\"value\":\"%s\"}",
+             t.callsign);
+    }
+    if (t.ship_type) {
+      append(buf, len, &pos,
+             ",{\"path\":\"design.aisShipType\",\"value\":{\"id\":%u}}",
+             (unsigned)t.ship_type);
+    }
+    if (t.length_m) {
+      append(buf, len, &pos,
+             ",{\"path\":\"design.length\",\"value\":{\"overall\":%u}}",
+             (unsigned)t.length_m);
+    }
+    if (t.beam_m) {
+      append(buf, len, &pos, ",{\"path\":\"design.beam\",\"value\":%u}",
+             (unsigned)t.beam_m);
+    }
+  }
+  append(buf, len, &pos, "]}]}");
+  return pos;
+}
+
+int AisSignalKTargets::flush(uint32_t now_ms, int64_t utc_us,
+                             AisDeltaWriter writer, int max_deltas) {
+  char buf[kMaxDeltaLen];
+  int written = 0;
+  int i = 0;
+  for (; i < kMaxTargets && written < max_deltas; i++) {
+    Target& t = targets_[(cursor_ + i) & (kMaxTargets - 1)];
+    if (t.mmsi == 0) continue;
+    if (now_ms - t.heard_ms > kExpireMs) {
+      t = Target{};
+      stats_.expired++;
+      stats_.targets--;
+      continue;
+    }
+    if (!t.dirty) continue;
+    size_t len = format(t, utc_us, buf);
+    if (writer) writer(buf, len);
+    t.dirty = 0;
+    written++;
+    stats_.deltas++;
+  }
+  cursor_ = (cursor_ + i) & (kMaxTargets - 1);
+  return written;
+}
+
+}  // namespace halmet
@@ -0,0 +1,97 @@
+#ifndef HALMET_SRC_AIS_SIGNALK_H_
+#define HALMET_SRC_AIS_SIGNALK_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace halmet {
+
+struct AisSignalKStats {
+  uint32_t targets = 0;  // targets currently held
+  uint32_t deltas = 0;   // deltas written
+  uint32_t reports = 0;  // updates coalesced into them
+  uint32_t expired = 0;  // targets dropped after kExpireMs of silence
+  uint32_t evicted = 0;  // targets replaced to make room
+};
+
+// Receives one complete Signal K delta (JSON, NUL-terminated).
+using AisDeltaWriter = void (*)(const char* json, size_t len);
+
+/**
+ * @brief Coalesces decoded AIS targets into Signal K deltas.
+ *
+ * Reports only update a fixed table of kMaxTargets entries and mark them
+ * dirty; flush() then writes one delta per changed target with the
+ * latest values, under the target's vessels.urn:mrn:imo:mmsi:<mmsi>
+ * context. However many reports a target sent since the last flush, it
+ * costs one delta. A Signal K delta carries a single context, so targets
+ * can't share one.
+ *
+ * The table is probed like AisTargetTable: a bounded window per MMSI,
+ * with the least recently heard target in the window replaced when it is
+ * full. Targets silent for kExpireMs are dropped.
+ */
+class AisSignalKTargets {
+ public:
+  static constexpr int kMaxTargets = 128;  // must be a power of two
+  static constexpr int kMaxProbe = 16;
+  static constexpr uint32_t kExpireMs = 600000;
+  static constexpr size_t kMaxDeltaLen = 768;
+
+  // lat/lon in 1e-7 degree (N2kInt32NA when unavailable); negative
+  // sog/cog/heading when unavailable; nav_status 15 when undefined.
+  void update_position(uint32_t mmsi, int32_t lat_e7, int32_t lon_e7,
+                       float sog_kn, float cog_deg, float heading_deg,
+                       uint8_t nav_status, uint32_t now_ms);
+
+  // Static data; dimensions in metres, 0 when unknown.
+  void update_static(uint32_t mmsi, const char* name, const char* callsign,
+                     uint8_t ship_type, uint16_t length_m, uint16_t beam_m,
+                     uint32_t now_ms);
+
+  /**
+   * @brief Expire silent targets and write deltas for changed ones.
+   *
+   * @param utc_us Timestamp for the deltas (UTC µs since 1970); 0 leaves
+   *   it to the server.
+   * @param max_deltas Cap per call; the rest go out on the next flush,
+   *   continuing where this one stopped.
+   * @return Number of deltas written.
+   */
+  int flush(uint32_t now_ms, int64_t utc_us, AisDeltaWriter writer,
+            int max_deltas);
+
+  const AisSignalKStats& stats() const { return stats_; }
+
+ private:
+  enum : uint8_t { kDirtyPosition = 1, kDirtyStatic = 2 };
+
+  struct Target {
+    uint32_t mmsi = 0;  // 0 marks an unused slot
+    uint32_t heard_ms = 0;
+    uint8_t dirty = 0;
+    bool has_static = false;
+    uint8_t nav_status = 15;
+    uint8_t ship_type = 0;
+    int32_t lat_e7 = 0;
+    int32_t lon_e7 = 0;
+    float sog_kn = -1.0f;
+    float cog_deg = -1.0f;
+    float heading_deg = -1.0f;
+    uint16_t length_m = 0;
+    uint16_t beam_m = 0;
+    char name[21] = "";
+    char callsign[8] = "";
+  };
+
+  Target* touch(uint32_t mmsi, uint32_t now_ms);
+  size_t format(const Target& t, int64_t utc_us, char* buf) const;
+
+  Target targets_[kMaxTargets];
+  int cursor_ = 0;  // where the next flush starts
+  AisSignalKStats stats_;
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_AIS_SIGNALK_H_
@@ -0,0 +1,56 @@
+// src/ais_target_table.cpp
+//
+// Fixed-size MMSI → AIS target hash table.
+
+#include "ais_target_table.h"
+
+namespace halmet {
+
+AisTarget* AisTargetTable::find(uint32_t mmsi) {
+  if (mmsi == 0) return nullptr;
+  uint32_t i = home(mmsi);
+  for (int n = 0; n < kMaxProbe; n++, i = (i + 1) & (kCapacity - 1)) {
+    AisTarget& t = slots_[i];
+    if (t.mmsi == mmsi) return &t;
+    if (t.mmsi == 0) return nullptr;
+  }
+  return nullptr;
+}
+
+AisTarget* AisTargetTable::touch(uint32_t mmsi, uint32_t now_ms,
+                                 bool* fresh) {
+  if (fresh) *fresh = false;
+  if (mmsi == 0) return nullptr;
+  uint32_t i = home(mmsi);
+  AisTarget* oldest = nullptr;
+  for (int n = 0; n < kMaxProbe; n++, i = (i + 1) & (kCapacity - 1)) {
+    AisTarget& t = slots_[i];
+    if (t.mmsi == mmsi) {
+      t.last_seen_ms = now_ms;
+      return &t;
+    }
+    if (t.mmsi == 0) {
+      // Slots are never emptied, so the key can't be further along.
+      t = AisTarget{};
+      t.mmsi = mmsi;
+      t.last_seen_ms = now_ms;
+      stats_.size++;
+      if (fresh) *fresh = true;
+      return &t;
+    }
+    if (!oldest ||
+        now_ms - t.last_seen_ms > now_ms - oldest->last_seen_ms) {
+      oldest = &t;
+    }
+  }
+
+  // Window full: the target heard from least recently gives up its slot.
+  stats_.evicted++;
+  *oldest = AisTarget{};
+  oldest->mmsi = mmsi;
+  oldest->last_seen_ms = now_ms;
+  if (fresh) *fresh = true;
+  return oldest;
+}
+
+}  // namespace halmet
@@ -0,0 +1,67 @@
+#ifndef HALMET_SRC_AIS_TARGET_TABLE_H_
+#define HALMET_SRC_AIS_TARGET_TABLE_H_
+
+#include <cstdint>
+
+namespace halmet {
+
+/**
+ * @brief Per-vessel state kept by the AIS gateway.
+ */
+struct AisTarget {
+  uint32_t mmsi = 0;            // 0 marks an unused slot
+  uint32_t last_seen_ms = 0;
+  uint32_t static_hash = 0;     // hash of the last forwarded Type 5 fields
+  uint32_t static_sent_ms = 0;  // when PGN 129794 last went out
+  uint32_t class_b_hash = 0;    // hash of the last forwarded Type 24 A+B
+  uint32_t class_b_sent_ms = 0; // when PGN 129809/129810 last went out
+  uint32_t position_sent_ms = 0;  // when a position PGN last went out
+};
+
+struct AisTargetTableStats {
+  uint32_t size = 0;       // slots in use
+  uint32_t evicted = 0;    // targets replaced to make room
+};
+
+/**
+ * @brief Fixed-size open-addressing hash table of AIS targets keyed by MMSI.
+ *
+ * Linear probing over a bounded window. Slots are never emptied, only
+ * reused: when a new MMSI finds no free slot in its window, the target in
+ * the window that was heard from least recently is replaced. This keeps
+ * lookups correct without tombstones and the memory footprint constant.
+ */
+class AisTargetTable {
+ public:
+  static constexpr int kCapacity = 512;  // must be a power of two
+  static constexpr int kMaxProbe = 16;
+
+  // Look up a target, or nullptr if it isn't in the table.
+  AisTarget* find(uint32_t mmsi);
+
+  // Look up or insert a target and mark it as seen at now_ms. *fresh, if
+  // given, is set when the slot was newly taken or reused for this MMSI,
+  // so per-slot data kept elsewhere can be reset.
+  AisTarget* touch(uint32_t mmsi, uint32_t now_ms, bool* fresh = nullptr);
+
+  // Slot number of a target returned by find()/touch(), for keeping
+  // per-target data in parallel arrays of kCapacity entries.
+  int index_of(const AisTarget* t) const { return (int)(t - slots_); }
+
+  const AisTargetTableStats& stats() const { return stats_; }
+
+ private:
+  static uint32_t home(uint32_t mmsi) {
+    return (mmsi * 0x9E3779B1u) >> (32 - kLog2Capacity);
+  }
+
+  static constexpr int kLog2Capacity = 9;
+  static_assert((1 << kLog2Capacity) == kCapacity, "capacity mismatch");
+
+  AisTarget slots_[kCapacity];
+  AisTargetTableStats stats_;
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_AIS_TARGET_TABLE_H_
@@ -0,0 +1,82 @@
+// src/dead_reckoning.cpp
+//
+// Own-ship position/course prediction between GNSS fixes.
+
+#include "dead_reckoning.h"
+
+#include <cmath>
+
+namespace halmet {
+
+static constexpr float kDegToRad = 0.017453292f;
+
+// Wrap an angle difference into [-180, 180).
+static float WrapDegrees180(float d) {
+  d = fmodf(d + 180.0f, 360.0f);
+  return (d < 0 ? d + 360.0f : d) - 180.0f;
+}
+
+void DeadReckoner::on_fix(int32_t lat_e7, int32_t lon_e7, float sog_kn,
+                          float cog_deg, uint32_t now_ms) {
+  lat_e7_ = lat_e7;
+  lon_e7_ = lon_e7;
+  cos_lat_ = cosf(lat_e7 * 1e-7f * kDegToRad);
+  if (cos_lat_ < 0.01f) cos_lat_ = 0.01f;  // keep longitude finite at the poles
+  if (sog_kn >= 0) {
+    sog_kn_ = sog_kn;
+    sog_ms_ = now_ms;
+  }
+  if (cog_deg >= 0) {
+    cog_deg_ = cog_deg;
+    cog_ms_ = now_ms;
+    cog_heading_valid_ = heading_fresh(now_ms);
+    cog_heading_deg_ = heading_deg_;
+  }
+  fix_ms_ = now_ms;
+  has_fix_ = true;
+  fix_heading_valid_ = heading_fresh(now_ms);
+  fix_heading_deg_ = heading_deg_;
+}
+
+void DeadReckoner::on_heading(float heading_deg, uint32_t now_ms) {
+  heading_deg_ = heading_deg;
+  heading_ms_ = now_ms;
+  has_heading_ = true;
+}
+
+bool DeadReckoner::predict(uint32_t now_ms, DeadReckonedFix* out) const {
+  uint32_t age_ms = now_ms - fix_ms_;
+  if (!has_fix_ || age_ms > kMaxExtrapolationMs) return false;
+
+  out->lat_e7 = lat_e7_;
+  out->lon_e7 = lon_e7_;
+  out->sog_kn = sog_fresh(now_ms) ? sog_kn_ : -1.0f;
+  out->cog_deg = -1.0f;
+  if (!cog_fresh(now_ms)) return true;
+
+  // Turn since the COG was measured, now and at the fix; they differ when
+  // the fix (GGA) came without motion.
+  float turn = 0.0f;
+  if (cog_heading_valid_ && heading_fresh(now_ms)) {
+    turn = WrapDegrees180(heading_deg_ - cog_heading_deg_);
+  }
+  float fix_turn = 0.0f;
+  if (cog_heading_valid_ && fix_heading_valid_) {
+    fix_turn = WrapDegrees180(fix_heading_deg_ - cog_heading_deg_);
+  }
+  out->cog_deg = fmodf(cog_deg_ + turn + 360.0f, 360.0f);
+  if (out->sog_kn <= 0) return true;
+
+  // Advance along the mean course since the fix (chord of a steady turn).
+  // 1 nm = 1 minute of latitude.
+  float dist_deg = sog_kn_ * (age_ms / 3600000.0f) / 60.0f;
+  float c = (cog_deg_ + (fix_turn + turn) * 0.5f) * kDegToRad;
+  out->lat_e7 = lat_e7_ + (int32_t)lroundf(dist_deg * cosf(c) * 1e7f);
+  int64_t lon = lon_e7_ + lroundf(dist_deg * sinf(c) / cos_lat_ * 1e7f);
+  if (lon > 1800000000) lon -= 3600000000LL;
+  if (lon < -1800000000) lon += 3600000000LL;
+  out->lon_e7 = (int32_t)lon;
+  return true;
+}
+
+}  // namespace halmet
@@ -0,0 +1,82 @@
+#ifndef HALMET_SRC_DEAD_RECKONING_H_
+#define HALMET_SRC_DEAD_RECKONING_H_
+
+#include <cstdint>
+
+namespace halmet {
+
+struct DeadReckonedFix {
+  int32_t lat_e7 = 0;  // 1e-7 degree
+  int32_t lon_e7 = 0;
+  float sog_kn = -1.0f;   // negative when unknown
+  float cog_deg = -1.0f;  // true, [0, 360); negative when unknown
+};
+
+/**
+ * @brief Predicts own-ship position and course between 1 Hz GNSS fixes.
+ *
+ * Starting from the last fix, the position is advanced along the course
+ * at the fix's SOG. The course follows the compass: whatever the heading
+ * has turned since the fix is added to the fix's COG, so the absolute
+ * heading reference (magnetic, uncorrected) doesn't matter. Each new fix
+ * replaces the prediction outright.
+ *
+ * SOG and COG age separately from the position: a fix without motion
+ * (GGA, or RMC with empty fields) moves the position but leaves them at
+ * their old timestamps, and once they are older than kMaxExtrapolationMs
+ * they are reported unknown and the position is no longer advanced.
+ *
+ * Float math on a local flat-earth approximation, good for the few
+ * metres covered between fixes. Time comes in as now_ms, so recorded
+ * tracks can be replayed on a host.
+ */
+class DeadReckoner {
+ public:
+  static constexpr uint32_t kMaxExtrapolationMs = 2500;  // ~2 missed fixes
+  static constexpr uint32_t kHeadingTimeoutMs = 1000;
+
+  // GNSS fix. Negative sog_kn / cog_deg keep the previous values, and
+  // their age, for sentences (GGA) that carry no motion.
+  void on_fix(int32_t lat_e7, int32_t lon_e7, float sog_kn, float cog_deg,
+              uint32_t now_ms);
+
+  // Compass heading in degrees, any reference.
+  void on_heading(float heading_deg, uint32_t now_ms);
+
+  // Predicted state at now_ms; false without a fix in the last
+  // kMaxExtrapolationMs.
+  bool predict(uint32_t now_ms, DeadReckonedFix* out) const;
+
+ private:
+  bool heading_fresh(uint32_t now_ms) const {
+    return has_heading_ && now_ms - heading_ms_ <= kHeadingTimeoutMs;
+  }
+  bool sog_fresh(uint32_t now_ms) const {
+    return sog_kn_ >= 0 && now_ms - sog_ms_ <= kMaxExtrapolationMs;
+  }
+  bool cog_fresh(uint32_t now_ms) const {
+    return cog_deg_ >= 0 && now_ms - cog_ms_ <= kMaxExtrapolationMs;
+  }
+
+  bool has_fix_ = false;
+  int32_t lat_e7_ = 0;
+  int32_t lon_e7_ = 0;
+  float cos_lat_ = 1.0f;
+  uint32_t fix_ms_ = 0;
+  float sog_kn_ = -1.0f;
+  uint32_t sog_ms_ = 0;
+  float cog_deg_ = -1.0f;
+  uint32_t cog_ms_ = 0;
+
+  bool has_heading_ = false;
+  float heading_deg_ = 0.0f;
+  uint32_t heading_ms_ = 0;
+  bool fix_heading_valid_ = false;
+  float fix_heading_deg_ = 0.0f;  // compass heading when the fix arrived
+  bool cog_heading_valid_ = false;
+  float cog_heading_deg_ = 0.0f;  // compass heading when the COG arrived
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_DEAD_RECKONING_H_
@@ -0,0 +1,131 @@
+// src/gateway_metrics.cpp
+//
+// Lock-free AIS/GNSS gateway counters.
+
+#include "gateway_metrics.h"
+
+#include <cstdio>
+
+namespace halmet {
+
+void GatewayMetrics::count_ais(int type, char channel) {
+  if (type >= 0 && type < kAisTypes) inc(ais_types_[type]);
+  Channel ch = (channel == 'A' || channel == '1')   ? kChannelA
+               : (channel == 'B' || channel == '2') ? kChannelB
+                                                    : kChannelOther;
+  inc(ais_channels_[ch]);
+}
+
+void GatewayMetrics::count_send(uint32_t pgn, bool ok) {
+  // Claim a slot for a new PGN with a CAS; slots are never released.
+  for (PgnCounters& slot : pgns_) {
+    uint32_t cur = slot.pgn.load(std::memory_order_relaxed);
+    if (cur == 0) {
+      uint32_t expected = 0;
+      if (!slot.pgn.compare_exchange_strong(expected, pgn,
+                                            std::memory_order_relaxed) &&
+          expected != pgn) {
+        continue;  // another PGN won the slot
+      }
+      cur = pgn;
+    }
+    if (cur == pgn) {
+      inc(ok ? slot.sent : slot.failed);
+      return;
+    }
+  }
+  if (!ok) inc(pgn_overflow_);
+}
+
+uint32_t GatewayMetrics::send_failures() const {
+  uint32_t total = get(pgn_overflow_);
+  for (const PgnCounters& slot : pgns_) total += get(slot.failed);
+  return total;
+}
+
+void GatewayMetrics::record_latency(uint32_t us) {
+  int i = 0;
+  while (i < kLatencyBuckets - 1 && us >= latency_bucket_limit_us(i)) i++;
+  inc(latency_[i]);
+}
+
+uint32_t GatewayMetrics::latency_percentile_us(int pct) const {
+  uint32_t counts[kLatencyBuckets];
+  uint64_t total = 0;
+  for (int i = 0; i < kLatencyBuckets; i++) {
+    counts[i] = get(latency_[i]);
+    total += counts[i];
+  }
+  if (total == 0) return 0;
+  uint64_t rank = (total * pct + 99) / 100;
+  uint64_t seen = 0;
+  for (int i = 0; i < kLatencyBuckets; i++) {
+    seen += counts[i];
+    if (seen >= rank) return latency_bucket_limit_us(i);
+  }
+  return latency_bucket_limit_us(kLatencyBuckets - 1);
+}
+
+// snprintf that appends at *pos and never runs past len. Once something
+// doesn't fit, *pos is parked at len and every later call is a no-op.
+static void append(char* buf, size_t len, size_t* pos, const char* fmt,
+                   unsigned long a = 0, unsigned long b = 0,
+                   unsigned long c = 0) {
+  if (*pos >= len) return;
+  size_t room = len - *pos;
+  int n = snprintf(buf + *pos, room, fmt, a, b, c);
+  *pos = (n < 0 || (size_t)n >= room) ? len : *pos + (size_t)n;
+}
+
+void GatewayMetrics::format_ais_types(char* buf, size_t len) const {
+  size_t pos = 0;
+  buf[0] = '\0';
+  for (int t = 0; t < kAisTypes; t++) {
+    uint32_t n = ais_type(t);
+    if (n) append(buf, len, &pos, pos ? " %lu:%lu" : "%lu:%lu", t, n);
+  }
+}
+
+void GatewayMetrics::format_pgns(char* buf, size_t len) const {
+  size_t pos = 0;
+  buf[0] = '\0';
+  for (int i = 0; i < kPgnSlots && pgn(i); i++) {
+    append(buf, len, &pos, pos ? " %lu:%lu/%lu" : "%lu:%lu/%lu", pgn(i),
+           pgn_failed(i), pgn_sent(i));
+  }
+}
+
+bool GatewayMetrics::to_json(char* buf, size_t len) const {
+  size_t pos = 0;
+  append(buf, len, &pos,
+         "{\"sentences\":{\"vdm\":%lu,\"vdo\":%lu,\"rmc\":%lu,",
+         sentences(kVdm), sentences(kVdo), sentences(kRmc));
+  append(buf, len, &pos, "\"gga\":%lu,\"vtg\":%lu,\"hdt\":%lu,",
+         sentences(kGga), sentences(kVtg), sentences(kHdt));
+  append(buf, len, &pos, "\"zda\":%lu,\"psrt\":%lu,\"other\":%lu},",
+         sentences(kZda), sentences(kPsrt), sentences(kOther));
+  append(buf, len, &pos, "\"checksumErrors\":%lu,", checksum_errors());
+  append(buf, len, &pos, "\"channels\":{\"A\":%lu,\"B\":%lu,\"other\":%lu},",
+         ais_channel(kChannelA), ais_channel(kChannelB),
+         ais_channel(kChannelOther));
+  append(buf, len, &pos, "\"aisTypes\":{");
+  bool first = true;
+  for (int t = 0; t < kAisTypes; t++) {
+    uint32_t n = ais_type(t);
+    if (!n) continue;
+    append(buf, len, &pos, first ? "\"%lu\":%lu" : ",\"%lu\":%lu", t, n);
+    first = false;
+  }
+  append(buf, len, &pos, "},\"pgns\":{");
+  for (int i = 0; i < kPgnSlots && pgn(i); i++) {
+    append(buf, len, &pos, i ? ",\"%lu\":{\"sent\":%lu,\"failed\":%lu}"
+                             : "\"%lu\":{\"sent\":%lu,\"failed\":%lu}",
+           pgn(i), pgn_sent(i), pgn_failed(i));
+  }
+  append(buf, len, &pos, "},\"latencyUs\":{\"p50\":%lu,\"p95\":%lu,\"p99\":%lu}}",
+         latency_percentile_us(50), latency_percentile_us(95),
+         latency_percentile_us(99));
+  return pos < len;
+}
+
+}  // namespace halmet
@@ -0,0 +1,88 @@
+#ifndef HALMET_SRC_GATEWAY_METRICS_H_
+#define HALMET_SRC_GATEWAY_METRICS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace halmet {
+
+/**
+ * @brief Fixed-size, lock-free counters for the AIS/GNSS gateway pipeline.
+ *
+ * Every counter is a relaxed std::atomic, so the parser, the serial
+ * callback and the status/Signal K publishers can touch them from any task
+ * without locks. Nothing is allocated after construction.
+ */
+class GatewayMetrics {
+ public:
+  enum Sentence : uint8_t {
+    kVdm, kVdo, kRmc, kGga, kVtg, kHdt, kZda, kPsrt, kOther, kSentenceKinds
+  };
+  enum Channel : uint8_t { kChannelA, kChannelB, kChannelOther, kChannels };
+
+  static constexpr int kAisTypes = 28;       // message types 0..27
+  static constexpr int kPgnSlots = 16;       // distinct PGNs tracked
+  static constexpr int kLatencyBuckets = 12;  // bucket i: < 16 << i µs
+
+  void count_sentence(Sentence kind) { inc(sentences_[kind]); }
+  void count_checksum_error() { inc(checksum_errors_); }
+  void count_ais(int type, char channel);
+  void count_send(uint32_t pgn, bool ok);
+  void record_latency(uint32_t us);
+
+  uint32_t sentences(Sentence kind) const { return get(sentences_[kind]); }
+  uint32_t checksum_errors() const { return get(checksum_errors_); }
+  uint32_t ais_type(int type) const {
+    return (type >= 0 && type < kAisTypes) ? get(ais_types_[type]) : 0;
+  }
+  uint32_t ais_channel(Channel ch) const { return get(ais_channels_[ch]); }
+
+  // PGN slots in first-seen order; pgn(i) == 0 past the last one used.
+  uint32_t pgn(int i) const { return get(pgns_[i].pgn); }
+  uint32_t pgn_sent(int i) const { return get(pgns_[i].sent); }
+  uint32_t pgn_failed(int i) const { return get(pgns_[i].failed); }
+  uint32_t send_failures() const;
+
+  uint32_t latency_bucket(int i) const { return get(latency_[i]); }
+  static uint32_t latency_bucket_limit_us(int i) { return 16u << i; }
+  // Upper bound (µs) of the bucket holding the pct-th percentile, 0 if
+  // nothing has been recorded.
+  uint32_t latency_percentile_us(int pct) const;
+
+  // Compact text for the status page: "1:120 3:4 18:55" for non-zero AIS
+  // types, "129038:2/5310 ..." (failed/sent) for PGNs.
+  void format_ais_types(char* buf, size_t len) const;
+  void format_pgns(char* buf, size_t len) const;
+
+  // Everything as one JSON object, for Signal K. Returns false if it
+  // didn't fit; kJsonMaxLen always does (every AIS type and PGN slot in
+  // use, every counter at 2^32 - 1).
+  static constexpr size_t kJsonMaxLen = 2048;
+  bool to_json(char* buf, size_t len) const;
+
+ private:
+  using Counter = std::atomic<uint32_t>;
+  static void inc(Counter& c) { c.fetch_add(1, std::memory_order_relaxed); }
+  static uint32_t get(const Counter& c) {
+    return c.load(std::memory_order_relaxed);
+  }
+
+  struct PgnCounters {
+    Counter pgn{0};
+    Counter sent{0};
+    Counter failed{0};
+  };
+
+  Counter sentences_[kSentenceKinds] = {};
+  Counter checksum_errors_{0};
+  Counter ais_types_[kAisTypes] = {};
+  Counter ais_channels_[kChannels] = {};
+  PgnCounters pgns_[kPgnSlots];
+  Counter pgn_overflow_{0};
+  Counter latency_[kLatencyBuckets] = {};
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_GATEWAY_METRICS_H_
@@ -0,0 +1,64 @@
+// src/gnss_timebase.cpp
+//
+// GNSS-disciplined UTC clock.
+
+#include "gnss_timebase.h"
+
+#ifdef ESP_PLATFORM
+#include <esp_timer.h>
+#else
+#include <chrono>
+#endif
+
+namespace halmet {
+
+static constexpr int64_t kUsPerDay = 86400000000LL;
+
+void GnssTimebase::discipline(int64_t utc_us, uint64_t mono_us) {
+  int64_t error = utc_us - ((int64_t)mono_us + offset_us_);
+  if (!valid_ || error > kStepThresholdUs || error < -kStepThresholdUs) {
+    offset_us_ = utc_us - (int64_t)mono_us;
+    valid_ = true;
+    stats_.steps++;
+  } else {
+    offset_us_ += error / 8;
+  }
+  last_reference_us_ = mono_us;
+  stats_.samples++;
+  stats_.last_error_us = (int32_t)(error > INT32_MAX   ? INT32_MAX
+                                   : error < INT32_MIN ? INT32_MIN
+                                                       : error);
+}
+
+uint64_t MonotonicMicros() {
+#ifdef ESP_PLATFORM
+  return (uint64_t)esp_timer_get_time();
+#else
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+GnssTimebase& SystemTimebase() {
+  static GnssTimebase timebase;
+  return timebase;
+}
+
+int32_t DaysFromCivil(int32_t y, uint32_t m, uint32_t d) {
+  y -= m <= 2;
+  int32_t era = (y >= 0 ? y : y - 399) / 400;
+  uint32_t yoe = (uint32_t)(y - era * 400);
+  uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + (int32_t)doe - 719468;
+}
+
+void ToN2kTime(int64_t utc_us, uint16_t* days, double* seconds) {
+  int64_t d = utc_us / kUsPerDay;
+  int64_t rem = utc_us - d * kUsPerDay;
+  *days = (uint16_t)d;
+  *seconds = rem / 1e6;
+}
+
+}  // namespace halmet
@@ -0,0 +1,81 @@
+#ifndef HALMET_SRC_GNSS_TIMEBASE_H_
+#define HALMET_SRC_GNSS_TIMEBASE_H_
+
+#include <cstdint>
+
+namespace halmet {
+
+struct GnssTimebaseStats {
+  uint32_t samples = 0;      // GNSS time references applied
+  uint32_t steps = 0;        // times the clock was set outright
+  int32_t last_error_us = 0;  // reference minus clock, before correction
+};
+
+/**
+ * @brief UTC clock disciplined to GNSS time.
+ *
+ * Keeps an offset between a free-running monotonic microsecond counter
+ * and UTC. Each RMC/ZDA time reference moves the offset 1/8 of the way to
+ * the measured error, smoothing out serial and parse jitter; errors over
+ * kStepThresholdUs (first fix, receiver jumps) set the clock outright.
+ * Between references, and after GNSS is lost, time keeps running on the
+ * monotonic counter.
+ *
+ * Timestamps are aligned to when sentences are parsed, so they trail true
+ * UTC by the receiver's output latency (typically tens to a few hundred
+ * ms) — consistent across subsystems, not a PPS-grade reference.
+ */
+class GnssTimebase {
+ public:
+  static constexpr int64_t kStepThresholdUs = 500000;
+  static constexpr uint64_t kHoldoverUs = 60000000;  // locked() window
+
+  // A GNSS time reference: utc_us (since 1970) was current at mono_us.
+  void discipline(int64_t utc_us, uint64_t mono_us);
+
+  // Set once the first reference has been applied.
+  bool valid() const { return valid_; }
+
+  // Disciplined within the last kHoldoverUs.
+  bool locked(uint64_t mono_us) const {
+    return valid_ && mono_us - last_reference_us_ <= kHoldoverUs;
+  }
+
+  // UTC microseconds since 1970 at mono_us, or 0 before the first fix.
+  int64_t to_utc_us(uint64_t mono_us) const {
+    return valid_ ? (int64_t)mono_us + offset_us_ : 0;
+  }
+
+  const GnssTimebaseStats& stats() const { return stats_; }
+
+ private:
+  bool valid_ = false;
+  int64_t offset_us_ = 0;  // UTC - monotonic
+  uint64_t last_reference_us_ = 0;
+  GnssTimebaseStats stats_;
+};
+
+// Free-running microseconds since boot (esp_timer on the ESP32); never
+// wraps in practice.
+uint64_t MonotonicMicros();
+
+// The firmware-wide timebase, disciplined by the AIS gateway's GNSS
+// sentences.
+GnssTimebase& SystemTimebase();
+
+// Absolute timestamp for a sample taken now: UTC microseconds since 1970,
+// or 0 while GNSS time is unknown.
+inline int64_t UtcMicros() {
+  return SystemTimebase().to_utc_us(MonotonicMicros());
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date.
+int32_t DaysFromCivil(int32_t year, uint32_t month, uint32_t day);
+
+// Split a UTC timestamp into the N2K date/time fields (PGN 126992,
+// 129029): days since 1970 and seconds since midnight.
+void ToN2kTime(int64_t utc_us, uint16_t* days, double* seconds);
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_GNSS_TIMEBASE_H_
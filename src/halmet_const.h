@@ -28,6 +28,12 @@ const int kDigitalInputPin4 = GPIO_NUM_26;
 const int kSerial2RxPin = 16;
 const int kSerial2TxPin = 17;
 
+// ESP32 Serial1 pins (auxiliary NMEA 0183 input, e.g. a GNSS or sounder).
+// GPIO 35 is input-only, which suits a receive line; Serial1's default
+// pins are taken by the module's flash.
+const int kSerial1RxPin = 35;
+const int kSerial1TxPin = 32;
+
 // Test output pin for debugging
 const int kTestOutputPin = GPIO_NUM_33;
 const int kTestOutputFrequency = 380;
@@ -59,7 +59,9 @@ BoolProducer* ConnectAlarmSender(int pin, String name) {
   char config_title[80];
   char config_description[80];
 
-  auto* alarm_input = new DigitalInputState(pin, INPUT_PULLUP, 100);
+  // Alarm edges are sent to N2K as soon as they're read, so the poll
+  // interval is most of the alarm-to-bus latency.
+  auto* alarm_input = new DigitalInputState(pin, INPUT_PULLUP, 20);
 
 #ifdef ENABLE_SIGNALK
   char sk_path[80];
@@ -6,6 +6,8 @@
 #include <map>
 #include <string>
 
+#include "n2k_bus.h"
+#include "n2k_scheduler.h"
 #include "n2k_senders.h"
 #include "sensesp/net/discovery.h"
 #include "sensesp/sensors/analog_input.h"
@@ -27,6 +29,8 @@
 #include "halmet_display.h"
 #include "halmet_serial.h"
 #include "ais_gateway.h"
+#include "gnss_timebase.h"
+#include "nmea0183_tcp_server.h"
 #include "sensesp/net/http_server.h"
 #include "sensesp/net/networking.h"
 #include "SPIFFS.h"
@@ -107,7 +111,7 @@ bool ads1115_1_present = false;
 // Store alarm states in an array for local display output
 bool alarm_states[2] = {false, false};
 bool ais_silent = false;
-extern int ais_msg_count_a, ais_msg_count_b;
+Nmea0183TcpServer* nmea0183_server = nullptr;
 
 // Uptime tracking
 elapsedMillis system_uptime_ms = false;
@@ -264,6 +268,8 @@ void InitializeCompass(Adafruit_BNO055*& bno055) {
 // ========================================================================
 
 void InitializeAISGateway() {
+  // RX buffer must be sized before begin(); 1 KB covers ~250 ms at 38400.
+  Serial2.setRxBufferSize(1024);
   Serial2.begin(38400, SERIAL_8N1, kSerial2RxPin, kSerial2TxPin);
   debugD("Serial2 (AIS) initialized");
 
@@ -281,6 +287,7 @@ void InitializeAISGateway() {
   const char* cmd = ais_silent ?
       "$PSRT,TRG,02,33" : "$PSRT,TRG,02,00";
   AISSendCommand(cmd);
+  AISQueueCommand("$DUAIQ,SRM", "SRM");  // read back the applied mode
   Serial.printf("AIS Silent Mode: %s\n", ais_silent ? "ON" : "OFF");
 
   // Handle AIS silent mode changes
@@ -290,11 +297,188 @@ void InitializeAISGateway() {
       const char* cmd = ais_silent ?
           "$PSRT,TRG,02,33" : "$PSRT,TRG,02,00";
       AISSendCommand(cmd);
+      AISQueueCommand("$DUAIQ,SRM", "SRM");
       last_mode = ais_silent;
       Serial.printf("AIS Silent Mode: %s\n", ais_silent ? "ON" : "OFF");
     }
   });
 
+  // Gateway tuning
+  auto* ais_gateway_config = new AISGatewayConfig("/AIS Gateway");
+  ConfigItem(ais_gateway_config)
+      ->set_title("AIS Gateway")
+      ->set_description("AIS to NMEA 2000 forwarding settings")
+      ->set_sort_order(1001);
+  ais_gateway_config->load();
+  AISGatewayInit(ais_gateway_config);
+
+  // Optional second NMEA 0183 talker merged into the same pipeline
+  if (ais_gateway_config->aux_baud > 0) {
+    Serial1.setRxBufferSize(512);
+    Serial1.begin(ais_gateway_config->aux_baud, SERIAL_8N1, kSerial1RxPin,
+                  kSerial1TxPin);
+    AISGatewayAddPort(Serial1, "Aux",
+                      ais_gateway_config->aux_gnss_preferred ? 0 : 2);
+    debugD("Serial1 (aux NMEA 0183) initialized");
+  }
+
+  // Raw NMEA 0183 for navigation apps on TCP port 10110
+  nmea0183_server = new Nmea0183TcpServer();
+  nmea0183_server->begin();
+  AISGatewaySetLineTap([](const char* line, int len) {
+    nmea0183_server->push(line, len);
+  });
+
+  // Gateway counters, for sizing the reassembly and target tables
+  auto* reasm_completed = new StatusPageItem<int>("Reassembled", 0, "AIS", 1100);
+  auto* reasm_dropped = new StatusPageItem<int>("Fragments Dropped", 0, "AIS", 1101);
+  auto* reasm_timed_out = new StatusPageItem<int>("Reassembly Timeouts", 0, "AIS", 1102);
+  auto* reasm_evicted = new StatusPageItem<int>("Reassembly Evictions", 0, "AIS", 1103);
+  auto* reasm_high_water = new StatusPageItem<int>("Reassembly Slots Peak", 0, "AIS", 1104);
+  auto* bad_sentences = new StatusPageItem<int>("Checksum Errors", 0, "AIS", 1105);
+  auto* targets = new StatusPageItem<int>("Targets", 0, "AIS", 1106);
+  auto* targets_evicted = new StatusPageItem<int>("Target Evictions", 0, "AIS", 1107);
+  auto* static_forwarded = new StatusPageItem<int>("Static Data Sent", 0, "AIS", 1108);
+  auto* static_suppressed = new StatusPageItem<int>("Static Data Suppressed", 0, "AIS", 1109);
+  auto* positions_rate = new StatusPageItem<int>("Position Reports/s", 0, "AIS", 1110);
+  auto* positions_throttled = new StatusPageItem<int>("Positions Throttled", 0, "AIS", 1111);
+  auto* rx_overruns = new StatusPageItem<int>("RX Ring Overruns", 0, "AIS", 1112);
+  auto* rx_high_water = new StatusPageItem<int>("RX Ring Peak", 0, "AIS", 1113);
+  auto* uart_errors = new StatusPageItem<int>("UART Errors", 0, "AIS", 1114);
+  auto* sentences = new StatusPageItem<int>("Sentences", 0, "AIS", 1115);
+  auto* ais_types = new StatusPageItem<String>("AIS Types", "", "AIS", 1116);
+  auto* ais_channels = new StatusPageItem<String>("AIS Channels A/B", "", "AIS", 1117);
+  auto* n2k_pgns = new StatusPageItem<String>("N2K PGN failed/sent", "", "AIS", 1118);
+  auto* n2k_latency = new StatusPageItem<String>("Parse to Send p50/p95 (us)", "", "AIS", 1119);
+  auto* transponder = new StatusPageItem<String>("Transponder", "", "AIS", 1120);
+  auto* command_timeouts = new StatusPageItem<int>("Command Timeouts", 0, "AIS", 1121);
+  auto* tcp_clients = new StatusPageItem<int>("TCP 10110 Clients", 0, "AIS", 1122);
+  auto* tcp_dropped = new StatusPageItem<int>("TCP Lines Dropped", 0, "AIS", 1123);
+  auto* utc_time = new StatusPageItem<String>("GNSS Time (UTC)", "", "AIS", 1124);
+  auto* clock_error = new StatusPageItem<int>("Clock Error (us)", 0, "AIS", 1125);
+  StatusPageItem<String>* port_items[kAISMaxPorts] = {};
+  AISGatewayStats initial = AISGatewayGetStats();
+  for (int i = 0; i < initial.num_ports; i++) {
+    String name = String("Port ") + initial.ports[i].name +
+                  " rx/superseded/lost/errors/max ingest";
+    port_items[i] = new StatusPageItem<String>(name, "", "AIS", 1126 + i);
+  }
+  event_loop()->onRepeat(5000, [=]() {
+    AISGatewayStats st = AISGatewayGetStats();
+    reasm_completed->set(st.reassembly.completed);
+    reasm_dropped->set(st.reassembly.dropped);
+    reasm_timed_out->set(st.reassembly.timed_out);
+    reasm_evicted->set(st.reassembly.evicted);
+    reasm_high_water->set(st.reassembly.high_water);
+    bad_sentences->set(st.bad_sentences);
+    targets->set(st.targets.size);
+    targets_evicted->set(st.targets.evicted);
+    static_forwarded->set(st.static_forwarded);
+    static_suppressed->set(st.static_suppressed);
+    positions_rate->set(st.priority.rate);
+    positions_throttled->set(st.priority.throttled);
+    uint32_t overruns = 0, high_water = 0, errors = 0;
+    for (int i = 0; i < st.num_ports; i++) {
+      const AISInputPortStats& p = st.ports[i];
+      overruns += p.rx_overruns + p.rx_long_lines;
+      high_water = std::max(high_water, p.rx_high_water);
+      errors += p.uart_errors;
+      port_items[i]->set(String(p.sentences) + " / " + String(p.superseded) +
+                         " / " + String(p.rx_overruns + p.rx_long_lines) +
+                         " / " + String(p.uart_errors) + " / " +
+                         String(p.ingest_max_us) + " us");
+    }
+    rx_overruns->set(overruns);
+    rx_high_water->set(high_water);
+    uart_errors->set(errors);
+    // Status is polled every 30 s; two missed rounds means it stopped answering.
+    uint32_t last_reply = st.commands.last_reply_ms;
+    transponder->set(last_reply == 0                   ? String("no reply")
+                     : millis() - last_reply > 65000 ? String("not responding")
+                                                     : String("responding"));
+    command_timeouts->set(st.commands.timeouts);
+    tcp_clients->set(nmea0183_server->clients());
+    tcp_dropped->set(nmea0183_server->stats().lines_dropped);
+
+    const GnssTimebase& timebase = SystemTimebase();
+    if (timebase.valid()) {
+      uint64_t mono_us = MonotonicMicros();
+      time_t t = (time_t)(timebase.to_utc_us(mono_us) / 1000000);
+      struct tm tm;
+      gmtime_r(&t, &tm);
+      char when[40];
+      strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &tm);
+      utc_time->set(String(when) +
+                    (timebase.locked(mono_us) ? "" : " (holdover)"));
+    } else {
+      utc_time->set("no fix");
+    }
+    clock_error->set(timebase.stats().last_error_us);
+
+    const GatewayMetrics& m = AISGatewayMetrics();
+    uint32_t total = 0;
+    for (int k = 0; k < GatewayMetrics::kSentenceKinds; k++) {
+      total += m.sentences((GatewayMetrics::Sentence)k);
+    }
+    sentences->set(total);
+    char buf[160];
+    m.format_ais_types(buf, sizeof(buf));
+    ais_types->set(String(buf));
+    ais_channels->set(String(m.ais_channel(GatewayMetrics::kChannelA)) + " / " +
+                      String(m.ais_channel(GatewayMetrics::kChannelB)));
+    m.format_pgns(buf, sizeof(buf));
+    n2k_pgns->set(String(buf));
+    n2k_latency->set(String(m.latency_percentile_us(50)) + " / " +
+                     String(m.latency_percentile_us(95)));
+  });
+
+#ifdef ENABLE_SIGNALK
+  // Pipeline counters as one JSON object, so a stalled or lossy gateway
+  // shows up in Signal K history.
+  auto* metrics_output = new SKOutputRawJson("sensors.aisGateway.metrics", "");
+  event_loop()->onRepeat(10000, [metrics_output]() {
+    static char json[GatewayMetrics::kJsonMaxLen];
+    if (!AISGatewayMetrics().to_json(json, sizeof(json))) return;
+    metrics_output->set(String(json));
+  });
+
+  // AIS targets under vessels.urn:mrn:imo:mmsi:*, at most one delta per
+  // changed target per second. Held back while the server is unreachable.
+  event_loop()->onRepeat(1000, []() {
+    if (!sensesp_app->get_ws_client()->is_connected()) return;
+    AISGatewayFlushSignalK([](const char* json, size_t) {
+      String delta(json);
+      sensesp_app->get_ws_client()->sendTXT(delta);
+    }, 32);
+  });
+
+  // Collision alarm: raised/updated when the worst target changes, cleared
+  // once no target is on a dangerous closest approach.
+  auto* cpa_notification =
+      new SKOutputRawJson("notifications.navigation.closestApproach", "");
+  event_loop()->onRepeat(1000, [cpa_notification]() {
+    static uint32_t last_mmsi = 0;
+    static int last_count = 0;
+    AisCollisionInfo worst;
+    int count = AISGatewayCollisionStatus(&worst);
+    if (count == last_count && worst.mmsi == last_mmsi) return;
+    last_count = count;
+    last_mmsi = worst.mmsi;
+    char json[192];
+    if (count > 0) {
+      snprintf(json, sizeof(json),
+               "{\"state\":\"alarm\",\"method\":[\"visual\",\"sound\"],"
+               "\"message\":\"AIS %lu CPA %.2f nm in %.1f min (%d dangerous)\"}",
+               (unsigned long)worst.mmsi, worst.cpa_nm, worst.tcpa_min, count);
+    } else {
+      snprintf(json, sizeof(json),
+               "{\"state\":\"normal\",\"method\":[],"
+               "\"message\":\"No dangerous AIS targets\"}");
+    }
+    cpa_notification->set(String(json));
+  });
+#endif
+
   // AISResetFactory();               // factory reset
   // AISSetMMSI(123456789);           // set your MMSI
   // AISSendCommand("$PSRT,TRG,02,00"); // disable silent mode
@@ -344,11 +528,20 @@ void InitializeDisplay() {
           PrintValue(display, 0, "IP", "Not Connected", "");
         }
       } else if (display_state == 2) {
-        // AIS counts
-        extern int ais_msg_count_a, ais_msg_count_b;
-        String ais_a = String(ais_msg_count_a) + "a";
-        String ais_b = String(ais_msg_count_b) + "b";
-        PrintValue(display, 0, "AIS", ais_a, ais_b);
+        // Closest dangerous AIS target, otherwise AIS counts
+        AisCollisionInfo worst;
+        if (AISGatewayCollisionStatus(&worst) > 0) {
+          PrintValue(display, 0, "CPA", String(worst.cpa_nm, 2) + "nm",
+                     String(worst.tcpa_min, 0) + "min");
+        } else {
+          const GatewayMetrics& m = AISGatewayMetrics();
+          uint32_t class_a = m.ais_type(1) + m.ais_type(2) + m.ais_type(3) +
+                             m.ais_type(5) + m.ais_type(27);
+          uint32_t class_b = m.ais_type(18) + m.ais_type(19) + m.ais_type(24);
+          String ais_a = String(class_a) + "a";
+          String ais_b = String(class_b) + "b";
+          PrintValue(display, 0, "AIS", ais_a, ais_b);
+        }
       } else {
         // Uptime
         unsigned long uptime_seconds = system_uptime_ms / 1000;
@@ -577,6 +770,7 @@ void SetupAllSensors(Adafruit_ADS1115* ads1115_0, Adafruit_ADS1115* ads1115_1, b
         }
     );
     heading_sensor->connect_to(new LambdaConsumer<float>([](float v) {
+      AISGatewaySetHeading(v);
       heading_str = String((int)v);
       UpdateHeadingDisplay();
     }));
@@ -593,7 +787,7 @@ void ConnectSensorsToNMEA2000(
   // Rudder angle sender
   N2kRudderSender* rudder_sender = new N2kRudderSender("/NMEA 2000/Rudder", 0, nmea2000);
   a01->connect_to(new sensesp::LambdaTransform<float, double>([](float deg) { return deg * PI / 180.0; }))
-      ->connect_to(rudder_sender->rudder_angle_deg_);
+      ->connect_to(&rudder_sender->rudder_angle_deg_);
 
   // Transmission senders
   N2kTransmissionSender* transmission_1_sender =
@@ -609,7 +803,7 @@ void ConnectSensorsToNMEA2000(
       else if (gear_pos < 0.75f) return 1;  // Neutral
       else return 2;  // Forward
     })
-  )->connect_to(transmission_1_sender->gear_);
+  )->connect_to(&transmission_1_sender->gear_);
 
   a04->connect_to(
     new sensesp::LambdaTransform<float, int>([](float gear_pos) {
@@ -617,7 +811,7 @@ void ConnectSensorsToNMEA2000(
       else if (gear_pos < 0.75f) return 1;  // Neutral
       else return 2;  // Forward
     })
-  )->connect_to(transmission_2_sender->gear_);
+  )->connect_to(&transmission_2_sender->gear_);
 
   // Engine parameter senders (if second ADS1115 is present)
   if (a11 && a13) {
@@ -638,19 +832,35 @@ void ConnectSensorsToNMEA2000(
     // Connect oil pressure sensors
     a11->connect_to(
       new sensesp::LambdaTransform<float, double>([](float psi) { return psi * 6894.76; })
-    )->connect_to(engine_1_dynamic_sender->oil_pressure_);
+    )->connect_to(&engine_1_dynamic_sender->oil_pressure_);
 
     a13->connect_to(
       new sensesp::LambdaTransform<float, double>([](float psi) { return psi * 6894.76; })
-    )->connect_to(engine_2_dynamic_sender->oil_pressure_);
+    )->connect_to(&engine_2_dynamic_sender->oil_pressure_);
 
     // Connect temperature sensors (coolant temperature)
-    a12->connect_to(engine_1_dynamic_sender->temperature_);
-    a14->connect_to(engine_2_dynamic_sender->temperature_);
+    a12->connect_to(&engine_1_dynamic_sender->temperature_);
+    a14->connect_to(&engine_2_dynamic_sender->temperature_);
 
     // Connect alarm sensors
-    d03->connect_to(engine_1_dynamic_sender->low_oil_pressure_);
-    d04->connect_to(engine_2_dynamic_sender->low_oil_pressure_);
+    d03->connect_to(&engine_1_dynamic_sender->low_oil_pressure_);
+    d04->connect_to(&engine_2_dynamic_sender->low_oil_pressure_);
+
+    // Alarm edge to PGN 127489 on the bus, worst of both engines
+    auto* alarm_latency = new StatusPageItem<float>(
+        "Worst Alarm Latency (ms)", 0, "NMEA 2000", 1220);
+    auto* alarm_over = new StatusPageItem<String>(
+        "Alarms sent/over bound", "", "NMEA 2000", 1221);
+    event_loop()->onRepeat(
+        5000, [alarm_latency, alarm_over, engine_1_dynamic_sender,
+               engine_2_dynamic_sender]() {
+          const N2kAlarmStats& s1 = engine_1_dynamic_sender->alarm_stats();
+          const N2kAlarmStats& s2 = engine_2_dynamic_sender->alarm_stats();
+          alarm_latency->set(
+              std::max(s1.max_latency_us, s2.max_latency_us) / 1000.0f);
+          alarm_over->set(String(s1.sent + s2.sent) + " / " +
+                          String(s1.over_bound + s2.over_bound));
+        });
   }
 
   // RPM senders (rapid update)
@@ -663,6 +873,26 @@ void ConnectSensorsToNMEA2000(
   // Connect RPM sensors
   d01->connect_to(&(engine_1_rapid_sender->engine_speed_));
   d02->connect_to(&(engine_2_rapid_sender->engine_speed_));
+
+  // Send-on-change counters, summed over the instances of each PGN
+  static const uint32_t kPolicyPgns[] = {127488, 127489, 127493, 127505};
+  int order = 1210;
+  for (uint32_t pgn : kPolicyPgns) {
+    auto* item = new StatusPageItem<String>(
+        "PGN " + String(pgn) + " change/heartbeat/suppressed", "",
+        "NMEA 2000", order++);
+    event_loop()->onRepeat(5000, [item, pgn]() {
+      N2kTransmitStats sum;
+      for (auto* p = N2kTransmitPolicy::first(); p; p = p->next()) {
+        if (p->pgn() != pgn) continue;
+        sum.on_change += p->stats().on_change;
+        sum.heartbeats += p->stats().heartbeats;
+        sum.suppressed += p->stats().suppressed;
+      }
+      item->set(String(sum.on_change) + " / " + String(sum.heartbeats) +
+                " / " + String(sum.suppressed));
+    });
+  }
 }
 
 // ========================================================================
@@ -679,7 +909,43 @@ void InitializeNMEA2000() {
   nmea2000->SetMode(tNMEA2000::N2km_NodeOnly, 71);
   nmea2000->EnableForward(false);
   nmea2000->Open();
-  event_loop()->onRepeat(1, []() { nmea2000->ParseMessages(); });
+
+  // CAN receive, address claim and ISO requests run in their own task,
+  // woken by the TWAI driver instead of a 1 ms poll of the main loop.
+  N2kBusStart(nmea2000);
+  auto* n2k_task = new StatusPageItem<String>("RX Task Wakeups/s / CPU %", "", "NMEA 2000", 1203);
+  auto* n2k_handle = new StatusPageItem<int>("Worst RX Handling (us)", 0, "NMEA 2000", 1204);
+  auto* n2k_wake = new StatusPageItem<String>("RX Task Wake Source", "", "NMEA 2000", 1206);
+  event_loop()->onRepeat(5000, [=]() {
+    static N2kBusStats prev;
+    N2kBusStats st = N2kBusGetStats();
+    n2k_task->set(String((st.wakeups - prev.wakeups) / 5) + " / " +
+                  String((st.busy_us - prev.busy_us) / 50000.0f, 2));
+    n2k_handle->set(st.max_handle_us);
+    n2k_wake->set(st.alerts ? "TWAI alerts" : "Polling (alert setup failed)");
+    prev = st;
+  });
+
+  // Periodic PGNs from the N2k*Sender classes, phase-spread over a time
+  // wheel so same-rate senders don't hit the bus in the same tick. Nothing
+  // is due between slots, so the main loop is woken once per slot.
+  event_loop()->onRepeat(N2kScheduler::kSlotMs,
+                         []() { n2k_scheduler()->tick(millis()); });
+  auto* n2k_rate = new StatusPageItem<int>("Scheduled Frames/s", 0, "NMEA 2000", 1200);
+  auto* n2k_peak = new StatusPageItem<String>("Peak Frames/10 ms spread/aligned", "", "NMEA 2000", 1201);
+  auto* n2k_late = new StatusPageItem<String>("Late Sends / Worst (ms)", "", "NMEA 2000", 1202);
+  auto* n2k_ticks = new StatusPageItem<int>("Scheduler Wakeups/s", 0, "NMEA 2000", 1205);
+  event_loop()->onRepeat(5000, [=]() {
+    static uint32_t prev_ticks = 0;
+    N2kScheduler* sched = n2k_scheduler();
+    const N2kSchedulerStats& st = sched->stats();
+    n2k_ticks->set((st.ticks - prev_ticks) / 5);
+    prev_ticks = st.ticks;
+    n2k_rate->set(sched->frames_per_second());
+    n2k_peak->set(String(sched->peak_slot_frames()) + " / " +
+                  String(sched->aligned_peak_frames()));
+    n2k_late->set(String(st.late) + " / " + String(st.max_late_ms));
+  });
   debugD("NMEA 2000 initialized");
 }
 
@@ -734,5 +1000,6 @@ void setup() {
 // ========================================================================
 void loop() {
   event_loop()->tick();
-  AISGatewayLoop();               // <-- processes Serial2
+  AISGatewayLoop();               // <-- parses sentences queued from Serial2
+  nmea0183_server->loop();        // <-- sends them on to TCP clients
 }
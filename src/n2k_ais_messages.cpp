@@ -0,0 +1,139 @@
+// src/n2k_ais_messages.cpp
+//
+// Encoders for AIS PGNs the bundled NMEA2000 library doesn't provide.
+// Field order and resolution follow the canboat PGN database.
+
+#include "n2k_ais_messages.h"
+
+namespace halmet {
+
+static void AddAISHeader(tN2kMsg& msg, uint8_t message_id,
+                         tN2kAISRepeat repeat, uint32_t user_id,
+                         double latitude, double longitude) {
+  msg.AddByte((repeat & 0x03) << 6 | (message_id & 0x3f));
+  msg.Add4ByteUInt(user_id);
+  msg.Add4ByteDouble(longitude, 1e-07);
+  msg.Add4ByteDouble(latitude, 1e-07);
+}
+
+// 19-bit communication state (unused, all ones) + 5-bit transceiver info
+static void AddCommStateAndInfo(tN2kMsg& msg,
+                                tN2kAISTransceiverInformation ais_info) {
+  msg.AddByte(0xff);
+  msg.AddByte(0xff);
+  msg.AddByte(((ais_info & 0x1f) << 3) | 0x07);
+}
+
+static void AddAISHeader(tN2kMsg& msg, uint8_t message_id,
+                         tN2kAISRepeat repeat, uint32_t user_id,
+                         int32_t latitude_e7, int32_t longitude_e7) {
+  msg.AddByte((repeat & 0x03) << 6 | (message_id & 0x3f));
+  msg.Add4ByteUInt(user_id);
+  msg.Add4ByteInt(longitude_e7);
+  msg.Add4ByteInt(latitude_e7);
+}
+
+void SetN2kPGN129038(tN2kMsg& msg, uint8_t message_id, tN2kAISRepeat repeat,
+                     uint32_t user_id, int32_t latitude_e7,
+                     int32_t longitude_e7, bool accuracy, bool raim,
+                     uint8_t seconds, uint16_t cog, uint16_t sog,
+                     tN2kAISTransceiverInformation ais_info, uint16_t heading,
+                     int16_t rot, tN2kAISNavStatus nav_status) {
+  msg.SetPGN(129038L);
+  msg.Priority = 4;
+  AddAISHeader(msg, message_id, repeat, user_id, latitude_e7, longitude_e7);
+  msg.AddByte((seconds & 0x3f) << 2 | (raim & 0x01) << 1 | (accuracy & 0x01));
+  msg.Add2ByteUInt(cog);
+  msg.Add2ByteUInt(sog);
+  AddCommStateAndInfo(msg, ais_info);
+  msg.Add2ByteUInt(heading);
+  msg.Add2ByteInt(rot);
+  msg.AddByte(0xf0 | (nav_status & 0x0f));
+  msg.AddByte(0xff);  // Reserved
+}
+
+void SetN2kPGN129039(tN2kMsg& msg, uint8_t message_id, tN2kAISRepeat repeat,
+                     uint32_t user_id, int32_t latitude_e7,
+                     int32_t longitude_e7, bool accuracy, bool raim,
+                     uint8_t seconds, uint16_t cog, uint16_t sog,
+                     tN2kAISTransceiverInformation ais_info, uint16_t heading,
+                     tN2kAISUnit unit, bool display, bool dsc, bool band,
+                     bool msg22, tN2kAISMode mode, bool state) {
+  msg.SetPGN(129039L);
+  msg.Priority = 4;
+  AddAISHeader(msg, message_id, repeat, user_id, latitude_e7, longitude_e7);
+  msg.AddByte((seconds & 0x3f) << 2 | (raim & 0x01) << 1 | (accuracy & 0x01));
+  msg.Add2ByteUInt(cog);
+  msg.Add2ByteUInt(sog);
+  AddCommStateAndInfo(msg, ais_info);
+  msg.Add2ByteUInt(heading);
+  msg.AddByte(0xff);  // Regional application
+  msg.AddByte((mode & 0x01) << 7 | (msg22 & 0x01) << 6 | (band & 0x01) << 5 |
+              (dsc & 0x01) << 4 | (display & 0x01) << 3 | (unit & 0x01) << 2 |
+              0x03);
+  msg.AddByte(0xfe | (state & 0x01));
+}
+
+void SetN2kPGN129040(tN2kMsg& msg, uint8_t message_id, tN2kAISRepeat repeat,
+                     uint32_t user_id, double latitude, double longitude,
+                     bool accuracy, bool raim, uint8_t seconds, double cog,
+                     double sog, double heading, uint8_t ship_type,
+                     double length, double beam, double pos_ref_stbd,
+                     double pos_ref_bow, const char* name, bool dte,
+                     bool assigned, tN2kGNSStype gnss_type,
+                     tN2kAISTransceiverInformation ais_info) {
+  msg.SetPGN(129040L);
+  msg.Priority = 4;
+  AddAISHeader(msg, message_id, repeat, user_id, latitude, longitude);
+  msg.AddByte((seconds & 0x3f) << 2 | (raim & 0x01) << 1 | (accuracy & 0x01));
+  msg.Add2ByteUDouble(cog, 1e-04);
+  msg.Add2ByteUDouble(sog, 0.01);
+  msg.AddByte(0xff);  // Regional application
+  msg.AddByte(0xff);  // Regional application B + reserved
+  msg.AddByte(ship_type);
+  msg.Add2ByteUDouble(heading, 1e-04);
+  msg.AddByte((gnss_type & 0x0f) << 4 | 0x0f);
+  msg.Add2ByteUDouble(length, 0.1);
+  msg.Add2ByteUDouble(beam, 0.1);
+  msg.Add2ByteUDouble(pos_ref_stbd, 0.1);
+  msg.Add2ByteUDouble(pos_ref_bow, 0.1);
+  msg.AddStr(name, 20);
+  msg.AddByte((assigned & 0x01) << 1 | (dte & 0x01) | 0xfc);
+  msg.AddByte((ais_info & 0x1f) | 0xe0);
+}
+
+void SetN2kPGN129793(tN2kMsg& msg, uint8_t message_id, tN2kAISRepeat repeat,
+                     uint32_t user_id, double latitude, double longitude,
+                     bool accuracy, bool raim, double seconds_since_midnight,
+                     uint16_t days_since_1970, tN2kGNSStype gnss_type,
+                     tN2kAISTransceiverInformation ais_info) {
+  msg.SetPGN(129793L);
+  msg.Priority = 7;
+  AddAISHeader(msg, message_id, repeat, user_id, latitude, longitude);
+  msg.AddByte((raim & 0x01) << 1 | (accuracy & 0x01) | 0xfc);
+  msg.Add4ByteUDouble(seconds_since_midnight, 0.0001);
+  AddCommStateAndInfo(msg, ais_info);
+  msg.Add2ByteUInt(days_since_1970);
+  msg.AddByte((gnss_type & 0x0f) << 4 | 0x0f);
+  msg.AddByte(0xff);  // Spare
+}
+
+void SetN2kPGN129798(tN2kMsg& msg, uint8_t message_id, tN2kAISRepeat repeat,
+                     uint32_t user_id, double latitude, double longitude,
+                     bool accuracy, bool raim, uint8_t seconds, double cog,
+                     double sog, double altitude, bool dte,
+                     tN2kAISTransceiverInformation ais_info) {
+  msg.SetPGN(129798L);
+  msg.Priority = 4;
+  AddAISHeader(msg, message_id, repeat, user_id, latitude, longitude);
+  msg.AddByte((seconds & 0x3f) << 2 | (raim & 0x01) << 1 | (accuracy & 0x01));
+  msg.Add2ByteUDouble(cog, 1e-04);
+  msg.Add2ByteUDouble(sog, 0.01);
+  AddCommStateAndInfo(msg, ais_info);
+  msg.Add8ByteDouble(altitude, 1e-06);
+  msg.AddByte(0xff);  // Regional application
+  msg.AddByte((dte & 0x01) | 0xfe);
+  msg.AddByte(0xff);  // Reserved
+}
+
+}  // namespace halmet
@@ -0,0 +1,67 @@
+#ifndef HALMET_SRC_N2K_AIS_MESSAGES_H_
+#define HALMET_SRC_N2K_AIS_MESSAGES_H_
+
+#include <N2kMessages.h>
+#include <N2kMsg.h>
+
+namespace halmet {
+
+// ========================================================================
+// AIS PGNs MISSING FROM THE BUNDLED NMEA2000 LIBRARY
+//
+// Encoded field by field with the same tN2kMsg primitives the library's
+// own SetN2kPGN* functions use. Angles in radians, speeds in m/s,
+// distances in metres, N2kDoubleNA for unavailable values.
+// ========================================================================
+
+// ------------------------------------------------------------------------
+// Integer-unit variants of the library's 129038 / 129039, fed straight
+// from n2k_fixed_point.h conversions: lat/lon in 1e-7 degree, COG and
+// heading in 1e-4 rad, SOG in 0.01 m/s, ROT in 3.125e-5 rad/s, with the
+// library's NA codes for unavailable values.
+// ------------------------------------------------------------------------
+
+// PGN 129038 — AIS Class A Position Report (Types 1, 2, 3, 27)
+void SetN2kPGN129038(tN2kMsg& msg, uint8_t message_id, tN2kAISRepeat repeat,
+                     uint32_t user_id, int32_t latitude_e7,
+                     int32_t longitude_e7, bool accuracy, bool raim,
+                     uint8_t seconds, uint16_t cog, uint16_t sog,
+                     tN2kAISTransceiverInformation ais_info, uint16_t heading,
+                     int16_t rot, tN2kAISNavStatus nav_status);
+
+// PGN 129039 — AIS Class B CS Position Report (Type 18)
+void SetN2kPGN129039(tN2kMsg& msg, uint8_t message_id, tN2kAISRepeat repeat,
+                     uint32_t user_id, int32_t latitude_e7,
+                     int32_t longitude_e7, bool accuracy, bool raim,
+                     uint8_t seconds, uint16_t cog, uint16_t sog,
+                     tN2kAISTransceiverInformation ais_info, uint16_t heading,
+                     tN2kAISUnit unit, bool display, bool dsc, bool band,
+                     bool msg22, tN2kAISMode mode, bool state);
+
+// PGN 129040 — AIS Class B Extended Position Report (Type 19)
+void SetN2kPGN129040(tN2kMsg& msg, uint8_t message_id, tN2kAISRepeat repeat,
+                     uint32_t user_id, double latitude, double longitude,
+                     bool accuracy, bool raim, uint8_t seconds, double cog,
+                     double sog, double heading, uint8_t ship_type,
+                     double length, double beam, double pos_ref_stbd,
+                     double pos_ref_bow, const char* name, bool dte,
+                     bool assigned, tN2kGNSStype gnss_type,
+                     tN2kAISTransceiverInformation ais_info);
+
+// PGN 129793 — AIS UTC and Date Report (Type 4, base station)
+void SetN2kPGN129793(tN2kMsg& msg, uint8_t message_id, tN2kAISRepeat repeat,
+                     uint32_t user_id, double latitude, double longitude,
+                     bool accuracy, bool raim, double seconds_since_midnight,
+                     uint16_t days_since_1970, tN2kGNSStype gnss_type,
+                     tN2kAISTransceiverInformation ais_info);
+
+// PGN 129798 — AIS SAR Aircraft Position Report (Type 9)
+void SetN2kPGN129798(tN2kMsg& msg, uint8_t message_id, tN2kAISRepeat repeat,
+                     uint32_t user_id, double latitude, double longitude,
+                     bool accuracy, bool raim, uint8_t seconds, double cog,
+                     double sog, double altitude, bool dte,
+                     tN2kAISTransceiverInformation ais_info);
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_N2K_AIS_MESSAGES_H_
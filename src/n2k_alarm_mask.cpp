@@ -0,0 +1,51 @@
+// src/n2k_alarm_mask.cpp
+//
+// Packed alarm bits with expiry, latching and edge-triggered sends.
+
+#include "n2k_alarm_mask.h"
+
+namespace halmet {
+
+void N2kAlarmMask::set(int bit, bool on, uint32_t now_ms, uint32_t now_us) {
+  uint32_t mask = 1u << bit;
+  updated_ms_[bit] = now_ms;
+  if (!on) {
+    state_ &= ~mask;
+  } else if (!(bits() & mask)) {
+    state_ |= mask;
+    latched_ |= mask;
+    latched_ms_[bit] = now_ms;
+    stats_.edges++;
+    if (!edge_pending_) {
+      edge_pending_ = true;
+      edge_us_ = now_us;
+    }
+  } else {
+    state_ |= mask;
+  }
+  // Send, or retry a send that didn't get onto the bus yet
+  if (edge_pending_ && on_edge_) on_edge_();
+}
+
+void N2kAlarmMask::sweep(uint32_t now_ms) {
+  uint32_t live = state_ | latched_;
+  while (live) {
+    int bit = __builtin_ctz(live);
+    uint32_t mask = 1u << bit;
+    live &= ~mask;
+    if (now_ms - updated_ms_[bit] > max_age_ms_) state_ &= ~mask;
+    if (now_ms - latched_ms_[bit] >= latch_ms_) latched_ &= ~mask;
+  }
+}
+
+void N2kAlarmMask::sent(uint32_t now_us) {
+  if (!edge_pending_) return;
+  edge_pending_ = false;
+  uint32_t latency = now_us - edge_us_;
+  stats_.sent++;
+  stats_.last_latency_us = latency;
+  if (latency > stats_.max_latency_us) stats_.max_latency_us = latency;
+  if (latency > latency_bound_us_) stats_.over_bound++;
+}
+
+}  // namespace halmet
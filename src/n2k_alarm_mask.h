@@ -0,0 +1,92 @@
+#ifndef HALMET_SRC_N2K_ALARM_MASK_H_
+#define HALMET_SRC_N2K_ALARM_MASK_H_
+
+#include <Arduino.h>
+
+#include <cstdint>
+#include <functional>
+
+#include "sensesp/system/valueconsumer.h"
+
+namespace halmet {
+
+struct N2kAlarmStats {
+  uint32_t edges = 0;           // alarm rising edges seen
+  uint32_t sent = 0;            // edges that reached the bus
+  uint32_t over_bound = 0;      // ... later than the latency bound
+  uint32_t last_latency_us = 0; // edge to SendMsg() for the latest edge
+  uint32_t max_latency_us = 0;
+};
+
+/**
+ * @brief Packed discrete alarm state with per-bit expiry and latching.
+ *
+ * Up to 32 alarm inputs share one word; bit positions are chosen by the
+ * owner (the engine sender uses the PGN 127489 status word layout). Each
+ * bit expires if its input stops reporting for max_age_ms, and a bit that
+ * rises stays asserted for at least latch_ms so a short alarm still shows
+ * in the periodic transmissions that follow.
+ *
+ * A rising edge calls the edge handler at once, which is expected to send
+ * the PGN out of schedule and report back through sent(). Until it does,
+ * every further input update retries the handler. Latency is measured
+ * from the update that raised the bit to the successful send.
+ */
+class N2kAlarmMask {
+ public:
+  using EdgeHandler = std::function<void()>;
+
+  N2kAlarmMask(uint32_t max_age_ms, uint32_t latch_ms)
+      : max_age_ms_{max_age_ms}, latch_ms_{latch_ms} {}
+
+  void on_edge(EdgeHandler handler) { on_edge_ = handler; }
+  void set_latency_bound(uint32_t ms) { latency_bound_us_ = ms * 1000; }
+  uint32_t latency_bound_ms() const { return latency_bound_us_ / 1000; }
+
+  void set(int bit, bool on, uint32_t now_ms, uint32_t now_us);
+
+  // Expire silent inputs and release latches. Call before reading bits().
+  void sweep(uint32_t now_ms);
+
+  // Asserted bits: inputs that are on, plus latched ones
+  uint32_t bits() const { return state_ | latched_; }
+
+  // Tell the mask the current bits() went out on the bus.
+  void sent(uint32_t now_us);
+  // A rising edge hasn't been sent yet
+  bool edge_pending() const { return edge_pending_; }
+
+  const N2kAlarmStats& stats() const { return stats_; }
+
+ private:
+  uint32_t state_ = 0;
+  uint32_t latched_ = 0;
+  uint32_t updated_ms_[32] = {};
+  uint32_t latched_ms_[32] = {};
+  uint32_t max_age_ms_;
+  uint32_t latch_ms_;
+
+  bool edge_pending_ = false;
+  uint32_t edge_us_ = 0;
+  uint32_t latency_bound_us_ = 50000;
+  EdgeHandler on_edge_;
+  N2kAlarmStats stats_;
+};
+
+/**
+ * @brief One alarm input of an N2kAlarmMask, for connect_to().
+ */
+class N2kAlarm : public sensesp::ValueConsumer<bool> {
+ public:
+  N2kAlarm(N2kAlarmMask& mask, int bit) : mask_{mask}, bit_{(uint8_t)bit} {}
+
+  void set(const bool& on) override { mask_.set(bit_, on, millis(), micros()); }
+
+ private:
+  N2kAlarmMask& mask_;
+  uint8_t bit_;
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_N2K_ALARM_MASK_H_
@@ -0,0 +1,115 @@
+// src/n2k_bus.cpp
+//
+// NMEA 2000 receive task and the shared send path.
+//
+// The RX task blocks in twai_read_alerts() until the TWAI driver reports
+// a received frame, then runs the library's ParseMessages(). Both it and
+// every sender go through one mutex: the library's send buffer, address
+// claim state and device list aren't safe to touch from two tasks.
+//
+// If the CAN driver wasn't installed through ESP-IDF's TWAI driver (so
+// alerts can't be enabled), the task falls back to parsing every tick,
+// which still keeps the protocol off the main loop.
+
+#include "n2k_bus.h"
+
+#include <Arduino.h>
+#include <driver/twai.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <atomic>
+
+#include "sensesp/system/local_debug.h"
+
+namespace halmet {
+
+// Parse at least this often without traffic: address-claim timers and
+// frames left in the library's send buffer are serviced from here.
+static constexpr uint32_t kIdleParseMs = 10;
+static constexpr uint32_t kTaskStack = 4096;
+static constexpr UBaseType_t kTaskPriority = 5;  // above loopTask (1)
+static constexpr BaseType_t kTaskCore = 0;       // main loop runs on 1
+
+static tNMEA2000* s_nmea2000 = nullptr;
+static SemaphoreHandle_t s_lock = nullptr;
+static bool s_alerts = false;
+
+// Written by the RX task, read by the main loop.
+static std::atomic<uint32_t> s_wakeups{0};
+static std::atomic<uint32_t> s_rx_wakeups{0};
+static std::atomic<uint32_t> s_busy_us{0};
+static std::atomic<uint32_t> s_max_handle_us{0};
+
+// ----------------------------------------------------------------
+// RX TASK
+// ----------------------------------------------------------------
+
+static void N2kBusTask(void*) {
+  for (;;) {
+    bool rx = false;
+    if (s_alerts) {
+      uint32_t alerts = 0;
+      if (twai_read_alerts(&alerts, pdMS_TO_TICKS(kIdleParseMs)) == ESP_OK) {
+        rx = alerts & TWAI_ALERT_RX_DATA;
+      }
+    } else {
+      vTaskDelay(1);
+    }
+
+    uint32_t woke_us = micros();
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    uint32_t start_us = micros();
+    s_nmea2000->ParseMessages();
+    xSemaphoreGive(s_lock);
+    uint32_t done_us = micros();
+
+    s_wakeups.fetch_add(1, std::memory_order_relaxed);
+    s_busy_us.fetch_add(done_us - start_us, std::memory_order_relaxed);
+    if (rx) {
+      s_rx_wakeups.fetch_add(1, std::memory_order_relaxed);
+      uint32_t handle_us = done_us - woke_us;
+      if (handle_us > s_max_handle_us.load(std::memory_order_relaxed)) {
+        s_max_handle_us.store(handle_us, std::memory_order_relaxed);
+      }
+    }
+  }
+}
+
+void N2kBusStart(tNMEA2000* nmea2000) {
+  if (s_nmea2000) return;
+  s_nmea2000 = nmea2000;
+  s_lock = xSemaphoreCreateMutex();
+  s_alerts = twai_reconfigure_alerts(TWAI_ALERT_RX_DATA | TWAI_ALERT_TX_IDLE,
+                                     nullptr) == ESP_OK;
+  if (!s_alerts) {
+    debugE("TWAI alerts unavailable, N2k RX task polls every tick");
+  }
+  xTaskCreatePinnedToCore(N2kBusTask, "n2k_rx", kTaskStack, nullptr,
+                          kTaskPriority, nullptr, kTaskCore);
+}
+
+// ----------------------------------------------------------------
+// SENDING
+// ----------------------------------------------------------------
+
+bool N2kBusSend(tNMEA2000* nmea2000, const tN2kMsg& msg) {
+  if (!s_lock) return nmea2000->SendMsg(msg);
+  xSemaphoreTake(s_lock, portMAX_DELAY);
+  bool ok = nmea2000->SendMsg(msg);
+  xSemaphoreGive(s_lock);
+  return ok;
+}
+
+N2kBusStats N2kBusGetStats() {
+  N2kBusStats stats;
+  stats.wakeups = s_wakeups.load(std::memory_order_relaxed);
+  stats.rx_wakeups = s_rx_wakeups.load(std::memory_order_relaxed);
+  stats.busy_us = s_busy_us.load(std::memory_order_relaxed);
+  stats.max_handle_us = s_max_handle_us.load(std::memory_order_relaxed);
+  stats.alerts = s_alerts;
+  return stats;
+}
+
+}  // namespace halmet
@@ -0,0 +1,39 @@
+#ifndef HALMET_SRC_N2K_BUS_H_
+#define HALMET_SRC_N2K_BUS_H_
+
+#include <NMEA2000.h>
+
+#include <cstdint>
+
+namespace halmet {
+
+struct N2kBusStats {
+  uint32_t wakeups = 0;       // RX task passes
+  uint32_t rx_wakeups = 0;    // ... woken by a received frame
+  uint32_t busy_us = 0;       // total time in ParseMessages(), wraps
+  uint32_t max_handle_us = 0; // worst wake to ParseMessages() done
+  bool alerts = false;        // woken by TWAI alerts, not polled per tick
+};
+
+/**
+ * @brief Run CAN receive and the NMEA 2000 protocol in their own task.
+ *
+ * Call once, after nmea2000->Open(). The task sleeps in the TWAI driver
+ * until a frame arrives (or kIdleParseMs passes, for the library's
+ * timers and queued transmits) and then calls ParseMessages(), so
+ * address claims and ISO requests are answered without waiting for the
+ * main loop. The device is a node only: nothing here consumes other
+ * devices' PGNs, so the library's message handler is left unset.
+ *
+ * Once started, the library is shared between two tasks: every send must
+ * go through N2kBusSend(), which holds the same lock as the RX task.
+ */
+void N2kBusStart(tNMEA2000* nmea2000);
+
+bool N2kBusSend(tNMEA2000* nmea2000, const tN2kMsg& msg);
+
+N2kBusStats N2kBusGetStats();
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_N2K_BUS_H_
@@ -0,0 +1,84 @@
+#ifndef HALMET_SRC_N2K_FIXED_POINT_H_
+#define HALMET_SRC_N2K_FIXED_POINT_H_
+
+#include <N2kMsg.h>
+
+#include <cstdint>
+
+namespace halmet {
+
+// ========================================================================
+// INTEGER UNIT CONVERSIONS
+//
+// The ESP32 FPU is single precision; every double operation is emulated.
+// These convert the integer units AIS and NMEA 0183 deliver straight to
+// the integer units N2K carries, rounding half away from zero exactly as
+// the library's Add*Double() does, so the output is byte-identical to the
+// double path (or the correctly rounded value where the old float
+// intermediate was off by one).
+//
+//   latitude/longitude  1e-7 degree      (int32, N2kInt32NA)
+//   COG / heading       1e-4 radian      (uint16, N2kUInt16NA)
+//   SOG                 0.01 m/s         (uint16, N2kUInt16NA)
+// ========================================================================
+
+inline int64_t DivRoundAway(int64_t num, int64_t den) {
+  return num >= 0 ? (num + den / 2) / den : -((-num + den / 2) / den);
+}
+
+// Out-of-range values saturate to the "out of range" code like the library.
+inline uint16_t ToN2kUInt16(int64_t v) {
+  return (v >= 0 && v < N2kUInt16OR) ? (uint16_t)v : N2kUInt16OR;
+}
+
+// AIS 1/10000 minute → 1e-7 degree (× 1e7 / 600000 = × 50 / 3). Callers
+// map the 181° / 91° "not available" sentinels to N2kInt32NA first.
+inline int32_t AisCoordToE7(int32_t raw) {
+  return (int32_t)DivRoundAway((int64_t)raw * 50, 3);
+}
+
+// AIS 1/10 minute (Type 27) → 1e-7 degree
+inline int32_t AisLongRangeCoordToE7(int32_t raw) {
+  return (int32_t)DivRoundAway((int64_t)raw * 50000, 3);
+}
+
+// AIS SOG in 1/10 knot (1023 = N/A) → 0.01 m/s
+inline uint16_t AisSogToN2k(uint32_t tenths_kn) {
+  return tenths_kn >= 1023
+             ? N2kUInt16NA
+             : ToN2kUInt16(DivRoundAway((int64_t)tenths_kn * 514444, 100000));
+}
+
+// AIS COG in 1/10 degree (≥ 3600 = N/A) → 1e-4 rad
+inline uint16_t AisCogToN2k(uint32_t tenths_deg) {
+  return tenths_deg >= 3600
+             ? N2kUInt16NA
+             : ToN2kUInt16(DivRoundAway((int64_t)tenths_deg * 17453292520LL,
+                                        1000000000LL));
+}
+
+// Whole degrees (≥ 360 = N/A, covers AIS heading 511) → 1e-4 rad
+inline uint16_t DegreesToN2k(uint32_t deg) {
+  return deg >= 360 ? N2kUInt16NA
+                    : ToN2kUInt16(DivRoundAway((int64_t)deg * 17453292520LL,
+                                               100000000LL));
+}
+
+// Whole knots (Type 27) → 0.01 m/s
+inline uint16_t KnotsToN2k(uint32_t kn) {
+  return ToN2kUInt16(DivRoundAway((int64_t)kn * 514444, 10000));
+}
+
+// NMEA 0183 hundredths of a knot → 0.01 m/s
+inline uint16_t KnotsHundredthsToN2k(int32_t c) {
+  return ToN2kUInt16(DivRoundAway((int64_t)c * 514444, 1000000));
+}
+
+// NMEA 0183 hundredths of a degree → 1e-4 rad
+inline uint16_t DegreesHundredthsToN2k(int32_t c) {
+  return ToN2kUInt16(DivRoundAway((int64_t)c * 17453292520LL, 10000000000LL));
+}
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_N2K_FIXED_POINT_H_
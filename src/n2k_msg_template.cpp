@@ -0,0 +1,69 @@
+// src/n2k_msg_template.cpp
+//
+// In-place field patching of pre-encoded sender PGNs.
+
+#include "n2k_msg_template.h"
+
+namespace halmet {
+
+void N2kMsgTemplate::field(int param, uint8_t offset, N2kField type,
+                           double resolution) {
+  if (num_fields_ == kMaxFields) return;
+  fields_[num_fields_++] = {(uint8_t)param, offset, type, resolution};
+  field_mask_ |= 1ull << param;
+}
+
+const tN2kMsg& N2kMsgTemplate::update(N2kParamStore& params) {
+  uint64_t changed = params.take_changed() & (field_mask_ | rebuild_mask_);
+  if (!encoded_ || (changed & rebuild_mask_)) {
+    msg_.Clear();
+    encoder_(msg_);
+    encoded_ = true;
+    stats_.encodes++;
+  } else if (changed) {
+    for (int i = 0; i < num_fields_; i++) {
+      if ((changed >> fields_[i].param) & 1) patch(fields_[i], params);
+    }
+    stats_.patches++;
+  } else {
+    stats_.reuses++;
+  }
+  return msg_;
+}
+
+// Same bytes as the tN2kMsg::Add* call, including the not-available
+// values it substitutes.
+void N2kMsgTemplate::patch(const Field& f, const N2kParamStore& params) {
+  bool valid = params.valid(f.param);
+  double value = params.value(f.param);
+  int index = f.offset;
+  switch (f.type) {
+    case N2kField::kInt8:
+      msg_.Data[index] = valid ? (uint8_t)(int8_t)(int)value : N2kInt8NA;
+      break;
+    case N2kField::kDouble2:
+      if (valid) {
+        SetBuf2ByteDouble(value, f.resolution, index, msg_.Data);
+      } else {
+        set_uint16(f.offset, (uint16_t)N2kInt16NA);
+      }
+      break;
+    case N2kField::kUDouble2:
+      if (valid) {
+        SetBuf2ByteUDouble(value, f.resolution, index, msg_.Data);
+      } else {
+        set_uint16(f.offset, N2kUInt16NA);
+      }
+      break;
+    case N2kField::kUDouble4:
+      if (valid) {
+        SetBuf4ByteUDouble(value, f.resolution, index, msg_.Data);
+      } else {
+        set_uint16(f.offset, 0xffff);
+        set_uint16(f.offset + 2, 0xffff);
+      }
+      break;
+  }
+}
+
+}  // namespace halmet
@@ -0,0 +1,91 @@
+#ifndef HALMET_SRC_N2K_MSG_TEMPLATE_H_
+#define HALMET_SRC_N2K_MSG_TEMPLATE_H_
+
+#include <N2kMsg.h>
+
+#include <cstdint>
+#include <functional>
+
+#include "n2k_param_table.h"
+
+namespace halmet {
+
+// Wire encodings of patchable fields, named after the tN2kMsg::Add*
+// call that writes them.
+enum class N2kField : uint8_t {
+  kInt8,      // AddByte of an int8_t
+  kDouble2,   // Add2ByteDouble
+  kUDouble2,  // Add2ByteUDouble
+  kUDouble4,  // Add4ByteUDouble
+};
+
+struct N2kMsgTemplateStats {
+  uint32_t encodes = 0;  // full SetN2k* runs
+  uint32_t patches = 0;  // messages updated field by field
+  uint32_t reuses = 0;   // messages sent again unchanged
+};
+
+/**
+ * @brief Pre-encoded PGN kept between sends and patched in place.
+ *
+ * The encoder (a SetN2k* call) runs once to lay out the message. After
+ * that, update() looks at which parameters changed since the last call:
+ * none, and the stored message goes out as is; only fields registered
+ * with field(), and just their bytes are rewritten at their offsets.
+ * A parameter marked rebuild_on(), e.g. one packed into a bitfield with
+ * constants, re-runs the encoder; parameters that are neither are not in
+ * the message and are ignored. invalidate() forces a re-encode after a
+ * configuration change.
+ *
+ * Offsets are byte positions in tN2kMsg::Data as the NMEA2000 library's
+ * encoder writes them.
+ */
+class N2kMsgTemplate {
+ public:
+  static constexpr int kMaxFields = 12;
+
+  using Encoder = std::function<void(tN2kMsg&)>;
+
+  explicit N2kMsgTemplate(Encoder encoder) : encoder_{encoder} {}
+
+  void field(int param, uint8_t offset, N2kField type,
+             double resolution = 1);
+  void rebuild_on(int param) { rebuild_mask_ |= 1ull << param; }
+  void invalidate() { encoded_ = false; }
+
+  // Bring the message up to date with params and return it.
+  const tN2kMsg& update(N2kParamStore& params);
+
+  // Bytes the sender fills in itself, e.g. a SID or status word. Call
+  // after update().
+  void set_byte(uint8_t offset, uint8_t value) { msg_.Data[offset] = value; }
+  void set_uint16(uint8_t offset, uint16_t value) {
+    msg_.Data[offset] = value & 0xff;
+    msg_.Data[offset + 1] = value >> 8;
+  }
+
+  const N2kMsgTemplateStats& stats() const { return stats_; }
+
+ private:
+  struct Field {
+    uint8_t param;
+    uint8_t offset;
+    N2kField type;
+    double resolution;
+  };
+
+  void patch(const Field& f, const N2kParamStore& params);
+
+  Encoder encoder_;
+  tN2kMsg msg_;
+  bool encoded_ = false;
+  Field fields_[kMaxFields];
+  int num_fields_ = 0;
+  uint64_t field_mask_ = 0;
+  uint64_t rebuild_mask_ = 0;
+  N2kMsgTemplateStats stats_;
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_N2K_MSG_TEMPLATE_H_
@@ -0,0 +1,41 @@
+// src/n2k_nav_messages.cpp
+//
+// Integer-unit encoders for own-vessel navigation PGNs.
+
+#include "n2k_nav_messages.h"
+
+namespace halmet {
+
+void SetN2kPGN129025(tN2kMsg& msg, int32_t latitude_e7,
+                     int32_t longitude_e7) {
+  msg.SetPGN(129025L);
+  msg.Priority = 2;
+  msg.Add4ByteInt(latitude_e7);
+  msg.Add4ByteInt(longitude_e7);
+}
+
+void SetN2kPGN129026(tN2kMsg& msg, uint8_t sid, tN2kHeadingReference ref,
+                     uint16_t cog, uint16_t sog) {
+  msg.SetPGN(129026L);
+  msg.Priority = 2;
+  msg.AddByte(sid);
+  msg.AddByte((ref & 0x03) | 0xfc);
+  msg.Add2ByteUInt(cog);
+  msg.Add2ByteUInt(sog);
+  msg.AddByte(0xff);  // Reserved
+  msg.AddByte(0xff);  // Reserved
+}
+
+void SetN2kPGN127250(tN2kMsg& msg, uint8_t sid, uint16_t heading,
+                     int16_t deviation, int16_t variation,
+                     tN2kHeadingReference ref) {
+  msg.SetPGN(127250L);
+  msg.Priority = 2;
+  msg.AddByte(sid);
+  msg.Add2ByteUInt(heading);
+  msg.Add2ByteInt(deviation);
+  msg.Add2ByteInt(variation);
+  msg.AddByte((ref & 0x03) | 0xfc);
+}
+
+}  // namespace halmet
@@ -0,0 +1,31 @@
+#ifndef HALMET_SRC_N2K_NAV_MESSAGES_H_
+#define HALMET_SRC_N2K_NAV_MESSAGES_H_
+
+#include <N2kMessages.h>
+#include <N2kMsg.h>
+
+namespace halmet {
+
+// ========================================================================
+// OWN-VESSEL NAVIGATION PGNs IN INTEGER UNITS
+//
+// Same wire format as the library's SetN2kPGN* functions, but fed the
+// integer units from n2k_fixed_point.h so no double math is needed.
+// ========================================================================
+
+// PGN 129025 — Position, Rapid Update. lat/lon in 1e-7 degree.
+void SetN2kPGN129025(tN2kMsg& msg, int32_t latitude_e7, int32_t longitude_e7);
+
+// PGN 129026 — COG & SOG, Rapid Update. cog in 1e-4 rad, sog in 0.01 m/s.
+void SetN2kPGN129026(tN2kMsg& msg, uint8_t sid, tN2kHeadingReference ref,
+                     uint16_t cog, uint16_t sog);
+
+// PGN 127250 — Vessel Heading. heading in 1e-4 rad; deviation and
+// variation in signed 1e-4 rad, N2kInt16NA when unknown.
+void SetN2kPGN127250(tN2kMsg& msg, uint8_t sid, uint16_t heading,
+                     int16_t deviation, int16_t variation,
+                     tN2kHeadingReference ref);
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_N2K_NAV_MESSAGES_H_
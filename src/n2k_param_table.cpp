@@ -0,0 +1,18 @@
+// src/n2k_param_table.cpp
+//
+// Expiry sweep for the per-PGN sender input tables.
+
+#include "n2k_param_table.h"
+
+namespace halmet {
+
+void N2kParamStore::sweep(uint32_t now_ms) {
+  uint64_t valid = valid_;
+  for (int i = 0; i < size_; i++) {
+    if (now_ms - updated_ms_[i] > max_age_ms_) valid &= ~(1ull << i);
+  }
+  changed_ |= valid_ & ~valid;
+  valid_ = valid;
+}
+
+}  // namespace halmet
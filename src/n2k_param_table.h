@@ -0,0 +1,109 @@
+#ifndef HALMET_SRC_N2K_PARAM_TABLE_H_
+#define HALMET_SRC_N2K_PARAM_TABLE_H_
+
+#include <Arduino.h>
+
+#include <cstdint>
+
+#include "sensesp/system/valueconsumer.h"
+
+namespace halmet {
+
+/**
+ * @brief Input values of one PGN with their last-update times.
+ *
+ * Values live in two parallel arrays (doubles and millisecond stamps) plus
+ * a validity bitmask, owned by the N2kParamTable that derives from this.
+ * Producers write through N2kParam handles; the sender calls sweep() once
+ * per transmission to expire everything older than max_age_ms, then reads
+ * the values it encodes. Entries that changed since the sender last
+ * encoded them are tracked for N2kMsgTemplate.
+ */
+class N2kParamStore {
+ public:
+  N2kParamStore(const N2kParamStore&) = delete;
+  N2kParamStore& operator=(const N2kParamStore&) = delete;
+
+  void write(int index, double value, uint32_t now_ms) {
+    uint64_t bit = 1ull << index;
+    if (!(valid_ & bit) || values_[index] != value) changed_ |= bit;
+    values_[index] = value;
+    updated_ms_[index] = now_ms;
+    valid_ |= bit;
+  }
+
+  // Clear the valid bit of every value not written within max_age_ms.
+  void sweep(uint32_t now_ms);
+
+  // Entries whose value or validity changed since the last call.
+  uint64_t take_changed() {
+    uint64_t changed = changed_;
+    changed_ = 0;
+    return changed;
+  }
+
+  bool valid(int index) const { return (valid_ >> index) & 1; }
+  double value(int index) const { return values_[index]; }
+  int size() const { return size_; }
+
+ protected:
+  N2kParamStore(double* values, uint32_t* updated_ms, int size,
+                uint32_t max_age_ms)
+      : values_{values},
+        updated_ms_{updated_ms},
+        size_{(uint8_t)size},
+        max_age_ms_{max_age_ms} {}
+
+ private:
+  double* values_;
+  uint32_t* updated_ms_;
+  uint64_t valid_ = 0;
+  uint64_t changed_ = 0;
+  uint8_t size_;
+  uint32_t max_age_ms_;
+};
+
+template <int N>
+class N2kParamTable : public N2kParamStore {
+  static_assert(N > 0 && N <= 64, "validity is a 64-bit mask");
+
+ public:
+  explicit N2kParamTable(uint32_t max_age_ms)
+      : N2kParamStore{values_, updated_ms_, N, max_age_ms} {}
+
+ private:
+  double values_[N] = {};
+  uint32_t updated_ms_[N] = {};
+};
+
+/**
+ * @brief Typed write handle for one entry of a parameter table.
+ *
+ * A ValueConsumer, so producers connect to it like any SensESP consumer
+ * (connect_to(&sender->field_)). Incoming values are multiplied by scale,
+ * e.g. to turn degrees into radians, before they are stored.
+ */
+template <typename T>
+class N2kParam : public sensesp::ValueConsumer<T> {
+ public:
+  N2kParam(N2kParamStore& store, int index, double scale = 1.0)
+      : store_{store}, index_{(uint8_t)index}, scale_{scale} {}
+
+  void set(const T& value) override {
+    store_.write(index_, static_cast<double>(value) * scale_, millis());
+  }
+
+  bool valid() const { return store_.valid(index_); }
+  T value_or(T unavailable) const {
+    return valid() ? static_cast<T>(store_.value(index_)) : unavailable;
+  }
+
+ private:
+  N2kParamStore& store_;
+  uint8_t index_;
+  double scale_;
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_N2K_PARAM_TABLE_H_
@@ -0,0 +1,135 @@
+// src/n2k_scheduler.cpp
+//
+// Phase-balanced time wheel for the periodic N2K senders.
+
+#include "n2k_scheduler.h"
+
+namespace halmet {
+
+N2kScheduler* n2k_scheduler() {
+  static N2kScheduler scheduler;
+  return &scheduler;
+}
+
+int N2kScheduler::best_phase(uint16_t period_slots) const {
+  int phases = period_slots < kSlots ? period_slots : kSlots;
+  int best = 0;
+  uint32_t best_load = UINT32_MAX;
+  int best_gap = -1;
+  for (int c = 0; c < phases; c++) {
+    uint32_t load = 0;
+    for (int k = c; k < kSlots; k += period_slots) {
+      if (load_[k] > load) load = load_[k];
+    }
+    // Distance to the nearest slot that already carries traffic
+    int gap = period_slots;
+    for (int d = 1; d <= period_slots / 2; d++) {
+      if (load_[(c + d) % kSlots] || load_[(c - d + kSlots) % kSlots]) {
+        gap = d;
+        break;
+      }
+    }
+    if (load < best_load || (load == best_load && gap > best_gap)) {
+      best = c;
+      best_load = load;
+      best_gap = gap;
+    }
+  }
+  return best;
+}
+
+void N2kScheduler::insert(int entry, int slot, uint16_t rounds) {
+  Entry& e = entries_[entry];
+  e.rounds = rounds;
+  e.next = wheel_[slot];
+  wheel_[slot] = entry;
+}
+
+bool N2kScheduler::add(uint32_t period_ms, uint8_t frames, Task task) {
+  if (num_entries_ == kMaxTasks) return false;
+  uint32_t period = (period_ms + kSlotMs / 2) / kSlotMs;
+  if (period == 0) period = 1;
+  if (period > UINT16_MAX) period = UINT16_MAX;
+
+  int id = num_entries_++;
+  Entry& e = entries_[id];
+  e.task = task;
+  e.period_slots = period;
+  e.frames = frames;
+
+  int phase = best_phase(e.period_slots);
+  for (int k = phase; k < kSlots; k += e.period_slots) {
+    load_[k] += frames;
+  }
+  aligned_peak_ += frames;
+
+  // First run at the next slot on the chosen phase
+  uint32_t delay = (phase - cursor_ % e.period_slots + e.period_slots) %
+                   e.period_slots;
+  insert(id, (cursor_ + delay) % kSlots, delay / kSlots);
+  stats_.tasks = num_entries_;
+  return true;
+}
+
+void N2kScheduler::tick(uint32_t now_ms) {
+  if (!started_) {
+    started_ = true;
+    cursor_ms_ = now_ms;
+  }
+  // Skip whole turns after a very long stall; slot phases are unchanged.
+  constexpr uint32_t kTurnMs = kSlots * kSlotMs;
+  if ((int32_t)(now_ms - cursor_ms_) >= (int32_t)kTurnMs) {
+    cursor_ms_ += (now_ms - cursor_ms_) / kTurnMs * kTurnMs;
+  }
+
+  pass_++;
+  stats_.ticks++;
+  // A slot is run by the tick nearest to it. With one tick per slot, a
+  // tick landing just before a boundary would otherwise leave that slot
+  // to the next tick, a whole slot late.
+  constexpr int32_t kEarlyMs = kSlotMs / 2;
+  while ((int32_t)(now_ms - cursor_ms_) >= -kEarlyMs) {
+    int32_t delta_ms = (int32_t)(now_ms - cursor_ms_);
+    uint32_t late_ms = delta_ms > 0 ? delta_ms : 0;
+    int id = wheel_[cursor_];
+    wheel_[cursor_] = -1;
+    while (id >= 0) {
+      Entry& e = entries_[id];
+      int next = e.next;
+      if (e.rounds > 0) {
+        insert(id, cursor_, e.rounds - 1);
+      } else {
+        if (e.last_pass == pass_) {
+          stats_.skipped++;
+        } else {
+          e.last_pass = pass_;
+          e.task();
+          stats_.runs++;
+          if (late_ms > jitter_bound_ms_) stats_.late++;
+          if (late_ms > stats_.max_late_ms) stats_.max_late_ms = late_ms;
+        }
+        insert(id, (cursor_ + e.period_slots) % kSlots,
+               (e.period_slots - 1) / kSlots);
+      }
+      id = next;
+    }
+    cursor_ = (cursor_ + 1) % kSlots;
+    cursor_ms_ += kSlotMs;
+  }
+}
+
+uint32_t N2kScheduler::peak_slot_frames() const {
+  uint32_t peak = 0;
+  for (int i = 0; i < kSlots; i++) {
+    if (load_[i] > peak) peak = load_[i];
+  }
+  return peak;
+}
+
+uint32_t N2kScheduler::frames_per_second() const {
+  uint32_t total = 0;
+  for (int i = 0; i < kSlots; i++) total += load_[i];
+  return total * 1000 / (kSlots * kSlotMs);
+}
+
+}  // namespace halmet
@@ -0,0 +1,115 @@
+#ifndef HALMET_SRC_N2K_SCHEDULER_H_
+#define HALMET_SRC_N2K_SCHEDULER_H_
+
+#include <cstdint>
+#include <functional>
+
+namespace halmet {
+
+struct N2kSchedulerStats {
+  uint32_t tasks = 0;
+  uint32_t ticks = 0;        // tick() calls
+  uint32_t runs = 0;         // transmissions started
+  uint32_t skipped = 0;      // catch-up runs dropped after a stall
+  uint32_t late = 0;         // runs started later than the jitter bound
+  uint32_t max_late_ms = 0;  // worst lateness seen
+};
+
+/**
+ * @brief Time wheel that owns every periodic NMEA 2000 transmission.
+ *
+ * The wheel has kSlots slots of kSlotMs each. A task added with a period
+ * is given the phase (slot offset within its period) whose slots carry
+ * the fewest frames so far, ties going to the phase furthest from other
+ * traffic. Senders that share a rate therefore end up evenly spaced
+ * across the interval instead of all firing in the same tick, which
+ * flattens the peak CAN frame rate without changing any average rate.
+ *
+ * Tasks are kept on per-slot lists and run at most once per tick() call:
+ * after a stall, missed runs are dropped rather than sent back to back.
+ * A run that starts more than the jitter bound after its slot is counted
+ * as late. Periods should divide the wheel (kSlots * kSlotMs) for the
+ * per-slot load estimate to be exact.
+ */
+class N2kScheduler {
+ public:
+  static constexpr uint32_t kSlotMs = 10;
+  static constexpr int kSlots = 500;  // 5 s: 100, 500, 1000, 2500 ms divide it
+  static constexpr int kMaxTasks = 32;
+
+  using Task = std::function<void()>;
+
+  explicit N2kScheduler(uint32_t jitter_bound_ms = 5)
+      : jitter_bound_ms_{jitter_bound_ms} {
+    for (int i = 0; i < kSlots; i++) {
+      wheel_[i] = -1;
+      load_[i] = 0;
+    }
+  }
+
+  void set_jitter_bound(uint32_t ms) { jitter_bound_ms_ = ms; }
+
+  /**
+   * @brief Register a periodic transmission.
+   *
+   * @param period_ms Send interval, rounded to whole slots (at least one).
+   * @param frames CAN frames per send (1 for a single-frame PGN, more for
+   *   fast-packet ones), used for the bus-load estimate.
+   * @return false if all kMaxTasks are taken.
+   */
+  bool add(uint32_t period_ms, uint8_t frames, Task task);
+
+  // Run everything that has come due. Call every kSlotMs; calling more
+  // often only adds wakeups, less often adds lateness.
+  void tick(uint32_t now_ms);
+
+  // Frames the registered tasks put on the bus in one wheel slot.
+  uint32_t slot_frames(int slot) const { return load_[slot]; }
+  uint32_t peak_slot_frames() const;
+  // What the peak would be with every task at phase 0.
+  uint32_t aligned_peak_frames() const { return aligned_peak_; }
+  // Average frame rate over the whole wheel.
+  uint32_t frames_per_second() const;
+
+  const N2kSchedulerStats& stats() const { return stats_; }
+
+ private:
+  struct Entry {
+    Task task;
+    uint16_t period_slots = 1;
+    uint16_t rounds = 0;  // full turns to wait before running
+    int8_t next = -1;     // next entry on the same slot list
+    uint8_t frames = 1;
+    uint32_t last_pass = 0;  // tick() call that last ran it
+  };
+
+  int best_phase(uint16_t period_slots) const;
+  void insert(int entry, int slot, uint16_t rounds);
+
+  Entry entries_[kMaxTasks];
+  int num_entries_ = 0;
+  int8_t wheel_[kSlots];  // head entry of each slot's list, -1 if empty
+  uint16_t load_[kSlots];
+  uint32_t aligned_peak_ = 0;
+
+  bool started_ = false;
+  int cursor_ = 0;            // next slot to process
+  uint32_t cursor_ms_ = 0;    // when that slot is due
+  uint32_t pass_ = 0;
+  uint32_t jitter_bound_ms_;
+  N2kSchedulerStats stats_;
+};
+
+// Scheduler shared by all N2K senders, like sensesp::event_loop(). main.cpp
+// ticks it from the event loop.
+N2kScheduler* n2k_scheduler();
+
+// CAN frames needed for a payload of `bytes`: one for up to 8, otherwise
+// fast-packet (6 bytes in the first frame, 7 in each following one).
+constexpr uint8_t N2kFrameCount(int bytes) {
+  return bytes <= 8 ? 1 : (uint8_t)(1 + (bytes - 6 + 6) / 7);
+}
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_N2K_SCHEDULER_H_
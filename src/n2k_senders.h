@@ -4,9 +4,13 @@
 #include <N2kMessages.h>
 #include <NMEA2000.h>
 
+#include "n2k_alarm_mask.h"
+#include "n2k_bus.h"
+#include "n2k_msg_template.h"
+#include "n2k_param_table.h"
+#include "n2k_scheduler.h"
+#include "n2k_transmit_policy.h"
 #include "sensesp/system/saveable.h"
-#include "sensesp/transforms/lambda_transform.h"
-#include "sensesp/transforms/repeat.h"
 #include "sensesp_base_app.h"
 
 namespace halmet {
@@ -15,12 +19,37 @@ namespace halmet {
 // NMEA 2000 SENDERS — PGN TRANSMITTERS
 // ========================================================================
 
+// Optional "heartbeat_ms" / "quiescent_ms" keys of the senders that send
+// on change (see N2kTransmitPolicy).
+inline void LoadTransmitPolicy(const JsonObject& config,
+                               N2kTransmitPolicy& policy) {
+  uint32_t heartbeat_ms = policy.heartbeat_ms();
+  uint32_t quiescent_ms = policy.quiescent_ms();
+  if (config["heartbeat_ms"].is<unsigned int>()) {
+    heartbeat_ms = config["heartbeat_ms"];
+  }
+  if (config["quiescent_ms"].is<unsigned int>()) {
+    quiescent_ms = config["quiescent_ms"];
+  }
+  policy.configure(heartbeat_ms, quiescent_ms);
+}
+
+inline void SaveTransmitPolicy(JsonObject& config,
+                               const N2kTransmitPolicy& policy) {
+  config["heartbeat_ms"] = policy.heartbeat_ms();
+  config["quiescent_ms"] = policy.quiescent_ms();
+}
+
 /**
  * @brief Transmit NMEA 2000 PGN 127488: Engine Parameters, Rapid Update
  *
  * Sends high-frequency engine data: RPM, boost pressure, tilt/trim.
  */
 class N2kEngineParameterRapidSender : public sensesp::FileSystemSaveable {
+ protected:
+  enum Param : uint8_t { kSpeed, kBoostPressure, kTiltTrim, kNumParams };
+  N2kParamTable<kNumParams> params_{1000};  // ms — input timeout
+
  public:
   N2kEngineParameterRapidSender(
       String config_path,
@@ -30,27 +59,24 @@ class N2kEngineParameterRapidSender : public sensesp::FileSystemSaveable {
       : sensesp::FileSystemSaveable{config_path},
         engine_instance_{engine_instance},
         nmea2000_{nmea2000},
-        repeat_interval_{100},  // ms — NMEA 2000 standard
-        expiry_{1000}           // ms — input timeout
+        repeat_interval_{100}  // ms — NMEA 2000 standard
   {
-    this->initialize_members(repeat_interval_, expiry_);
-
-    sensesp::event_loop()->onRepeat(repeat_interval_, [this]() {
-      tN2kMsg N2kMsg;
-      SetN2kEngineParamRapid(
-          N2kMsg,
-          this->engine_instance_,
-          this->engine_speed_rpm_->get(),
-          this->engine_boost_pressure_->get(),
-          this->engine_tilt_trim_->get()
-      );
-      this->nmea2000_->SendMsg(N2kMsg);
+    policy_.set_deadband(kSpeed, 10);            // rpm
+    policy_.set_deadband(kBoostPressure, 1000);  // Pa
+    policy_.set_deadband(kTiltTrim, 1);          // %
+
+    msg_.field(kSpeed, 1, N2kField::kUDouble2, 0.25);
+    msg_.field(kBoostPressure, 3, N2kField::kUDouble2, 100);
+    msg_.field(kTiltTrim, 5, N2kField::kInt8);
+
+    n2k_scheduler()->add(repeat_interval_, N2kFrameCount(8), [this]() {
+      params_.sweep(millis());
+      for (int i = 0; i < kNumParams; i++) {
+        policy_.value(i, params_.value(i), params_.valid(i));
+      }
+      if (!policy_.should_send(millis())) return;
+      N2kBusSend(this->nmea2000_, msg_.update(params_));
     });
-
-    engine_speed_.connect_to(
-        new sensesp::LambdaTransform<double, double>(
-            [](double value) { return 60 * value; })
-    )->connect_to(engine_speed_rpm_);
   }
 
   // --------------------------------------------------------------------
@@ -61,42 +87,39 @@ class N2kEngineParameterRapidSender : public sensesp::FileSystemSaveable {
       return false;
     }
     engine_instance_ = config["engine_instance"];
+    msg_.invalidate();
+    LoadTransmitPolicy(config, policy_);
     return true;
   }
 
   virtual bool to_json(JsonObject& config) override {
     config["engine_instance"] = engine_instance_;
+    SaveTransmitPolicy(config, policy_);
     return true;
   }
 
   // --------------------------------------------------------------------
   // INPUTS
   // --------------------------------------------------------------------
-  sensesp::ObservableValue<double> engine_speed_;  // Hz → RPM
-  std::shared_ptr<sensesp::RepeatExpiring<double>> engine_boost_pressure_;
-  std::shared_ptr<sensesp::RepeatExpiring<int8_t>> engine_tilt_trim_;
+  N2kParam<double> engine_speed_{params_, kSpeed, 60};  // Hz → RPM
+  N2kParam<double> engine_boost_pressure_{params_, kBoostPressure};
+  N2kParam<int8_t> engine_tilt_trim_{params_, kTiltTrim};
 
  protected:
   unsigned int repeat_interval_;
-  unsigned int expiry_;
   tNMEA2000* nmea2000_;
 
-  std::shared_ptr<sensesp::RepeatExpiring<double>> engine_speed_rpm_;
-
   uint8_t engine_instance_ = 0;
-
- private:
-  void initialize_members(unsigned int repeat_interval, unsigned int expiry) {
-    engine_boost_pressure_ = std::make_shared<sensesp::RepeatExpiring<double>>(
-        repeat_interval, expiry
-    );
-    engine_tilt_trim_ = std::make_shared<sensesp::RepeatExpiring<int8_t>>(
-        repeat_interval, expiry
-    );
-    engine_speed_rpm_ = std::make_shared<sensesp::RepeatExpiring<double>>(
-        repeat_interval, expiry
-    );
-  }
+  N2kTransmitPolicy policy_{127488, 1000, 10000};
+  N2kMsgTemplate msg_{[this](tN2kMsg& msg) {
+    SetN2kEngineParamRapid(
+        msg,
+        this->engine_instance_,
+        this->engine_speed_.value_or(N2kDoubleNA),
+        this->engine_boost_pressure_.value_or(N2kDoubleNA),
+        this->engine_tilt_trim_.value_or(N2kInt8NA)
+    );
+  }};
 };
 
 const String ConfigSchema(const N2kEngineParameterRapidSender& obj) {
@@ -107,6 +130,16 @@ const String ConfigSchema(const N2kEngineParameterRapidSender& obj) {
         "title": "Engine instance",
         "type": "integer",
         "description": "Engine NMEA 2000 instance number (0-253)"
+      },
+      "heartbeat_ms": {
+        "title": "Heartbeat interval (ms)",
+        "type": "integer",
+        "description": "Unchanged values are re-sent this often (0 = every interval)"
+      },
+      "quiescent_ms": {
+        "title": "Quiescent interval (ms)",
+        "type": "integer",
+        "description": "Re-send interval while every input has expired, e.g. engine off"
       }
     }
   })###";
@@ -115,9 +148,32 @@ const String ConfigSchema(const N2kEngineParameterRapidSender& obj) {
 /**
  * @brief Transmit NMEA 2000 PGN 127489: Engine Parameters, Dynamic
  *
- * Sends detailed engine status: pressures, temperatures, alarms.
+ * Sends detailed engine status: pressures, temperatures, alarms. The
+ * discrete alarms live in a packed mask laid out like the two PGN status
+ * words; an alarm going active sends the PGN at once instead of waiting
+ * for the next scheduled interval.
  */
 class N2kEngineParameterDynamicSender : public sensesp::FileSystemSaveable {
+ protected:
+  enum Param : uint8_t {
+    kOilPressure, kOilTemperature, kTemperature, kAlternatorPotential,
+    kFuelRate, kTotalEngineHours, kCoolantPressure, kFuelPressure,
+    kEngineLoad, kEngineTorque, kNumParams
+  };
+  N2kParamTable<kNumParams> params_{5000};  // ms — input timeout
+
+  // Bit positions of Discrete Status 1 (0-15) and Status 2 (16-23)
+  enum Alarm : uint8_t {
+    kCheckEngine, kOverTemperature, kLowOilPressure, kLowOilLevel,
+    kLowFuelPressure, kLowSystemVoltage, kLowCoolantLevel, kWaterFlow,
+    kWaterInFuel, kChargeIndicator, kPreheatIndicator, kHighBoostPressure,
+    kRevLimitExceeded, kEgrSystem, kThrottlePositionSensor, kEmergencyStop,
+    kWarningLevel1, kWarningLevel2, kPowerReduction, kMaintenanceNeeded,
+    kEngineCommError, kSubOrSecondaryThrottle, kNeutralStartProtect,
+    kEngineShuttingDown
+  };
+  N2kAlarmMask alarms_{5000, 2000};  // ms — input timeout, latch time
+
  public:
   N2kEngineParameterDynamicSender(
       String config_path,
@@ -127,33 +183,39 @@ class N2kEngineParameterDynamicSender : public sensesp::FileSystemSaveable {
       : sensesp::FileSystemSaveable{config_path},
         engine_instance_{engine_instance},
         nmea2000_{nmea2000},
-        repeat_interval_{500},  // ms — NMEA 2000 standard
-        expiry_{5000}           // ms — input timeout
+        repeat_interval_{500}  // ms — NMEA 2000 standard
   {
-    this->initialize_members(repeat_interval_, expiry_);
-
-    sensesp::event_loop()->onRepeat(repeat_interval_, [this]() {
-      tN2kMsg N2kMsg;
-      SetN2kEngineDynamicParam(
-          N2kMsg,
-          this->engine_instance_,
-          this->oil_pressure_->get(),
-          this->oil_temperature_->get(),
-          this->temperature_->get(),
-          this->alternator_potential_->get(),
-          this->fuel_rate_->get(),
-          this->total_engine_hours_->get(),
-          this->coolant_pressure_->get(),
-          this->fuel_pressure_->get(),
-          this->engine_load_->get(),
-          this->engine_torque_->get(),
-          this->get_engine_status_1(),
-          this->get_engine_status_2()
-      );
-      this->nmea2000_->SendMsg(N2kMsg);
-    });
+    policy_.set_deadband(kOilPressure, 1000);         // Pa
+    policy_.set_deadband(kOilTemperature, 0.5);       // K
+    policy_.set_deadband(kTemperature, 0.5);          // K
+    policy_.set_deadband(kAlternatorPotential, 0.1);  // V
+    policy_.set_deadband(kFuelRate, 0.1);             // l/h
+    policy_.set_deadband(kTotalEngineHours, 60);      // s
+    policy_.set_deadband(kCoolantPressure, 1000);     // Pa
+    policy_.set_deadband(kFuelPressure, 1000);        // Pa
+    policy_.set_deadband(kEngineLoad, 1);             // %
+    policy_.set_deadband(kEngineTorque, 1);           // %
+
+    msg_.field(kOilPressure, 1, N2kField::kUDouble2, 100);
+    msg_.field(kOilTemperature, 3, N2kField::kUDouble2, 0.1);
+    msg_.field(kTemperature, 5, N2kField::kUDouble2, 0.01);
+    msg_.field(kAlternatorPotential, 7, N2kField::kDouble2, 0.01);
+    msg_.field(kFuelRate, 9, N2kField::kDouble2, 0.1);
+    msg_.field(kTotalEngineHours, 11, N2kField::kUDouble4, 1);
+    msg_.field(kCoolantPressure, 15, N2kField::kUDouble2, 100);
+    msg_.field(kFuelPressure, 17, N2kField::kUDouble2, 1000);
+    msg_.field(kEngineLoad, 24, N2kField::kInt8);
+    msg_.field(kEngineTorque, 25, N2kField::kInt8);
+
+    // A new alarm goes out right away, outside the wheel. The policy sees
+    // the changed status word, so the scheduled run doesn't repeat it.
+    alarms_.on_edge([this]() { this->transmit(); });
+    n2k_scheduler()->add(repeat_interval_, N2kFrameCount(26),
+                         [this]() { this->transmit(); });
   }
 
+  const N2kAlarmStats& alarm_stats() const { return alarms_.stats(); }
+
   // --------------------------------------------------------------------
   // CONFIGURATION PERSISTENCE
   // --------------------------------------------------------------------
@@ -162,224 +224,118 @@ class N2kEngineParameterDynamicSender : public sensesp::FileSystemSaveable {
       return false;
     }
     engine_instance_ = config["engine_instance"];
+    msg_.invalidate();
+    if (config["alarm_latency_ms"].is<unsigned int>()) {
+      alarms_.set_latency_bound(config["alarm_latency_ms"]);
+    }
+    LoadTransmitPolicy(config, policy_);
     return true;
   }
 
   virtual bool to_json(JsonObject& config) override {
     config["engine_instance"] = engine_instance_;
+    config["alarm_latency_ms"] = alarms_.latency_bound_ms();
+    SaveTransmitPolicy(config, policy_);
     return true;
   }
 
   // --------------------------------------------------------------------
   // INPUTS — ANALOG VALUES
   // --------------------------------------------------------------------
-  std::shared_ptr<sensesp::RepeatExpiring<double>> oil_pressure_;
-  std::shared_ptr<sensesp::RepeatExpiring<double>> oil_temperature_;
-  std::shared_ptr<sensesp::RepeatExpiring<double>> temperature_;
-  std::shared_ptr<sensesp::RepeatExpiring<double>> alternator_potential_;
-  std::shared_ptr<sensesp::RepeatExpiring<double>> fuel_rate_;
-  std::shared_ptr<sensesp::RepeatExpiring<uint32_t>> total_engine_hours_;
-  std::shared_ptr<sensesp::RepeatExpiring<double>> coolant_pressure_;
-  std::shared_ptr<sensesp::RepeatExpiring<double>> fuel_pressure_;
-  std::shared_ptr<sensesp::RepeatExpiring<int>> engine_load_;
-  std::shared_ptr<sensesp::RepeatExpiring<int>> engine_torque_;
+  N2kParam<double> oil_pressure_{params_, kOilPressure};
+  N2kParam<double> oil_temperature_{params_, kOilTemperature};
+  N2kParam<double> temperature_{params_, kTemperature};
+  N2kParam<double> alternator_potential_{params_, kAlternatorPotential};
+  N2kParam<double> fuel_rate_{params_, kFuelRate};
+  N2kParam<double> total_engine_hours_{params_, kTotalEngineHours};  // s
+  N2kParam<double> coolant_pressure_{params_, kCoolantPressure};
+  N2kParam<double> fuel_pressure_{params_, kFuelPressure};
+  N2kParam<int> engine_load_{params_, kEngineLoad};
+  N2kParam<int> engine_torque_{params_, kEngineTorque};
 
   // --------------------------------------------------------------------
   // INPUTS — DISCRETE ALARMS (STATUS 1)
   // --------------------------------------------------------------------
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> check_engine_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> over_temperature_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> low_oil_pressure_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> low_oil_level_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> low_fuel_pressure_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> low_system_voltage_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> low_coolant_level_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> water_flow_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> water_in_fuel_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> charge_indicator_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> preheat_indicator_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> high_boost_pressure_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> rev_limit_exceeded_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> egr_system_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> throttle_position_sensor_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> emergency_stop_;
+  N2kAlarm check_engine_{alarms_, kCheckEngine};
+  N2kAlarm over_temperature_{alarms_, kOverTemperature};
+  N2kAlarm low_oil_pressure_{alarms_, kLowOilPressure};
+  N2kAlarm low_oil_level_{alarms_, kLowOilLevel};
+  N2kAlarm low_fuel_pressure_{alarms_, kLowFuelPressure};
+  N2kAlarm low_system_voltage_{alarms_, kLowSystemVoltage};
+  N2kAlarm low_coolant_level_{alarms_, kLowCoolantLevel};
+  N2kAlarm water_flow_{alarms_, kWaterFlow};
+  N2kAlarm water_in_fuel_{alarms_, kWaterInFuel};
+  N2kAlarm charge_indicator_{alarms_, kChargeIndicator};
+  N2kAlarm preheat_indicator_{alarms_, kPreheatIndicator};
+  N2kAlarm high_boost_pressure_{alarms_, kHighBoostPressure};
+  N2kAlarm rev_limit_exceeded_{alarms_, kRevLimitExceeded};
+  N2kAlarm egr_system_{alarms_, kEgrSystem};
+  N2kAlarm throttle_position_sensor_{alarms_, kThrottlePositionSensor};
+  N2kAlarm emergency_stop_{alarms_, kEmergencyStop};
 
   // --------------------------------------------------------------------
   // INPUTS — DISCRETE ALARMS (STATUS 2)
   // --------------------------------------------------------------------
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> warning_level_1_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> warning_level_2_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> power_reduction_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> maintenance_needed_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> engine_comm_error_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> sub_or_secondary_throttle_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> neutral_start_protect_;
-  std::shared_ptr<sensesp::RepeatExpiring<bool>> engine_shutting_down_;
+  N2kAlarm warning_level_1_{alarms_, kWarningLevel1};
+  N2kAlarm warning_level_2_{alarms_, kWarningLevel2};
+  N2kAlarm power_reduction_{alarms_, kPowerReduction};
+  N2kAlarm maintenance_needed_{alarms_, kMaintenanceNeeded};
+  N2kAlarm engine_comm_error_{alarms_, kEngineCommError};
+  N2kAlarm sub_or_secondary_throttle_{alarms_, kSubOrSecondaryThrottle};
+  N2kAlarm neutral_start_protect_{alarms_, kNeutralStartProtect};
+  N2kAlarm engine_shutting_down_{alarms_, kEngineShuttingDown};
 
  protected:
   // --------------------------------------------------------------------
-  // ENGINE STATUS 1 — BITFIELD CONSTRUCTION
+  // TRANSMISSION — SCHEDULED AND ON ALARM
   // --------------------------------------------------------------------
-  tN2kEngineDiscreteStatus1 get_engine_status_1() {
-    tN2kEngineDiscreteStatus1 status = 0;
-
-    status.Bits.OverTemperature = over_temperature_->get();
-    status.Bits.LowOilPressure = low_oil_pressure_->get();
-    status.Bits.LowOilLevel = low_oil_level_->get();
-    status.Bits.LowFuelPressure = low_fuel_pressure_->get();
-    status.Bits.LowSystemVoltage = low_system_voltage_->get();
-    status.Bits.LowCoolantLevel = low_coolant_level_->get();
-    status.Bits.WaterFlow = water_flow_->get();
-    status.Bits.WaterInFuel = water_in_fuel_->get();
-    status.Bits.ChargeIndicator = charge_indicator_->get();
-    status.Bits.PreheatIndicator = preheat_indicator_->get();
-    status.Bits.HighBoostPressure = high_boost_pressure_->get();
-    status.Bits.RevLimitExceeded = rev_limit_exceeded_->get();
-    status.Bits.EGRSystem = egr_system_->get();
-    status.Bits.ThrottlePositionSensor = throttle_position_sensor_->get();
-    status.Bits.EngineEmergencyStopMode = emergency_stop_->get();
-
-    // CheckEngine = any other alarm
-    status.Bits.CheckEngine =
-        status.Bits.OverTemperature || status.Bits.LowOilPressure ||
-        status.Bits.LowOilLevel || status.Bits.LowFuelPressure ||
-        status.Bits.LowSystemVoltage || status.Bits.LowCoolantLevel ||
-        status.Bits.WaterFlow || status.Bits.WaterInFuel ||
-        status.Bits.ChargeIndicator || status.Bits.PreheatIndicator ||
-        status.Bits.HighBoostPressure || status.Bits.RevLimitExceeded ||
-        status.Bits.EGRSystem || status.Bits.ThrottlePositionSensor ||
-        status.Bits.EngineEmergencyStopMode;
-
-    return status;
-  }
+  void transmit() {
+    uint32_t now = millis();
+    params_.sweep(now);
+    alarms_.sweep(now);
 
-  // --------------------------------------------------------------------
-  // ENGINE STATUS 2 — BITFIELD CONSTRUCTION
-  // --------------------------------------------------------------------
-  tN2kEngineDiscreteStatus2 get_engine_status_2() {
-    tN2kEngineDiscreteStatus2 status = 0;
-    status.Bits.WarningLevel1 = warning_level_1_->get();
-    status.Bits.WarningLevel2 = warning_level_2_->get();
-    status.Bits.LowOiPowerReduction = power_reduction_->get();
-    status.Bits.MaintenanceNeeded = maintenance_needed_->get();
-    status.Bits.EngineCommError = engine_comm_error_->get();
-    status.Bits.SubOrSecondaryThrottle = sub_or_secondary_throttle_->get();
-    status.Bits.NeutralStartProtect = neutral_start_protect_->get();
-    status.Bits.EngineShuttingDown = engine_shutting_down_->get();
-    return status;
+    // The mask uses the PGN bit layout; CheckEngine = any Status 1 alarm
+    uint32_t bits = alarms_.bits();
+    tN2kEngineDiscreteStatus1 status_1 = (uint16_t)(bits & 0xffff);
+    tN2kEngineDiscreteStatus2 status_2 = (uint16_t)(bits >> 16);
+    if (status_1.Status) status_1.Bits.CheckEngine = 1;
+
+    for (int i = 0; i < kNumParams; i++) {
+      policy_.value(i, params_.value(i), params_.valid(i));
+    }
+    policy_.bits(kNumParams, status_1.Status);
+    policy_.bits(kNumParams + 1, status_2.Status);
+    // An alarm edge whose send failed is retried even if nothing changed
+    if (!policy_.should_send(now) && !alarms_.edge_pending()) return;
+
+    const tN2kMsg& msg = msg_.update(params_);
+    msg_.set_uint16(20, status_1.Status);
+    msg_.set_uint16(22, status_2.Status);
+    if (N2kBusSend(this->nmea2000_, msg)) alarms_.sent(micros());
   }
 
   unsigned int repeat_interval_;
-  unsigned int expiry_;
   tNMEA2000* nmea2000_;
 
   uint8_t engine_instance_;
-
- private:
-  void initialize_members(uint32_t repeat_interval_, uint32_t expiry_) {
-    oil_pressure_ = std::make_shared<sensesp::RepeatExpiring<double>>(
-        repeat_interval_, expiry_
-    );
-    oil_temperature_ = std::make_shared<sensesp::RepeatExpiring<double>>(
-        repeat_interval_, expiry_
-    );
-    temperature_ = std::make_shared<sensesp::RepeatExpiring<double>>(
-        repeat_interval_, expiry_
-    );
-    alternator_potential_ = std::make_shared<sensesp::RepeatExpiring<double>>(
-        repeat_interval_, expiry_
-    );
-    fuel_rate_ = std::make_shared<sensesp::RepeatExpiring<double>>(
-        repeat_interval_, expiry_
-    );
-    total_engine_hours_ = std::make_shared<sensesp::RepeatExpiring<uint32_t>>(
-        repeat_interval_, expiry_
-    );
-    coolant_pressure_ = std::make_shared<sensesp::RepeatExpiring<double>>(
-        repeat_interval_, expiry_
-    );
-    fuel_pressure_ = std::make_shared<sensesp::RepeatExpiring<double>>(
-        repeat_interval_, expiry_
-    );
-    engine_load_ = std::make_shared<sensesp::RepeatExpiring<int>>(
-        repeat_interval_, expiry_
-    );
-    engine_torque_ = std::make_shared<sensesp::RepeatExpiring<int>>(
-        repeat_interval_, expiry_
-    );
-    check_engine_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    over_temperature_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    low_oil_pressure_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    low_oil_level_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    low_fuel_pressure_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    low_system_voltage_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    low_coolant_level_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    water_flow_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    water_in_fuel_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    charge_indicator_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    preheat_indicator_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    high_boost_pressure_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    rev_limit_exceeded_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    egr_system_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    throttle_position_sensor_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    emergency_stop_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    warning_level_1_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    warning_level_2_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    power_reduction_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    maintenance_needed_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    engine_comm_error_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    sub_or_secondary_throttle_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    neutral_start_protect_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-    engine_shutting_down_ = std::make_shared<sensesp::RepeatExpiring<bool>>(
-        repeat_interval_, expiry_
-    );
-  }
+  N2kTransmitPolicy policy_{127489, 2000, 10000};
+  // Status words are written by transmit(), so they're left 0 here
+  N2kMsgTemplate msg_{[this](tN2kMsg& msg) {
+    SetN2kEngineDynamicParam(
+        msg,
+        this->engine_instance_,
+        this->oil_pressure_.value_or(N2kDoubleNA),
+        this->oil_temperature_.value_or(N2kDoubleNA),
+        this->temperature_.value_or(N2kDoubleNA),
+        this->alternator_potential_.value_or(N2kDoubleNA),
+        this->fuel_rate_.value_or(N2kDoubleNA),
+        this->total_engine_hours_.value_or(N2kDoubleNA),
+        this->coolant_pressure_.value_or(N2kDoubleNA),
+        this->fuel_pressure_.value_or(N2kDoubleNA),
+        this->engine_load_.value_or(N2kInt8NA),
+        this->engine_torque_.value_or(N2kInt8NA)
+    );
+  }};
 };
 
 const String ConfigSchema(const N2kEngineParameterDynamicSender& obj) {
@@ -390,6 +346,21 @@ const String ConfigSchema(const N2kEngineParameterDynamicSender& obj) {
         "title": "Engine instance",
         "type": "integer",
         "description": "Engine NMEA 2000 instance number (0-253)"
+      },
+      "alarm_latency_ms": {
+        "title": "Alarm latency bound (ms)",
+        "type": "integer",
+        "description": "A new alarm that takes longer than this to reach the bus is counted on the status page"
+      },
+      "heartbeat_ms": {
+        "title": "Heartbeat interval (ms)",
+        "type": "integer",
+        "description": "Unchanged values are re-sent this often (0 = every interval)"
+      },
+      "quiescent_ms": {
+        "title": "Quiescent interval (ms)",
+        "type": "integer",
+        "description": "Re-send interval while every input has expired, e.g. engine off"
       }
     }
   })###";
@@ -401,6 +372,10 @@ const String ConfigSchema(const N2kEngineParameterDynamicSender& obj) {
  * Reports tank level as percentage and capacity.
  */
 class N2kFluidLevelSender : public sensesp::FileSystemSaveable {
+ protected:
+  enum Param : uint8_t { kLevel, kNumParams };
+  N2kParamTable<kNumParams> params_{10000};  // ms — input timeout
+
  public:
   N2kFluidLevelSender(
       String config_path,
@@ -414,24 +389,16 @@ class N2kFluidLevelSender : public sensesp::FileSystemSaveable {
         tank_type_{tank_type},
         tank_capacity_{tank_capacity},
         nmea2000_{nmea2000},
-        repeat_interval_{2500},  // ms — NMEA 2000 standard
-        expiry_{10000}           // ms — input timeout
+        repeat_interval_{2500}  // ms — NMEA 2000 standard
   {
-    tank_level_.connect_to(
-        new sensesp::LambdaTransform<double, double>(
-            [this](double value) { return 100 * value; })
-    )->connect_to(&tank_level_percent_);
-
-    sensesp::event_loop()->onRepeat(repeat_interval_, [this]() {
-      tN2kMsg N2kMsg;
-      SetN2kFluidLevel(
-          N2kMsg,
-          this->tank_instance_,
-          this->tank_type_,
-          this->tank_level_percent_.get(),
-          this->tank_capacity_
-      );
-      this->nmea2000_->SendMsg(N2kMsg);
+    policy_.set_deadband(kLevel, 0.5);  // %
+    msg_.field(kLevel, 1, N2kField::kDouble2, 0.004);
+
+    n2k_scheduler()->add(repeat_interval_, N2kFrameCount(8), [this]() {
+      params_.sweep(millis());
+      policy_.value(kLevel, params_.value(kLevel), params_.valid(kLevel));
+      if (!policy_.should_send(millis())) return;
+      N2kBusSend(this->nmea2000_, msg_.update(params_));
     });
   }
 
@@ -449,6 +416,8 @@ class N2kFluidLevelSender : public sensesp::FileSystemSaveable {
     tank_instance_ = config["tank_instance"];
     tank_type_ = config["tank_type"];
     tank_capacity_ = config["tank_capacity"];
+    msg_.invalidate();
+    LoadTransmitPolicy(config, policy_);
     return true;
   }
 
@@ -456,23 +425,32 @@ class N2kFluidLevelSender : public sensesp::FileSystemSaveable {
     config["tank_instance"] = tank_instance_;
     config["tank_type"] = tank_type_;
     config["tank_capacity"] = tank_capacity_;
+    SaveTransmitPolicy(config, policy_);
     return true;
   }
 
   // --------------------------------------------------------------------
   // INPUTS
   // --------------------------------------------------------------------
-  sensesp::ObservableValue<double> tank_level_;  // ratio (0.0–1.0)
+  N2kParam<double> tank_level_{params_, kLevel, 100};  // ratio (0.0–1.0) → %
 
  protected:
   unsigned int repeat_interval_;
-  unsigned int expiry_;
   tNMEA2000* nmea2000_;
 
   uint8_t tank_instance_;
   tN2kFluidType tank_type_;
   double tank_capacity_;  // liters
-  sensesp::RepeatExpiring<double> tank_level_percent_{repeat_interval_, expiry_};
+  N2kTransmitPolicy policy_{127505, 5000, 30000};
+  N2kMsgTemplate msg_{[this](tN2kMsg& msg) {
+    SetN2kFluidLevel(
+        msg,
+        this->tank_instance_,
+        this->tank_type_,
+        this->tank_level_.value_or(N2kDoubleNA),
+        this->tank_capacity_
+    );
+  }};
 };
 
 const String ConfigSchema(const N2kFluidLevelSender& obj) {
@@ -493,6 +471,16 @@ const String ConfigSchema(const N2kFluidLevelSender& obj) {
         "title": "Tank capacity",
         "type": "number",
         "description": "Tank capacity (liters)"
+      },
+      "heartbeat_ms": {
+        "title": "Heartbeat interval (ms)",
+        "type": "integer",
+        "description": "Unchanged values are re-sent this often (0 = every interval)"
+      },
+      "quiescent_ms": {
+        "title": "Quiescent interval (ms)",
+        "type": "integer",
+        "description": "Re-send interval while every input has expired, e.g. engine off"
       }
     }
   })###";
@@ -504,6 +492,10 @@ const String ConfigSchema(const N2kFluidLevelSender& obj) {
  * Sends rudder angle in radians.
  */
 class N2kRudderSender : public sensesp::FileSystemSaveable {
+ protected:
+  enum Param : uint8_t { kAngle, kNumParams };
+  N2kParamTable<kNumParams> params_{1000};  // ms — input timeout
+
  public:
   N2kRudderSender(
       String config_path,
@@ -513,48 +505,34 @@ class N2kRudderSender : public sensesp::FileSystemSaveable {
       : sensesp::FileSystemSaveable{config_path},
         rudder_instance_{rudder_instance},
         nmea2000_{nmea2000},
-        repeat_interval_{100},
-        expiry_{1000}
+        repeat_interval_{100}
   {
-    this->initialize_members(repeat_interval_, expiry_);
-
-    sensesp::event_loop()->onRepeat(repeat_interval_, [this]() {
-      tN2kMsg msg;
-      SetN2kPGN127245(
-          msg,
-          rudder_angle_rad_->get(),
-          rudder_instance_,
-          N2kRDO_NoDirectionOrder,
-          N2kDoubleNA
-      );
-      nmea2000_->SendMsg(msg);
+    msg_.field(kAngle, 4, N2kField::kDouble2, 0.0001);
+
+    n2k_scheduler()->add(repeat_interval_, N2kFrameCount(8), [this]() {
+      params_.sweep(millis());
+      N2kBusSend(nmea2000_, msg_.update(params_));
     });
   }
 
   // --------------------------------------------------------------------
   // INPUTS
   // --------------------------------------------------------------------
-  sensesp::ObservableValue<double> rudder_angle_deg_;
+  N2kParam<double> rudder_angle_deg_{params_, kAngle, DEG_TO_RAD};  // → rad
 
  protected:
   tNMEA2000* nmea2000_;
   uint8_t rudder_instance_;
   unsigned int repeat_interval_;
-  unsigned int expiry_;
-
-  std::shared_ptr<sensesp::RepeatExpiring<double>> rudder_angle_rad_;
-
- private:
-  void initialize_members(unsigned int repeat, unsigned int exp) {
-    rudder_angle_rad_ = std::make_shared<sensesp::RepeatExpiring<double>>(
-        repeat, exp
-    );
-
-    rudder_angle_deg_.connect_to(
-        new sensesp::LambdaTransform<double, double>(
-            [](double deg) { return deg * DEG_TO_RAD; })
-    )->connect_to(rudder_angle_rad_);
-  }
+  N2kMsgTemplate msg_{[this](tN2kMsg& msg) {
+    SetN2kPGN127245(
+        msg,
+        rudder_angle_deg_.value_or(N2kDoubleNA),
+        rudder_instance_,
+        N2kRDO_NoDirectionOrder,
+        N2kDoubleNA
+    );
+  }};
 };
 
 const String ConfigSchema(const N2kRudderSender& obj) {
@@ -574,41 +552,34 @@ const String ConfigSchema(const N2kRudderSender& obj) {
  * @brief Transmit NMEA 2000 PGN 130576: Trim Tab Position
  */
 class N2kTrimTabSender : public sensesp::FileSystemSaveable {
+ protected:
+  enum Param : uint8_t { kPort, kStbd, kNumParams };
+  N2kParamTable<kNumParams> params_{5000};  // ms — input timeout
+
  public:
   N2kTrimTabSender(String config_path, tNMEA2000* nmea2000)
       : sensesp::FileSystemSaveable{config_path},
         nmea2000_{nmea2000},
-        repeat_interval_{500},
-        expiry_{5000} {
-    this->initialize_members(repeat_interval_, expiry_);
-
-    sensesp::event_loop()->onRepeat(repeat_interval_, [this]() {
-      tN2kMsg msg;
-      double port_deg = trim_deg_port_exp_->get();  // Always get the value
-      double stbd_deg = trim_deg_stbd_exp_->get();  // Always get the value
-      SetN2kPGN130576(msg, port_deg * DEG_TO_RAD, stbd_deg * DEG_TO_RAD);
-      nmea2000_->SendMsg(msg);
+        repeat_interval_{500} {
+    msg_.field(kPort, 0, N2kField::kInt8);
+    msg_.field(kStbd, 1, N2kField::kInt8);
+
+    n2k_scheduler()->add(repeat_interval_, N2kFrameCount(8), [this]() {
+      params_.sweep(millis());
+      N2kBusSend(nmea2000_, msg_.update(params_));
     });
   }
 
-  sensesp::ObservableValue<double> trim_deg_port_;
-  sensesp::ObservableValue<double> trim_deg_stbd_;
+  N2kParam<double> trim_deg_port_{params_, kPort, DEG_TO_RAD};  // → rad
+  N2kParam<double> trim_deg_stbd_{params_, kStbd, DEG_TO_RAD};
 
  protected:
   tNMEA2000* nmea2000_;
   unsigned int repeat_interval_;
-  unsigned int expiry_;
-
-  std::shared_ptr<sensesp::RepeatExpiring<double>> trim_deg_port_exp_;
-  std::shared_ptr<sensesp::RepeatExpiring<double>> trim_deg_stbd_exp_;
-
- private:
-  void initialize_members(unsigned int repeat, unsigned int exp) {
-    trim_deg_port_exp_ = std::make_shared<sensesp::RepeatExpiring<double>>(repeat, exp);
-    trim_deg_port_.connect_to(trim_deg_port_exp_);
-    trim_deg_stbd_exp_ = std::make_shared<sensesp::RepeatExpiring<double>>(repeat, exp);
-    trim_deg_stbd_.connect_to(trim_deg_stbd_exp_);
-  }
+  N2kMsgTemplate msg_{[this](tN2kMsg& msg) {
+    SetN2kPGN130576(msg, trim_deg_port_.value_or(N2kInt8NA),
+                    trim_deg_stbd_.value_or(N2kInt8NA));
+  }};
 };
 
 const String ConfigSchema(const N2kTrimTabSender& obj) {
@@ -624,6 +595,11 @@ const String ConfigSchema(const N2kTrimTabSender& obj) {
  * Sends gear position (0=R, 1=N, 2=F, 3=Unknown), oil pressure, temperature.
  */
 class N2kTransmissionSender : public sensesp::FileSystemSaveable {
+ protected:
+  enum Param : uint8_t { kGear, kOilPressure, kOilTemperature, kStatus1,
+                         kNumParams };
+  N2kParamTable<kNumParams> params_{5000};  // ms — input timeout
+
  public:
   N2kTransmissionSender(
       String config_path,
@@ -633,52 +609,54 @@ class N2kTransmissionSender : public sensesp::FileSystemSaveable {
       : sensesp::FileSystemSaveable{config_path},
         transmission_instance_{transmission_instance},
         nmea2000_{nmea2000},
-        repeat_interval_{500},
-        expiry_{5000}
+        repeat_interval_{500}
   {
-    this->initialize_members(repeat_interval_, expiry_);
-
-    sensesp::event_loop()->onRepeat(repeat_interval_, [this]() {
-      tN2kMsg msg;
-      SetN2kPGN127493(
-          msg,
-          transmission_instance_,
-          static_cast<tN2kTransmissionGear>(
-              gear_code_->get().is_valid() ? gear_code_->get().value() : 3
-          ),
-          oil_pressure_pa_->get(),
-          oil_temp_k_->get(),
-          discrete_status1_->get()
-      );
-      nmea2000_->SendMsg(msg);
+    policy_.set_deadband(kOilPressure, 1000);    // Pa
+    policy_.set_deadband(kOilTemperature, 0.5);  // K
+
+    // Gear shares its byte with reserved bits and the status byte has its
+    // own N/A value, so changes to either re-encode the whole message.
+    msg_.rebuild_on(kGear);
+    msg_.rebuild_on(kStatus1);
+    msg_.field(kOilPressure, 2, N2kField::kUDouble2, 100);
+    msg_.field(kOilTemperature, 4, N2kField::kUDouble2, 0.1);
+
+    n2k_scheduler()->add(repeat_interval_, N2kFrameCount(8), [this]() {
+      params_.sweep(millis());
+      unsigned char status = discrete_status1_.value_or(0);
+      for (int i = kGear; i <= kOilTemperature; i++) {
+        policy_.value(i, params_.value(i), params_.valid(i));
+      }
+      policy_.bits(kStatus1, status);
+      if (!policy_.should_send(millis())) return;
+      N2kBusSend(nmea2000_, msg_.update(params_));
     });
   }
 
   // --------------------------------------------------------------------
   // INPUTS — PUBLIC
   // --------------------------------------------------------------------
-  sensesp::ObservableValue<int> gear_;  // 0=Reverse, 1=Neutral, 2=Forward, 3=Unknown
-  std::shared_ptr<sensesp::RepeatExpiring<double>> oil_pressure_pa_;
-  std::shared_ptr<sensesp::RepeatExpiring<double>> oil_temp_k_;
-  std::shared_ptr<sensesp::RepeatExpiring<unsigned char>> discrete_status1_;
+  N2kParam<int> gear_{params_, kGear};  // 0=Reverse, 1=Neutral, 2=Forward, 3=Unknown
+  N2kParam<double> oil_pressure_pa_{params_, kOilPressure};
+  N2kParam<double> oil_temp_k_{params_, kOilTemperature};
+  N2kParam<unsigned char> discrete_status1_{params_, kStatus1};
 
  protected:
   tNMEA2000* nmea2000_;
   uint8_t transmission_instance_;
   unsigned int repeat_interval_;
-  unsigned int expiry_;
-
-  std::shared_ptr<sensesp::RepeatExpiring<int>> gear_code_;
 
- private:
-  void initialize_members(unsigned int repeat, unsigned int exp) {
-    gear_code_ = std::make_shared<sensesp::RepeatExpiring<int>>(repeat, exp);
-    oil_pressure_pa_ = std::make_shared<sensesp::RepeatExpiring<double>>(repeat, exp);
-    oil_temp_k_ = std::make_shared<sensesp::RepeatExpiring<double>>(repeat, exp);
-    discrete_status1_ = std::make_shared<sensesp::RepeatExpiring<unsigned char>>(repeat, exp);
-
-    gear_.connect_to(gear_code_);
-  }
+  N2kTransmitPolicy policy_{127493, 2000, 10000};
+  N2kMsgTemplate msg_{[this](tN2kMsg& msg) {
+    SetN2kPGN127493(
+        msg,
+        transmission_instance_,
+        static_cast<tN2kTransmissionGear>(gear_.value_or(3)),
+        oil_pressure_pa_.value_or(N2kDoubleNA),
+        oil_temp_k_.value_or(N2kDoubleNA),
+        discrete_status1_.value_or(0)
+    );
+  }};
 };
 
 const String ConfigSchema(const N2kTransmissionSender& obj) {
@@ -700,6 +678,10 @@ const String ConfigSchema(const N2kTransmissionSender& obj) {
  * Sends magnetic heading.
  */
 class N2kHeadingSender : public sensesp::FileSystemSaveable {
+ protected:
+  enum Param : uint8_t { kHeading, kNumParams };
+  N2kParamTable<kNumParams> params_{1000};  // ms — input timeout
+
  public:
   N2kHeadingSender(
       String config_path,
@@ -707,26 +689,15 @@ class N2kHeadingSender : public sensesp::FileSystemSaveable {
   )
       : sensesp::FileSystemSaveable{config_path},
         nmea2000_{nmea2000},
-        repeat_interval_{100},  // ms — NMEA 2000 standard
-        expiry_{1000}           // ms — input timeout
+        repeat_interval_{100}  // ms — NMEA 2000 standard
   {
-    this->initialize_members(repeat_interval_, expiry_);
-
-    heading_.connect_to(
-        new sensesp::LambdaTransform<double, double>(
-            [](double deg) { return deg * DEG_TO_RAD; })  // Convert to radians
-    )->connect_to(heading_rad_);
-
-    sensesp::event_loop()->onRepeat(repeat_interval_, [this]() {
-      tN2kMsg N2kMsg;
-      SetN2kMagneticHeading(
-          N2kMsg,
-          this->sid_++,
-          this->heading_rad_->get(),
-          0.0,  // Deviation (not available)
-          0.0   // Variation (not available)
-      );
-      this->nmea2000_->SendMsg(N2kMsg);
+    msg_.field(kHeading, 1, N2kField::kUDouble2, 0.0001);
+
+    n2k_scheduler()->add(repeat_interval_, N2kFrameCount(8), [this]() {
+      params_.sweep(millis());
+      const tN2kMsg& msg = msg_.update(params_);
+      msg_.set_byte(0, this->sid_++);
+      N2kBusSend(this->nmea2000_, msg);
     });
   }
 
@@ -744,22 +715,21 @@ class N2kHeadingSender : public sensesp::FileSystemSaveable {
   // --------------------------------------------------------------------
   // INPUTS
   // --------------------------------------------------------------------
-  sensesp::ObservableValue<double> heading_;  // Degrees
+  N2kParam<double> heading_{params_, kHeading, DEG_TO_RAD};  // Degrees → rad
 
  protected:
   unsigned int repeat_interval_;
-  unsigned int expiry_;
   tNMEA2000* nmea2000_;
   uint8_t sid_ = 0;
-
-  std::shared_ptr<sensesp::RepeatExpiring<double>> heading_rad_;
-
- private:
-  void initialize_members(unsigned int repeat_interval, unsigned int expiry) {
-    heading_rad_ = std::make_shared<sensesp::RepeatExpiring<double>>(
-        repeat_interval, expiry
-    );
-  }
+  N2kMsgTemplate msg_{[this](tN2kMsg& msg) {
+    SetN2kMagneticHeading(
+        msg,
+        this->sid_,
+        this->heading_.value_or(N2kDoubleNA),
+        0.0,  // Deviation (not available)
+        0.0   // Variation (not available)
+    );
+  }};
 };
 
 const String ConfigSchema(const N2kHeadingSender& obj) {
@@ -775,6 +745,10 @@ const String ConfigSchema(const N2kHeadingSender& obj) {
  * Sends pitch and roll angles.
  */
 class N2kAttitudeSender : public sensesp::FileSystemSaveable {
+ protected:
+  enum Param : uint8_t { kPitch, kRoll, kYaw, kNumParams };
+  N2kParamTable<kNumParams> params_{1000};  // ms — input timeout
+
  public:
   N2kAttitudeSender(
       String config_path,
@@ -782,31 +756,16 @@ class N2kAttitudeSender : public sensesp::FileSystemSaveable {
   )
       : sensesp::FileSystemSaveable{config_path},
         nmea2000_{nmea2000},
-        repeat_interval_{100},  // ms — NMEA 2000 standard
-        expiry_{1000}           // ms — input timeout
+        repeat_interval_{100}  // ms — NMEA 2000 standard
   {
-    this->initialize_members(repeat_interval_, expiry_);
-
-    pitch_.connect_to(
-        new sensesp::LambdaTransform<double, double>(
-            [](double deg) { return deg * DEG_TO_RAD; })  // Convert to radians
-    )->connect_to(pitch_rad_);
-
-    roll_.connect_to(
-        new sensesp::LambdaTransform<double, double>(
-            [](double deg) { return deg * DEG_TO_RAD; })  // Convert to radians
-    )->connect_to(roll_rad_);
-
-    sensesp::event_loop()->onRepeat(repeat_interval_, [this]() {
-      tN2kMsg N2kMsg;
-      SetN2kAttitude(
-          N2kMsg,
-          this->sid_++,
-          this->roll_rad_->get(),
-          this->pitch_rad_->get(),
-          N2kDoubleNA  // Yaw not used, heading is separate
-      );
-      this->nmea2000_->SendMsg(N2kMsg);
+    msg_.field(kPitch, 3, N2kField::kDouble2, 0.0001);
+    msg_.field(kRoll, 5, N2kField::kDouble2, 0.0001);
+
+    n2k_scheduler()->add(repeat_interval_, N2kFrameCount(7), [this]() {
+      params_.sweep(millis());
+      const tN2kMsg& msg = msg_.update(params_);
+      msg_.set_byte(0, this->sid_++);
+      N2kBusSend(this->nmea2000_, msg);
     });
   }
 
@@ -824,32 +783,23 @@ class N2kAttitudeSender : public sensesp::FileSystemSaveable {
   // --------------------------------------------------------------------
   // INPUTS
   // --------------------------------------------------------------------
-  sensesp::ObservableValue<double> pitch_;  // Degrees
-  sensesp::ObservableValue<double> roll_;   // Degrees
-  sensesp::ObservableValue<double> yaw_;    // Degrees (optional, can be N/A)
+  N2kParam<double> pitch_{params_, kPitch, DEG_TO_RAD};  // Degrees → rad
+  N2kParam<double> roll_{params_, kRoll, DEG_TO_RAD};    // Degrees → rad
+  N2kParam<double> yaw_{params_, kYaw, DEG_TO_RAD};      // Degrees (optional, can be N/A)
 
  protected:
   unsigned int repeat_interval_;
-  unsigned int expiry_;
   tNMEA2000* nmea2000_;
   uint8_t sid_ = 0;
-
-  std::shared_ptr<sensesp::RepeatExpiring<double>> pitch_rad_;
-  std::shared_ptr<sensesp::RepeatExpiring<double>> roll_rad_;
-  std::shared_ptr<sensesp::RepeatExpiring<double>> yaw_rad_;
-
- private:
-  void initialize_members(unsigned int repeat_interval, unsigned int expiry) {
-    pitch_rad_ = std::make_shared<sensesp::RepeatExpiring<double>>(
-        repeat_interval, expiry
-    );
-    roll_rad_ = std::make_shared<sensesp::RepeatExpiring<double>>(
-        repeat_interval, expiry
-    );
-    yaw_rad_ = std::make_shared<sensesp::RepeatExpiring<double>>(
-        repeat_interval, expiry
-    );
-  }
+  N2kMsgTemplate msg_{[this](tN2kMsg& msg) {
+    SetN2kAttitude(
+        msg,
+        this->sid_,
+        N2kDoubleNA,  // Yaw not used, heading is separate
+        this->pitch_.value_or(N2kDoubleNA),
+        this->roll_.value_or(N2kDoubleNA)
+    );
+  }};
 };
 
 const String ConfigSchema(const N2kAttitudeSender& obj) {
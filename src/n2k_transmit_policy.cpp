@@ -0,0 +1,66 @@
+// src/n2k_transmit_policy.cpp
+//
+// Deadband / heartbeat / quiescent send decisions for periodic PGNs.
+
+#include "n2k_transmit_policy.h"
+
+#include <cmath>
+
+namespace halmet {
+
+N2kTransmitPolicy* N2kTransmitPolicy::first_ = nullptr;
+
+N2kTransmitPolicy::N2kTransmitPolicy(uint32_t pgn, uint32_t heartbeat_ms,
+                                     uint32_t quiescent_ms)
+    : pgn_{pgn},
+      heartbeat_ms_{heartbeat_ms},
+      quiescent_ms_{quiescent_ms},
+      next_{first_} {
+  first_ = this;
+}
+
+void N2kTransmitPolicy::value(int field, double v, bool valid) {
+  Field& f = fields_[field];
+  f.current = v;
+  f.valid = valid;
+  if (field >= num_fields_) num_fields_ = field + 1;
+  if (valid != f.sent_valid ||
+      (valid && std::fabs(v - f.sent) > f.deadband)) {
+    changed_ = true;
+  }
+}
+
+bool N2kTransmitPolicy::should_send(uint32_t now_ms) {
+  stats_.evaluated++;
+  bool any_valid = false;
+  for (int i = 0; i < num_fields_; i++) {
+    if (!fields_[i].discrete && fields_[i].valid) any_valid = true;
+  }
+
+  uint32_t interval = any_valid ? heartbeat_ms_ : quiescent_ms_;
+  bool send;
+  if (!ever_sent_ || changed_) {
+    send = true;
+    stats_.on_change++;
+  } else if (heartbeat_ms_ == 0 || now_ms - last_sent_ms_ >= interval) {
+    send = true;
+    stats_.heartbeats++;
+    if (!any_valid) stats_.quiescent++;
+  } else {
+    send = false;
+    stats_.suppressed++;
+  }
+  changed_ = false;
+
+  if (send) {
+    for (int i = 0; i < num_fields_; i++) {
+      fields_[i].sent = fields_[i].current;
+      fields_[i].sent_valid = fields_[i].valid;
+    }
+    ever_sent_ = true;
+    last_sent_ms_ = now_ms;
+  }
+  return send;
+}
+
+}  // namespace halmet
@@ -0,0 +1,92 @@
+#ifndef HALMET_SRC_N2K_TRANSMIT_POLICY_H_
+#define HALMET_SRC_N2K_TRANSMIT_POLICY_H_
+
+#include <cstdint>
+
+namespace halmet {
+
+struct N2kTransmitStats {
+  uint32_t evaluated = 0;   // scheduler intervals considered
+  uint32_t on_change = 0;   // sent because a value left its deadband
+  uint32_t heartbeats = 0;  // sent because nothing was sent for a heartbeat
+  uint32_t quiescent = 0;   // heartbeats sent with every input expired
+  uint32_t suppressed = 0;  // intervals with nothing to send
+};
+
+/**
+ * @brief Send-on-change decision for one periodic PGN.
+ *
+ * Each interval the sender offers the current value of every field, then
+ * asks should_send(). The PGN goes out at once when a measurement moves
+ * further than its deadband from the value last sent, becomes valid or
+ * expires, or when any discrete bit changes. Otherwise it is repeated
+ * only as a heartbeat every heartbeat_ms, or every quiescent_ms while no
+ * measurement is valid (engine off, tank sender unplugged).
+ *
+ * heartbeat_ms = 0 sends every interval, like a plain periodic sender.
+ *
+ * Policies link themselves into a list at construction so the status page
+ * can report per-PGN counters; they are meant to live as long as the
+ * senders that own them.
+ */
+class N2kTransmitPolicy {
+ public:
+  static constexpr int kMaxFields = 12;
+
+  N2kTransmitPolicy(uint32_t pgn, uint32_t heartbeat_ms,
+                    uint32_t quiescent_ms);
+
+  void configure(uint32_t heartbeat_ms, uint32_t quiescent_ms) {
+    heartbeat_ms_ = heartbeat_ms;
+    quiescent_ms_ = quiescent_ms;
+  }
+  void set_deadband(int field, double deadband) {
+    fields_[field].deadband = deadband;
+  }
+
+  // A measurement; only these decide whether the PGN is quiescent.
+  void value(int field, double v, bool valid);
+  // Discrete status bits; any change is sent immediately.
+  void bits(int field, uint32_t b) {
+    fields_[field].discrete = true;
+    value(field, b, true);
+  }
+
+  // Call once per interval after offering every field.
+  bool should_send(uint32_t now_ms);
+
+  uint32_t pgn() const { return pgn_; }
+  uint32_t heartbeat_ms() const { return heartbeat_ms_; }
+  uint32_t quiescent_ms() const { return quiescent_ms_; }
+  const N2kTransmitStats& stats() const { return stats_; }
+
+  static N2kTransmitPolicy* first() { return first_; }
+  N2kTransmitPolicy* next() const { return next_; }
+
+ private:
+  struct Field {
+    double current = 0;
+    double sent = 0;
+    double deadband = 0;
+    bool valid = false;
+    bool sent_valid = false;
+    bool discrete = false;
+  };
+
+  uint32_t pgn_;
+  uint32_t heartbeat_ms_;
+  uint32_t quiescent_ms_;
+  Field fields_[kMaxFields];
+  int num_fields_ = 0;
+  bool changed_ = false;
+  bool ever_sent_ = false;
+  uint32_t last_sent_ms_ = 0;
+  N2kTransmitStats stats_;
+
+  N2kTransmitPolicy* next_;
+  static N2kTransmitPolicy* first_;
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_N2K_TRANSMIT_POLICY_H_
@@ -0,0 +1,116 @@
+#ifndef HALMET_SRC_NMEA0183_DISPATCH_H_
+#define HALMET_SRC_NMEA0183_DISPATCH_H_
+
+#include <cstdint>
+
+#include "nmea0183_sentence.h"
+
+namespace halmet {
+
+// ----------------------------------------------------------------
+// SENTENCE KEYS
+//
+// Talker sentences are keyed by their 3-character formatter only, so
+// "GPRMC", "GNRMC" and "GARMC" all map to "RMC". Proprietary sentences
+// ('P' + manufacturer) are keyed by their first four characters ("PSRT").
+// ----------------------------------------------------------------
+
+constexpr uint32_t PackSentenceKey(const char* p, int len) {
+  uint32_t key = 0;
+  for (int i = 0; i < len && i < 4; i++) key = key << 8 | (uint8_t)p[i];
+  return key;
+}
+
+// Any other address, e.g. a bare "RMC", gets key 0, which nothing matches.
+constexpr uint32_t SentenceKey(const char* addr, int len) {
+  if (len > 0 && addr[0] == 'P') return PackSentenceKey(addr, len);
+  return len == 5 ? PackSentenceKey(addr + 2, 3) : 0;
+}
+
+// Key for a registration string: a formatter ("RMC") or proprietary
+// address ("PSRT").
+constexpr uint32_t SentenceKey(const char* s) {
+  int len = 0;
+  while (s[len]) len++;
+  return PackSentenceKey(s, len);
+}
+
+inline uint32_t SentenceKey(const NmeaField& addr) {
+  return SentenceKey(addr.p, addr.len);
+}
+
+/**
+ * @brief Sentence dispatcher backed by a compile-time perfect hash.
+ *
+ * Built as a constexpr object from {key, handler} pairs. The constructor
+ * searches for a multiplier under which every key lands in its own
+ * bucket of a kBuckets-entry table, so a lookup is one multiply, one
+ * shift and one key compare. Adding a sentence type is one more entry;
+ * valid() fails (and the static_assert at the definition with it) if no
+ * collision-free multiplier exists, in which case grow kBuckets.
+ */
+template <typename Handler, int kBuckets>
+class SentenceDispatcher {
+  static_assert((kBuckets & (kBuckets - 1)) == 0,
+                "kBuckets must be a power of two");
+
+ public:
+  struct Entry {
+    const char* name;  // formatter or proprietary address
+    Handler handler;
+  };
+
+  template <int kEntries>
+  constexpr SentenceDispatcher(const Entry (&entries)[kEntries]) {
+    static_assert(kEntries <= kBuckets, "more entries than buckets");
+    uint32_t m = 0x9E3779B1u;
+    for (int attempt = 0; attempt < 256; attempt++, m += 0x6A09E668u) {
+      if (try_multiplier(entries, kEntries, m)) {
+        multiplier_ = m;
+        return;
+      }
+    }
+  }
+
+  constexpr bool valid() const { return multiplier_ != 0; }
+
+  // Handler for a sentence address, or nullptr if none is registered.
+  constexpr Handler find(uint32_t key) const {
+    const Slot& slot = table_[bucket(key, multiplier_)];
+    return slot.key == key ? slot.handler : nullptr;
+  }
+
+ private:
+  struct Slot {
+    uint32_t key = 0;
+    Handler handler = nullptr;
+  };
+
+  static constexpr int kShift = [] {
+    int s = 32;
+    for (int n = kBuckets; n > 1; n >>= 1) s--;
+    return s;
+  }();
+
+  static constexpr uint32_t bucket(uint32_t key, uint32_t m) {
+    return kBuckets > 1 ? (key * m) >> kShift : 0;
+  }
+
+  constexpr bool try_multiplier(const Entry* entries, int n, uint32_t m) {
+    for (Slot& slot : table_) slot = Slot{};
+    for (int i = 0; i < n; i++) {
+      uint32_t key = SentenceKey(entries[i].name);
+      Slot& slot = table_[bucket(key, m)];
+      if (slot.handler) return false;
+      slot = Slot{key, entries[i].handler};
+    }
+    return true;
+  }
+
+  Slot table_[kBuckets] = {};
+  uint32_t multiplier_ = 0;
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_NMEA0183_DISPATCH_H_
@@ -0,0 +1,118 @@
+// src/nmea0183_sentence.cpp
+//
+// Single-pass NMEA 0183 tokenizer and bounded fixed-point number parsers.
+
+#include "nmea0183_sentence.h"
+
+namespace halmet {
+
+const NmeaField Nmea0183Sentence::kEmpty;
+
+static int hex_value(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+bool Nmea0183Sentence::parse(const char* line) {
+  num_fields_ = 0;
+  start_ = line[0];
+  if (start_ != '$' && start_ != '!') return false;
+
+  // Field lengths are stored in a uint8_t, so a longer field anywhere
+  // rejects the sentence rather than wrapping.
+  uint8_t cksum = 0;
+  const char* field_start = line + 1;
+  const char* p = line + 1;
+  for (; *p && *p != '*'; p++) {
+    cksum ^= (uint8_t)*p;
+    if (*p == ',') {
+      if (num_fields_ == kMaxFields - 1 || p - field_start > 255) {
+        num_fields_ = 0;
+        return false;
+      }
+      fields_[num_fields_].p = field_start;
+      fields_[num_fields_].len = (uint8_t)(p - field_start);
+      num_fields_++;
+      field_start = p + 1;
+    }
+  }
+  if (*p != '*' || p - field_start > 255) {
+    num_fields_ = 0;
+    return false;
+  }
+  fields_[num_fields_].p = field_start;
+  fields_[num_fields_].len = (uint8_t)(p - field_start);
+  num_fields_++;
+
+  int hi = hex_value(p[1]);
+  int lo = (hi < 0) ? -1 : hex_value(p[2]);
+  if (lo < 0 || ((hi << 4) | lo) != cksum) {
+    num_fields_ = 0;
+    return false;
+  }
+  return true;
+}
+
+bool ParseUnsigned(const NmeaField& f, uint32_t* out) {
+  if (f.len == 0 || f.len > 9) return false;
+  uint32_t v = 0;
+  for (int i = 0; i < f.len; i++) {
+    unsigned d = (unsigned)(f.p[i] - '0');
+    if (d > 9) return false;
+    v = v * 10 + d;
+  }
+  *out = v;
+  return true;
+}
+
+bool ParseFixed(const NmeaField& f, int decimals, int32_t* out) {
+  int i = 0;
+  bool neg = false;
+  if (i < f.len && (f.p[i] == '-' || f.p[i] == '+')) {
+    neg = f.p[i] == '-';
+    i++;
+  }
+  int64_t v = 0;
+  int digits = 0;
+  for (; i < f.len && f.p[i] != '.'; i++) {
+    unsigned d = (unsigned)(f.p[i] - '0');
+    if (d > 9 || ++digits > 10) return false;
+    v = v * 10 + d;
+  }
+  int frac = 0;
+  if (i < f.len) {
+    for (i++; i < f.len; i++) {
+      unsigned d = (unsigned)(f.p[i] - '0');
+      if (d > 9) return false;
+      if (frac < decimals) {
+        v = v * 10 + d;
+        frac++;
+      }
+      digits++;
+    }
+  }
+  if (digits == 0) return false;
+  for (; frac < decimals; frac++) v *= 10;
+  if (v > INT32_MAX) return false;
+  *out = (int32_t)(neg ? -v : v);
+  return true;
+}
+
+bool ParseLatLonE7(const NmeaField& value, const NmeaField& hemi,
+                   int32_t* e7) {
+  int32_t raw;  // DDMM.MMMMM × 10^5
+  if (!ParseFixed(value, 5, &raw) || raw < 0) return false;
+  int32_t deg = raw / 10000000;
+  int32_t min = raw - deg * 10000000;  // minutes × 10^5
+  if (deg > 180 || min >= 6000000) return false;
+  // minutes × 10^5 → degrees × 10^7 is × 100 / 60 = × 5 / 3, rounded
+  int32_t v = deg * 10000000 + (min * 5 + 1) / 3;
+  bool lat = hemi.ch() == 'N' || hemi.ch() == 'S';
+  if (v > (lat ? 900000000 : 1800000000)) return false;
+  *e7 = (hemi.ch() == 'S' || hemi.ch() == 'W') ? -v : v;
+  return true;
+}
+
+}  // namespace halmet
@@ -0,0 +1,86 @@
+#ifndef HALMET_SRC_NMEA0183_SENTENCE_H_
+#define HALMET_SRC_NMEA0183_SENTENCE_H_
+
+#include <cstdint>
+#include <cstring>
+
+namespace halmet {
+
+/**
+ * @brief One comma-separated field of an NMEA 0183 sentence.
+ *
+ * Points into the receive buffer; nothing is copied or NUL-terminated.
+ */
+struct NmeaField {
+  const char* p = "";
+  uint8_t len = 0;
+
+  bool empty() const { return len == 0; }
+  // First character, or '\0' for an empty field.
+  char ch() const { return len ? p[0] : '\0'; }
+  bool equals(const char* s) const {
+    return strlen(s) == len && memcmp(p, s, len) == 0;
+  }
+};
+
+/**
+ * @brief Checksum-validated, zero-copy NMEA 0183 tokenizer.
+ *
+ * A single pass over the line XORs the checksum and records field
+ * boundaries. Field 0 is the address ("GPRMC", "AIVDM", "PSRT", ...)
+ * without the leading '$' or '!'.
+ */
+class Nmea0183Sentence {
+ public:
+  static constexpr int kMaxFields = 24;
+
+  /**
+   * @brief Tokenize a NUL-terminated line (without CR/LF).
+   *
+   * @return false if the start character, field count or "*hh" checksum is
+   *   wrong; the sentence must then be discarded.
+   */
+  bool parse(const char* line);
+
+  char start() const { return start_; }
+  int num_fields() const { return num_fields_; }
+
+  // Field `i`, or an empty field if the sentence is shorter.
+  const NmeaField& field(int i) const {
+    return (i >= 0 && i < num_fields_) ? fields_[i] : kEmpty;
+  }
+  const NmeaField& address() const { return field(0); }
+
+ private:
+  static const NmeaField kEmpty;
+
+  char start_ = 0;
+  int num_fields_ = 0;
+  NmeaField fields_[kMaxFields];
+};
+
+// ----------------------------------------------------------------
+// BOUNDED NUMBER PARSERS
+//
+// Replace atoi/atof: they never read past the field, reject anything that
+// isn't a plain decimal number and fail on empty fields instead of
+// returning 0.
+// ----------------------------------------------------------------
+
+// Unsigned decimal integer, at most 9 digits.
+bool ParseUnsigned(const NmeaField& f, uint32_t* out);
+
+// Signed decimal scaled by 10^decimals: "12.3456" with decimals = 2 gives
+// 1234. Extra fraction digits are truncated. Fails if the result would not
+// fit in int32_t.
+bool ParseFixed(const NmeaField& f, int decimals, int32_t* out);
+
+// Latitude/longitude "DDMM.MMMMM" / "DDDMM.MMMMM" plus its N/S/E/W field
+// as 1e-7 degrees, without going through floating point. Minutes beyond 5
+// decimals are truncated. Fails beyond 90° for N/S or 180° for E/W.
+bool ParseLatLonE7(const NmeaField& value, const NmeaField& hemi,
+                   int32_t* e7);
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_NMEA0183_SENTENCE_H_
@@ -0,0 +1,62 @@
+// src/nmea0183_tcp_server.cpp
+//
+// NMEA 0183 TCP fan-out server.
+
+#include "nmea0183_tcp_server.h"
+
+#include <lwip/sockets.h>
+
+namespace halmet {
+
+// Non-blocking send on the client's socket: 0 when the TCP send buffer is
+// full, -1 once the connection is gone. WiFiClient::write() would instead
+// wait for room.
+static long SendNonBlocking(int fd, const char* data, size_t len) {
+  int n = send(fd, data, len, MSG_DONTWAIT);
+  if (n >= 0) return n;
+  return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+}
+
+void Nmea0183TcpServer::begin() {
+  server_.begin();
+  server_.setNoDelay(true);
+}
+
+void Nmea0183TcpServer::accept() {
+  WiFiClient client = server_.accept();
+  if (!client) return;
+  int reader = fanout_.open();
+  if (reader < 0) {
+    client.stop();  // all slots taken
+    return;
+  }
+  clients_[reader] = client;
+}
+
+void Nmea0183TcpServer::disconnect(int i) {
+  clients_[i].stop();
+  fanout_.close(i);
+}
+
+void Nmea0183TcpServer::loop() {
+  accept();
+  for (int i = 0; i < kMaxClients; i++) {
+    if (!fanout_.is_open(i)) continue;
+    int fd = clients_[i].fd();
+    bool ok = fd >= 0 && fanout_.drain(i, [fd](const char* data, size_t len) {
+      return SendNonBlocking(fd, data, len);
+    });
+    if (!ok) {
+      disconnects_++;
+      disconnect(i);
+    }
+  }
+}
+
+int Nmea0183TcpServer::clients() const {
+  int n = 0;
+  for (int i = 0; i < kMaxClients; i++) n += fanout_.is_open(i);
+  return n;
+}
+
+}  // namespace halmet
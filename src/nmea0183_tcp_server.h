@@ -0,0 +1,51 @@
+#ifndef HALMET_SRC_NMEA0183_TCP_SERVER_H_
+#define HALMET_SRC_NMEA0183_TCP_SERVER_H_
+
+#include <WiFi.h>
+
+#include "sentence_fanout.h"
+
+namespace halmet {
+
+/**
+ * @brief Raw NMEA 0183 over TCP, the way navigation apps expect it on
+ *   port 10110.
+ *
+ * Every validated sentence the gateway reads is pushed once into a shared
+ * SentenceFanout; loop() accepts new connections and writes each client's
+ * backlog with non-blocking sends. A client that can't keep up loses its
+ * oldest lines instead of stalling the UART path.
+ */
+class Nmea0183TcpServer {
+ public:
+  static constexpr int kMaxClients = 8;
+  static constexpr uint16_t kDefaultPort = 10110;
+
+  explicit Nmea0183TcpServer(uint16_t port = kDefaultPort)
+      : server_{port, kMaxClients} {}
+
+  void begin();
+
+  // Queue one sentence (without terminator) for all connected clients.
+  void push(const char* line, int len) { fanout_.push(line, len); }
+
+  // Accept new clients, send what's pending, drop closed connections.
+  void loop();
+
+  int clients() const;
+  uint32_t disconnects() const { return disconnects_; }
+  const SentenceFanoutStats& stats() const { return fanout_.stats(); }
+
+ private:
+  void accept();
+  void disconnect(int i);
+
+  WiFiServer server_;
+  WiFiClient clients_[kMaxClients];  // index i reads fanout_ reader i
+  SentenceFanout<64, 96, kMaxClients> fanout_;  // ~3 s of sentences at 38400
+  uint32_t disconnects_ = 0;  // connections closed on a send error
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_NMEA0183_TCP_SERVER_H_
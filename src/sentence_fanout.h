@@ -0,0 +1,119 @@
+#ifndef HALMET_SRC_SENTENCE_FANOUT_H_
+#define HALMET_SRC_SENTENCE_FANOUT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace halmet {
+
+struct SentenceFanoutStats {
+  uint32_t lines = 0;          // lines pushed
+  uint32_t bytes_sent = 0;     // summed over all readers
+  uint32_t lines_dropped = 0;  // lines readers fell too far behind to get
+};
+
+/**
+ * @brief Single-writer, multi-reader ring of text lines.
+ *
+ * Each line is stored once, CR/LF terminated; every reader only keeps a
+ * sequence cursor and a byte offset into its current line. The writer
+ * never waits for readers: a reader more than kSlots lines behind has its
+ * cursor moved up to the oldest line still held and the skipped lines are
+ * counted as dropped. If that cuts through a partially sent line, the
+ * reader sees one truncated sentence, which fails its checksum downstream.
+ *
+ * Not thread-safe; writer and readers run in the same task.
+ */
+template <int kSlots, int kLineLen, int kReaders>
+class SentenceFanout {
+  static_assert((kSlots & (kSlots - 1)) == 0, "kSlots must be a power of two");
+
+ public:
+  // Append a line (without terminator); over-long lines are dropped.
+  void push(const char* line, int len) {
+    if (len <= 0 || len > kLineLen - 2) return;
+    Slot& slot = slots_[head_ & (kSlots - 1)];
+    memcpy(slot.text, line, len);
+    slot.text[len] = '\r';
+    slot.text[len + 1] = '\n';
+    slot.len = (uint8_t)(len + 2);
+    head_++;
+    stats_.lines++;
+  }
+
+  // Claim a reader slot; it starts at the next line pushed. -1 if full.
+  int open() {
+    for (int i = 0; i < kReaders; i++) {
+      if (!readers_[i].open) {
+        readers_[i] = Reader{true, head_, 0};
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  void close(int reader) { readers_[reader].open = false; }
+
+  bool is_open(int reader) const { return readers_[reader].open; }
+
+  /**
+   * @brief Hand a reader's backlog to `write` until it is caught up or
+   *   `write` takes less than offered.
+   *
+   * @param write Callable (const char* data, size_t len) -> size_t bytes
+   *   accepted, or a negative value if the reader's sink has failed.
+   * @return false if write reported a failure.
+   */
+  template <typename Write>
+  bool drain(int reader, Write&& write) {
+    Reader& r = readers_[reader];
+    if (head_ - r.seq > (uint32_t)kSlots) {
+      uint32_t oldest = head_ - kSlots;
+      stats_.lines_dropped += oldest - r.seq;
+      r.seq = oldest;
+      r.offset = 0;
+    }
+    while (r.seq != head_) {
+      const Slot& slot = slots_[r.seq & (kSlots - 1)];
+      size_t want = slot.len - r.offset;
+      long n = (long)write(slot.text + r.offset, want);
+      if (n < 0) return false;
+      stats_.bytes_sent += n;
+      if ((size_t)n < want) {
+        r.offset += n;
+        break;
+      }
+      r.seq++;
+      r.offset = 0;
+    }
+    return true;
+  }
+
+  // Lines a reader has yet to send in full.
+  uint32_t backlog(int reader) const { return head_ - readers_[reader].seq; }
+
+  const SentenceFanoutStats& stats() const { return stats_; }
+
+ private:
+  struct Slot {
+    char text[kLineLen];
+    uint8_t len;
+  };
+  static_assert(kLineLen <= 255, "line length must fit in uint8_t");
+
+  struct Reader {
+    bool open = false;
+    uint32_t seq = 0;     // next line to send
+    uint16_t offset = 0;  // bytes of that line already sent
+  };
+
+  Slot slots_[kSlots];
+  uint32_t head_ = 0;  // sequence number of the next line pushed
+  Reader readers_[kReaders];
+  SentenceFanoutStats stats_;
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_SENTENCE_FANOUT_H_
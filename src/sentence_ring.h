@@ -0,0 +1,73 @@
+#ifndef HALMET_SRC_SENTENCE_RING_H_
+#define HALMET_SRC_SENTENCE_RING_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+namespace halmet {
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring of text lines.
+ *
+ * Each slot holds one NUL-terminated sentence. The producer owns head_,
+ * the consumer owns tail_; each only reads the other's index, so no lock
+ * is needed between the UART event task and the main loop. When the ring
+ * is full, push() refuses the new line and counts an overrun rather than
+ * overwriting one the consumer may be reading.
+ */
+template <int kSlots, int kLineLen>
+class SentenceRing {
+  static_assert((kSlots & (kSlots - 1)) == 0, "kSlots must be a power of two");
+
+ public:
+  // Producer side. Returns false (and counts an overrun) when full.
+  bool push(const char* line, int len) {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    uint32_t tail = tail_.load(std::memory_order_acquire);
+    uint32_t used = head - tail;
+    if (used >= (uint32_t)kSlots) {
+      overruns_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (len > kLineLen - 1) len = kLineLen - 1;
+    char* slot = lines_[head & (kSlots - 1)];
+    memcpy(slot, line, len);
+    slot[len] = '\0';
+    head_.store(head + 1, std::memory_order_release);
+    if (used + 1 > high_water_.load(std::memory_order_relaxed)) {
+      high_water_.store(used + 1, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  // Consumer side: oldest line, or nullptr when empty. Valid until pop().
+  const char* front() const {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (head_.load(std::memory_order_acquire) == tail) return nullptr;
+    return lines_[tail & (kSlots - 1)];
+  }
+
+  void pop() {
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  uint32_t overruns() const {
+    return overruns_.load(std::memory_order_relaxed);
+  }
+  uint32_t high_water() const {
+    return high_water_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  char lines_[kSlots][kLineLen];
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+  std::atomic<uint32_t> overruns_{0};
+  std::atomic<uint32_t> high_water_{0};
+};
+
+}  // namespace halmet
+
+#endif  // HALMET_SRC_SENTENCE_RING_H_
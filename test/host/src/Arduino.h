@@ -0,0 +1,59 @@
+#ifndef HALMET_TEST_HOST_ARDUINO_H_
+#define HALMET_TEST_HOST_ARDUINO_H_
+
+// Host stand-in for the parts of the Arduino core that the
+// hardware-independent modules use. Time only moves when a test advances
+// it (see host.h), so replays are deterministic.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+// C linkage, as the NMEA2000 library expects on non-Arduino targets.
+extern "C" {
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+}
+
+using String = std::string;
+
+enum hardwareSerial_error_t {
+  UART_NO_ERROR,
+  UART_BREAK_ERROR,
+  UART_BUFFER_FULL_ERROR,
+  UART_FIFO_OVF_ERROR,
+  UART_FRAME_ERROR,
+  UART_PARITY_ERROR,
+};
+
+#define SERIAL_8N1 0x800001c
+
+// Serial ports never receive on the host and discard what is written;
+// tests feed sentences through AISGatewayFeedLine() instead.
+class HardwareSerial {
+ public:
+  void begin(unsigned long baud, uint32_t config = SERIAL_8N1,
+             int8_t rx_pin = -1, int8_t tx_pin = -1) {}
+  void setRxBufferSize(size_t size) {}
+  void onReceive(std::function<void()> callback, bool on_timeout_only = true) {}
+  void onReceiveError(std::function<void(hardwareSerial_error_t)> callback) {}
+  int available() { return 0; }
+  int read() { return -1; }
+  int availableForWrite() { return 256; }
+  size_t write(uint8_t c) { return 1; }
+  size_t write(const uint8_t* data, size_t len) { return len; }
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif  // HALMET_TEST_HOST_ARDUINO_H_
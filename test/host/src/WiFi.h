@@ -0,0 +1,76 @@
+#ifndef HALMET_TEST_HOST_WIFI_H_
+#define HALMET_TEST_HOST_WIFI_H_
+
+// Host stand-in for the ESP32 WiFiServer/WiFiClient on POSIX sockets, so
+// the TCP server can be exercised over loopback.
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdint>
+
+class WiFiClient {
+ public:
+  WiFiClient() = default;
+  explicit WiFiClient(int fd) : fd_{fd} {}
+
+  explicit operator bool() const { return fd_ >= 0; }
+  int fd() const { return fd_; }
+  void stop() {
+    if (fd_ >= 0) close(fd_);
+    fd_ = -1;
+  }
+
+ private:
+  int fd_ = -1;
+};
+
+// Listens on loopback only.
+class WiFiServer {
+ public:
+  WiFiServer(uint16_t port, int max_clients = 4)
+      : port_{port}, max_clients_{max_clients} {}
+  ~WiFiServer() {
+    if (fd_ >= 0) close(fd_);
+  }
+
+  void begin() {
+    fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port_);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(fd_, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+        listen(fd_, max_clients_) != 0) {
+      close(fd_);
+      fd_ = -1;
+      return;
+    }
+    fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK);
+  }
+
+  void setNoDelay(bool no_delay) { no_delay_ = no_delay; }
+
+  // Next pending connection, or an invalid client if there is none.
+  WiFiClient accept() {
+    if (fd_ < 0) return WiFiClient{};
+    int fd = ::accept(fd_, nullptr, nullptr);
+    if (fd < 0) return WiFiClient{};
+    int one = no_delay_ ? 1 : 0;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return WiFiClient{fd};
+  }
+
+ private:
+  uint16_t port_;
+  int max_clients_;
+  int fd_ = -1;
+  bool no_delay_ = false;
+};
+
+#endif  // HALMET_TEST_HOST_WIFI_H_
@@ -0,0 +1,21 @@
+#ifndef HALMET_TEST_HOST_ELAPSEDMILLIS_H_
+#define HALMET_TEST_HOST_ELAPSEDMILLIS_H_
+
+// Host stand-in for the elapsedMillis library, on the host test clock.
+
+#include <Arduino.h>
+
+class elapsedMillis {
+ public:
+  elapsedMillis(uint32_t val = 0) : ms_{millis() - val} {}
+  operator uint32_t() const { return millis() - ms_; }
+  elapsedMillis& operator=(uint32_t val) {
+    ms_ = millis() - val;
+    return *this;
+  }
+
+ private:
+  uint32_t ms_;
+};
+
+#endif  // HALMET_TEST_HOST_ELAPSEDMILLIS_H_
@@ -0,0 +1,38 @@
+// test/host/src/host.cpp
+//
+// Definitions behind the host stand-ins: the test clock, the serial
+// ports, the globals main.cpp normally provides and the N2K send path.
+
+#include "host.h"
+
+#include <Arduino.h>
+
+static uint64_t s_micros = 0;
+static HostN2kBusSink s_n2k_bus_sink = nullptr;
+
+void HostSetMicros(uint64_t us) { s_micros = us; }
+void HostAdvanceMicros(uint64_t us) { s_micros += us; }
+void HostSetN2kBusSink(HostN2kBusSink sink) { s_n2k_bus_sink = sink; }
+
+extern "C" {
+uint32_t millis() { return (uint32_t)(s_micros / 1000); }
+uint32_t micros() { return (uint32_t)s_micros; }
+void delay(uint32_t ms) { s_micros += ms * 1000ULL; }
+}
+
+HardwareSerial Serial;
+HardwareSerial Serial1;
+HardwareSerial Serial2;
+
+// main.cpp globals the gateway refers to. No bus object exists on the
+// host, so the gateway only sends while a sink is set.
+class tNMEA2000;
+tNMEA2000* nmea2000 = nullptr;
+bool ais_silent = false;
+
+// Replaces src/n2k_bus.cpp, which needs FreeRTOS and the TWAI driver.
+namespace halmet {
+bool N2kBusSend(tNMEA2000*, const tN2kMsg& msg) {
+  return s_n2k_bus_sink && s_n2k_bus_sink(msg);
+}
+}  // namespace halmet
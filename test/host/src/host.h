@@ -0,0 +1,21 @@
+#ifndef HALMET_TEST_HOST_HOST_H_
+#define HALMET_TEST_HOST_HOST_H_
+
+// Test-side controls for the host stand-ins.
+
+#include <cstdint>
+
+class tN2kMsg;
+
+// The clock behind millis() and micros(). It starts at 0 and only moves
+// when a test moves it.
+void HostSetMicros(uint64_t us);
+void HostAdvanceMicros(uint64_t us);
+inline void HostAdvanceMillis(uint32_t ms) { HostAdvanceMicros(ms * 1000ULL); }
+
+// There is no CAN bus on the host: halmet::N2kBusSend() hands every message
+// to this sink instead, and fails when none is set.
+using HostN2kBusSink = bool (*)(const tN2kMsg& msg);
+void HostSetN2kBusSink(HostN2kBusSink sink);
+
+#endif  // HALMET_TEST_HOST_HOST_H_
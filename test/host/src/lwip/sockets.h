@@ -0,0 +1,9 @@
+#ifndef HALMET_TEST_HOST_LWIP_SOCKETS_H_
+#define HALMET_TEST_HOST_LWIP_SOCKETS_H_
+
+// lwIP's BSD socket API is the POSIX one.
+
+#include <errno.h>
+#include <sys/socket.h>
+
+#endif  // HALMET_TEST_HOST_LWIP_SOCKETS_H_
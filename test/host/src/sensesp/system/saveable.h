@@ -0,0 +1,50 @@
+#ifndef HALMET_TEST_HOST_SENSESP_SYSTEM_SAVEABLE_H_
+#define HALMET_TEST_HOST_SENSESP_SYSTEM_SAVEABLE_H_
+
+// Host stand-in for SensESP's FileSystemSaveable. Nothing is persisted;
+// JsonObject only has the surface the config classes compile against.
+
+#include <Arduino.h>
+
+class JsonVariant {
+ public:
+  template <typename T>
+  bool is() const {
+    return false;
+  }
+  template <typename T>
+  operator T() const {
+    return T{};
+  }
+  template <typename T>
+  JsonVariant& operator=(const T&) {
+    return *this;
+  }
+};
+
+class JsonObject {
+ public:
+  JsonVariant operator[](const char*) const { return {}; }
+  JsonVariant operator[](const String&) const { return {}; }
+};
+
+namespace sensesp {
+
+class FileSystemSaveable {
+ public:
+  explicit FileSystemSaveable(const String& config_path)
+      : config_path_{config_path} {}
+  virtual ~FileSystemSaveable() = default;
+
+  virtual bool load() { return true; }
+  virtual bool save() { return true; }
+  virtual bool from_json(const JsonObject& config) { return true; }
+  virtual bool to_json(JsonObject& config) { return true; }
+
+ protected:
+  String config_path_;
+};
+
+}  // namespace sensesp
+
+#endif  // HALMET_TEST_HOST_SENSESP_SYSTEM_SAVEABLE_H_
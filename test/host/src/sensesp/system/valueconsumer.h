@@ -0,0 +1,18 @@
+#ifndef HALMET_TEST_HOST_SENSESP_SYSTEM_VALUECONSUMER_H_
+#define HALMET_TEST_HOST_SENSESP_SYSTEM_VALUECONSUMER_H_
+
+// Host stand-in for SensESP's ValueConsumer; tests call set() directly.
+
+namespace sensesp {
+
+template <typename T>
+class ValueConsumer {
+ public:
+  using input_type = T;
+  virtual ~ValueConsumer() = default;
+  virtual void set(const T& new_value) {}
+};
+
+}  // namespace sensesp
+
+#endif  // HALMET_TEST_HOST_SENSESP_SYSTEM_VALUECONSUMER_H_
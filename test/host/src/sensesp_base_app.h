@@ -0,0 +1,11 @@
+#ifndef HALMET_TEST_HOST_SENSESP_BASE_APP_H_
+#define HALMET_TEST_HOST_SENSESP_BASE_APP_H_
+
+// Host stand-in for SensESP's logging macros.
+
+#define debugD(...) ((void)0)
+#define debugI(...) ((void)0)
+#define debugW(...) ((void)0)
+#define debugE(...) ((void)0)
+
+#endif  // HALMET_TEST_HOST_SENSESP_BASE_APP_H_
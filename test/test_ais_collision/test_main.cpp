@@ -0,0 +1,329 @@
+// test/test_ais_collision/test_main.cpp
+//
+// AisCollisionEngine CPA/TCPA on closing, crossing, stationary, parallel
+// and diverging geometry, the alarm limits, staleness, and the cost of a
+// report with hundreds of targets in the table.
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+#include "ais_collision.h"
+
+using halmet::AisCollisionEngine;
+using halmet::AisCollisionInfo;
+using halmet::AisCollisionSettings;
+using halmet::AisTarget;
+using halmet::AisTargetTable;
+
+static constexpr int32_t kLat = 507500000;  // 50.75 N
+static constexpr int32_t kLon = -12500000;  // 1.25 W
+static constexpr int32_t kNmLatE7 = 166667;  // one nautical mile north
+
+static AisCollisionEngine s_engine;
+
+static int Dangerous(uint32_t now_ms, AisCollisionInfo* worst = nullptr) {
+  AisCollisionInfo info;
+  return s_engine.dangerous(now_ms, worst ? worst : &info);
+}
+
+void setUp() {
+  s_engine = AisCollisionEngine();
+  s_engine.configure(AisCollisionSettings{});
+}
+void tearDown() {}
+
+void test_head_on() {
+  s_engine.update_own(kLat, kLon, 10.0f, 0.0f, 1000);
+  s_engine.update_target(3, 111, kLat + 2 * kNmLatE7, kLon, 10.0f, 180.0f,
+                         1000);
+  AisCollisionInfo worst;
+  TEST_ASSERT_EQUAL_INT(1, Dangerous(1000, &worst));
+  TEST_ASSERT_EQUAL_UINT32(111, worst.mmsi);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.0f, worst.range_nm);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, worst.cpa_nm);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 6.0f, worst.tcpa_min);  // 2 nm at 20 kn
+}
+
+void test_crossing_wide_of_the_alarm() {
+  // Crossing own ship's bow 2 nm ahead: CPA 2 nm.
+  s_engine.update_own(kLat, kLon, 0.0f, 0.0f, 1000);
+  int32_t one_nm_east = (int32_t)(kNmLatE7 / 0.6322);  // cos(50.75°)
+  s_engine.update_target(3, 111, kLat + 2 * kNmLatE7, kLon + one_nm_east,
+                         10.0f, 270.0f, 1000);
+  TEST_ASSERT_EQUAL_INT(0, Dangerous(1000));
+
+  // Passing 0.3 nm off is inside the default 0.5 nm alarm.
+  s_engine.update_target(3, 111, kLat + (int32_t)(0.3f * kNmLatE7),
+                         kLon + one_nm_east, 10.0f, 270.0f, 2000);
+  AisCollisionInfo worst;
+  TEST_ASSERT_EQUAL_INT(1, Dangerous(2000, &worst));
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.3f, worst.cpa_nm);
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, 6.0f, worst.tcpa_min);  // 1 nm at 10 kn
+}
+
+void test_stationary_target_and_own_ship() {
+  // Alongside but neither moving: the geometry never changes, so there
+  // is no approach to warn about.
+  s_engine.update_own(kLat, kLon, 0.0f, 0.0f, 1000);
+  s_engine.update_target(3, 111, kLat + kNmLatE7 / 20, kLon, 0.0f, 0.0f,
+                         1000);
+  TEST_ASSERT_EQUAL_INT(0, Dangerous(1000));
+
+  // Nor when the reports lack SOG and COG altogether.
+  s_engine.update_target(3, 111, kLat + kNmLatE7 / 20, kLon, -1.0f, -1.0f,
+                         2000);
+  TEST_ASSERT_EQUAL_INT(0, Dangerous(2000));
+}
+
+void test_own_ship_closing_on_stationary_target() {
+  s_engine.update_own(kLat, kLon, 6.0f, 0.0f, 1000);
+  s_engine.update_target(3, 111, kLat + kNmLatE7, kLon, 0.0f, 0.0f, 1000);
+  AisCollisionInfo worst;
+  TEST_ASSERT_EQUAL_INT(1, Dangerous(1000, &worst));
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, 10.0f, worst.tcpa_min);  // 1 nm at 6 kn
+
+  // A drifting target with no COG is treated as stationary.
+  s_engine.update_target(3, 111, kLat + kNmLatE7, kLon, 0.5f, -1.0f, 2000);
+  TEST_ASSERT_EQUAL_INT(1, Dangerous(2000));
+}
+
+void test_parallel_course() {
+  // Same course and speed 0.1 nm apart: no relative motion.
+  s_engine.update_own(kLat, kLon, 8.0f, 45.0f, 1000);
+  s_engine.update_target(3, 111, kLat + kNmLatE7 / 10, kLon, 8.0f, 45.0f,
+                         1000);
+  TEST_ASSERT_EQUAL_INT(0, Dangerous(1000));
+
+  // Barely faster still counts as no relative motion.
+  s_engine.update_target(3, 111, kLat + kNmLatE7 / 10, kLon, 8.05f, 45.0f,
+                         2000);
+  TEST_ASSERT_EQUAL_INT(0, Dangerous(2000));
+}
+
+void test_diverging() {
+  // Close but opening: CPA is behind us.
+  s_engine.update_own(kLat, kLon, 10.0f, 0.0f, 1000);
+  s_engine.update_target(3, 111, kLat - kNmLatE7 / 10, kLon, 10.0f, 180.0f,
+                         1000);
+  TEST_ASSERT_EQUAL_INT(0, Dangerous(1000));
+
+  // Overtaking from behind is closing.
+  s_engine.update_target(3, 111, kLat - kNmLatE7 / 10, kLon, 15.0f, 0.0f,
+                         2000);
+  TEST_ASSERT_EQUAL_INT(1, Dangerous(2000));
+}
+
+void test_tcpa_horizon() {
+  // 10 nm apart closing at 20 kn: CPA in 30 min, beyond the 12 min alarm.
+  s_engine.update_own(kLat, kLon, 10.0f, 0.0f, 1000);
+  s_engine.update_target(3, 111, kLat + 10 * kNmLatE7, kLon, 10.0f, 180.0f,
+                         1000);
+  TEST_ASSERT_EQUAL_INT(0, Dangerous(1000));
+
+  AisCollisionSettings settings;
+  settings.tcpa_alarm_min = 40.0f;
+  s_engine.configure(settings);
+  s_engine.update_target(3, 111, kLat + 10 * kNmLatE7, kLon, 10.0f, 180.0f,
+                         2000);
+  TEST_ASSERT_EQUAL_INT(1, Dangerous(2000));
+}
+
+void test_worst_is_earliest() {
+  s_engine.update_own(kLat, kLon, 10.0f, 0.0f, 1000);
+  s_engine.update_target(1, 111, kLat + 3 * kNmLatE7, kLon, 10.0f, 180.0f,
+                         1000);
+  s_engine.update_target(2, 222, kLat + 1 * kNmLatE7, kLon, 10.0f, 180.0f,
+                         1000);
+  s_engine.update_target(3, 333, kLat + 2 * kNmLatE7, kLon, 10.0f, 180.0f,
+                         1000);
+  AisCollisionInfo worst;
+  TEST_ASSERT_EQUAL_INT(3, Dangerous(1000, &worst));
+  TEST_ASSERT_EQUAL_UINT32(222, worst.mmsi);
+}
+
+void test_own_fix_reassesses_nearby_targets() {
+  // Reported before own ship had a fix: nothing to compare against yet.
+  s_engine.update_target(3, 111, kLat + kNmLatE7, kLon, 10.0f, 180.0f, 1000);
+  TEST_ASSERT_EQUAL_INT(0, Dangerous(1000));
+  s_engine.update_own(kLat, kLon, 10.0f, 0.0f, 1500);
+  TEST_ASSERT_EQUAL_INT(1, Dangerous(1500));
+
+  // Own ship turns away: the target is reassessed without a new report.
+  s_engine.update_own(kLat, kLon, 10.0f, 180.0f, 2000);
+  TEST_ASSERT_EQUAL_INT(0, Dangerous(2000));
+}
+
+void test_across_antimeridian() {
+  s_engine.update_own(0, 1799990000, 10.0f, 90.0f, 1000);
+  s_engine.update_target(3, 111, 0, -1799990000, 10.0f, 270.0f, 1000);
+  AisCollisionInfo worst;
+  TEST_ASSERT_EQUAL_INT(1, Dangerous(1000, &worst));
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.12f, worst.range_nm);  // 0.002°
+}
+
+void test_stale_data() {
+  using E = AisCollisionEngine;
+  s_engine.update_own(kLat, kLon, 10.0f, 0.0f, 1000);
+  s_engine.update_target(3, 111, kLat + 2 * kNmLatE7, kLon, 10.0f, 180.0f,
+                         1000);
+  TEST_ASSERT_EQUAL_INT(1, Dangerous(1000 + E::kStaleMs - 1));
+  // The target has gone silent.
+  s_engine.update_own(kLat, kLon, 10.0f, 0.0f, 1000 + E::kStaleMs);
+  TEST_ASSERT_EQUAL_INT(0, Dangerous(1000 + E::kStaleMs));
+
+  // Own ship has lost its fix.
+  s_engine.update_target(3, 111, kLat + 2 * kNmLatE7, kLon, 10.0f, 180.0f,
+                         2 * E::kStaleMs);
+  TEST_ASSERT_EQUAL_INT(1, Dangerous(2 * E::kStaleMs));
+  TEST_ASSERT_EQUAL_INT(0, Dangerous(1000 + 2 * E::kStaleMs));
+}
+
+void test_invalid_position_drops_target() {
+  s_engine.update_own(kLat, kLon, 10.0f, 0.0f, 1000);
+  s_engine.update_target(3, 111, kLat + 2 * kNmLatE7, kLon, 10.0f, 180.0f,
+                         1000);
+  TEST_ASSERT_EQUAL_INT(1, Dangerous(1000));
+  s_engine.update_target(3, 111, 910000000, 1810000000, 10.0f, 180.0f, 2000);
+  TEST_ASSERT_EQUAL_INT(0, Dangerous(2000));
+  // And the slot is out of the grid: own-ship updates don't revive it.
+  s_engine.update_own(kLat, kLon, 10.0f, 0.0f, 3000);
+  TEST_ASSERT_EQUAL_INT(0, Dangerous(3000));
+}
+
+// The gateway's wiring: a table slot taken for a new MMSI is released in
+// the engine before anything else happens to it.
+static AisTarget* Touch(AisTargetTable& table, uint32_t mmsi, uint32_t now) {
+  bool fresh;
+  AisTarget* t = table.touch(mmsi, now, &fresh);
+  if (fresh) s_engine.release(table.index_of(t));
+  return t;
+}
+
+void test_evicted_slot_forgets_its_target() {
+  static AisTargetTable table;
+  constexpr uint32_t kMmsi = 235000001;
+  s_engine.update_own(kLat, kLon, 10.0f, 0.0f, 1000);
+  AisTarget* t = Touch(table, kMmsi, 1000);
+  int old_slot = table.index_of(t);
+  s_engine.update_target(old_slot, kMmsi, kLat + 2 * kNmLatE7, kLon, 10.0f,
+                         180.0f, 1000);
+  TEST_ASSERT_EQUAL_INT(1, Dangerous(1000));
+
+  // Static-only reports from other vessels until one of them takes the
+  // slot: it is the least recently heard in every window it is in.
+  uint32_t now = 1000, mmsi = 211000000;
+  while (table.find(kMmsi)) Touch(table, mmsi++, ++now);
+  TEST_ASSERT_TRUE(table.stats().evicted > 0);
+  TEST_ASSERT_EQUAL_INT(0, Dangerous(now));
+
+  // Back on the air from another slot, it counts once.
+  t = Touch(table, kMmsi, ++now);
+  TEST_ASSERT_TRUE(table.index_of(t) != old_slot);
+  s_engine.update_target(table.index_of(t), kMmsi, kLat + 2 * kNmLatE7, kLon,
+                         10.0f, 180.0f, now);
+  AisCollisionInfo worst;
+  TEST_ASSERT_EQUAL_INT(1, Dangerous(now, &worst));
+  TEST_ASSERT_EQUAL_UINT32(kMmsi, worst.mmsi);
+}
+
+// ----------------------------------------------------------------
+// UPDATE COST
+// ----------------------------------------------------------------
+
+using Clock = std::chrono::steady_clock;
+static volatile int s_sink;
+
+static uint32_t s_rng = 0x2545f491;
+
+static uint32_t Rand() {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng;
+}
+
+struct Track {
+  uint32_t mmsi;
+  int32_t lat_e7, lon_e7;
+  float sog_kn, cog_deg;
+};
+
+// ns per target report (table lookup plus update_target, as the gateway
+// does it), per own-ship fix and per dangerous() scan, with n targets
+// spread over 40 nm around own ship.
+static void MeasureCost(int n) {
+  s_engine = AisCollisionEngine();
+  s_engine.configure(AisCollisionSettings{});
+  std::unique_ptr<AisTargetTable> table(new AisTargetTable());
+  std::unique_ptr<Track[]> tracks(new Track[n]);
+  for (int i = 0; i < n; i++) {
+    tracks[i] = {200000000 + Rand() % 600000000,
+                 kLat + (int32_t)(Rand() % (40 * kNmLatE7)) - 20 * kNmLatE7,
+                 kLon + (int32_t)(Rand() % (64 * kNmLatE7)) - 32 * kNmLatE7,
+                 (float)(Rand() % 250) / 10.0f, (float)(Rand() % 3600) / 10.0f};
+  }
+  uint32_t now = 1000;
+  s_engine.update_own(kLat, kLon, 8.0f, 45.0f, now);
+
+  constexpr int kReports = 200000;
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < kReports; i++) {
+    Track& t = tracks[i % n];
+    t.lat_e7 += (i & 7) - 3;  // a little movement between reports
+    now += 2;
+    AisTarget* slot = Touch(*table, t.mmsi, now);
+    s_engine.update_target(table->index_of(slot), t.mmsi, t.lat_e7, t.lon_e7,
+                           t.sog_kn, t.cog_deg, now);
+  }
+  double report_ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - t0).count() /
+      kReports;
+
+  constexpr int kFixes = 20000;
+  t0 = Clock::now();
+  for (int i = 0; i < kFixes; i++) {
+    s_engine.update_own(kLat + i * 5, kLon + i * 5, 8.0f, 45.0f, now);
+  }
+  double own_ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - t0).count() /
+      kFixes;
+
+  constexpr int kScans = 20000;
+  t0 = Clock::now();
+  for (int i = 0; i < kScans; i++) s_sink = Dangerous(now);
+  double scan_ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - t0).count() /
+      kScans;
+
+  char msg[100];
+  snprintf(msg, sizeof(msg), "%4d targets %7.1f / %7.1f / %7.1f", n,
+           report_ns, own_ns, scan_ns);
+  TEST_MESSAGE(msg);
+}
+
+void test_update_cost() {
+  TEST_MESSAGE("ns per target report / own-ship fix / dangerous() scan");
+  for (int n : {50, 200, 400}) MeasureCost(n);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_head_on);
+  RUN_TEST(test_crossing_wide_of_the_alarm);
+  RUN_TEST(test_stationary_target_and_own_ship);
+  RUN_TEST(test_own_ship_closing_on_stationary_target);
+  RUN_TEST(test_parallel_course);
+  RUN_TEST(test_diverging);
+  RUN_TEST(test_tcpa_horizon);
+  RUN_TEST(test_worst_is_earliest);
+  RUN_TEST(test_own_fix_reassesses_nearby_targets);
+  RUN_TEST(test_across_antimeridian);
+  RUN_TEST(test_stale_data);
+  RUN_TEST(test_invalid_position_drops_target);
+  RUN_TEST(test_evicted_slot_forgets_its_target);
+  RUN_TEST(test_update_cost);
+  return UNITY_END();
+}
@@ -0,0 +1,391 @@
+// test/test_ais_messages/test_main.cpp
+//
+// The AIS layout tables against the field positions in ITU-R M.1371, and
+// AisDecode<Layout>() against a plain bit reader and, for cost, against
+// the hand-written get_uint/get_int decoders it replaced.
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "ais_messages.h"
+
+using namespace halmet;
+
+struct ItuField {
+  const char* name;
+  int offset;
+  int width;
+  bool is_signed;
+};
+
+// ----------------------------------------------------------------
+// ITU-R M.1371-5, Annex 8, in each layout's field order.
+// ----------------------------------------------------------------
+
+static const ItuField kItuClassAPosition[] = {
+    {"mmsi", 8, 30, false},      {"nav status", 38, 4, false},
+    {"rot", 42, 8, true},        {"sog", 50, 10, false},
+    {"accuracy", 60, 1, false},  {"lon", 61, 28, true},
+    {"lat", 89, 27, true},       {"cog", 116, 12, false},
+    {"heading", 128, 9, false},  {"second", 137, 6, false},
+    {"raim", 148, 1, false},
+};
+
+static const ItuField kItuBaseStation[] = {
+    {"mmsi", 8, 30, false},     {"year", 38, 14, false},
+    {"month", 52, 4, false},    {"day", 56, 5, false},
+    {"hour", 61, 5, false},     {"minute", 66, 6, false},
+    {"second", 72, 6, false},   {"accuracy", 78, 1, false},
+    {"lon", 79, 28, true},      {"lat", 107, 27, true},
+    {"epfd", 134, 4, false},    {"raim", 148, 1, false},
+};
+
+static const ItuField kItuStaticVoyage[] = {
+    {"mmsi", 8, 30, false},       {"imo", 40, 30, false},
+    {"ship type", 232, 8, false}, {"to bow", 240, 9, false},
+    {"to stern", 249, 9, false},  {"to port", 258, 6, false},
+    {"to stbd", 264, 6, false},   {"epfd", 270, 4, false},
+};
+
+static const ItuField kItuSarAircraft[] = {
+    {"mmsi", 8, 30, false},     {"altitude", 38, 12, false},
+    {"sog", 50, 10, false},     {"accuracy", 60, 1, false},
+    {"lon", 61, 28, true},      {"lat", 89, 27, true},
+    {"cog", 116, 12, false},    {"second", 128, 6, false},
+    {"dte", 142, 1, false},     {"raim", 147, 1, false},
+};
+
+static const ItuField kItuClassBPosition[] = {
+    {"mmsi", 8, 30, false},     {"sog", 46, 10, false},
+    {"accuracy", 56, 1, false}, {"lon", 57, 28, true},
+    {"lat", 85, 27, true},      {"cog", 112, 12, false},
+    {"heading", 124, 9, false}, {"second", 133, 6, false},
+    {"raim", 147, 1, false},
+};
+
+static const ItuField kItuClassBExtended[] = {
+    {"mmsi", 8, 30, false},       {"sog", 46, 10, false},
+    {"accuracy", 56, 1, false},   {"lon", 57, 28, true},
+    {"lat", 85, 27, true},        {"cog", 112, 12, false},
+    {"heading", 124, 9, false},   {"second", 133, 6, false},
+    {"ship type", 263, 8, false}, {"to bow", 271, 9, false},
+    {"to stern", 280, 9, false},  {"to port", 289, 6, false},
+    {"to stbd", 295, 6, false},   {"epfd", 301, 4, false},
+    {"raim", 305, 1, false},      {"dte", 306, 1, false},
+    {"assigned", 307, 1, false},
+};
+
+static const ItuField kItuAtoN[] = {
+    {"mmsi", 8, 30, false},          {"aid type", 38, 5, false},
+    {"accuracy", 163, 1, false},     {"lon", 164, 28, true},
+    {"lat", 192, 27, true},          {"to bow", 219, 9, false},
+    {"to stern", 228, 9, false},     {"to port", 237, 6, false},
+    {"to stbd", 243, 6, false},      {"epfd", 249, 4, false},
+    {"second", 253, 6, false},       {"off position", 259, 1, false},
+    {"raim", 268, 1, false},         {"virtual", 269, 1, false},
+    {"assigned", 270, 1, false},
+};
+
+static const ItuField kItuClassBStatic[] = {
+    {"mmsi", 8, 30, false},       {"part number", 38, 2, false},
+    {"ship type", 40, 8, false},  {"to bow", 132, 9, false},
+    {"to stern", 141, 9, false},  {"to port", 150, 6, false},
+    {"to stbd", 156, 6, false},   {"mothership", 132, 30, false},
+};
+
+static const ItuField kItuLongRange[] = {
+    {"mmsi", 8, 30, false},       {"accuracy", 38, 1, false},
+    {"raim", 39, 1, false},       {"nav status", 40, 4, false},
+    {"lon", 44, 18, true},        {"lat", 62, 17, true},
+    {"sog", 79, 6, false},        {"cog", 85, 9, false},
+    {"gnss", 94, 1, false},
+};
+
+// ----------------------------------------------------------------
+// A plain bit reader over the armored characters, independent of
+// AisPayload.
+// ----------------------------------------------------------------
+
+static int32_t RefField(const std::string& armored, int offset, int width,
+                        bool is_signed) {
+  uint32_t v = 0;
+  for (int i = offset; i < offset + width; i++) {
+    int c = (uint8_t)armored[i / 6] - 48;
+    if (c > 40) c -= 8;
+    v = (v << 1) | ((c >> (5 - i % 6)) & 1);
+  }
+  if (is_signed && width < 32 && (v & (1u << (width - 1))))
+    v |= ~((1u << width) - 1u);
+  return (int32_t)v;
+}
+
+static uint32_t s_rng = 0x2545f491;
+
+static uint32_t Rand() {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng;
+}
+
+template <typename Layout, size_t N>
+static void CheckLayout(const char* type, const ItuField (&itu)[N]) {
+  TEST_ASSERT_EQUAL_INT_MESSAGE(N, Layout::kCount, type);
+  for (size_t i = 0; i < N; i++) {
+    const AisField& f = Layout::kFields[i];
+    char msg[64];
+    snprintf(msg, sizeof(msg), "%s %s", type, itu[i].name);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(i, f.id, msg);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(itu[i].offset, f.offset, msg);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(itu[i].width, f.width, msg);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(itu[i].is_signed, f.is_signed, msg);
+  }
+
+  // Every field decodes like the plain reader over random payloads.
+  for (int it = 0; it < 1000; it++) {
+    std::string armored;
+    for (int i = 0; i < AisPayload::kMaxChars; i++) {
+      int v = Rand() % 64;
+      armored += (char)(v < 40 ? 48 + v : 56 + v);
+    }
+    AisPayload p;
+    TEST_ASSERT_TRUE(p.load(armored.c_str(), (int)armored.size()));
+    AisRecord<Layout> r = AisDecode<Layout>(p);
+    for (size_t i = 0; i < N; i++) {
+      TEST_ASSERT_EQUAL_INT32_MESSAGE(
+          RefField(armored, itu[i].offset, itu[i].width, itu[i].is_signed),
+          r.raw[i], itu[i].name);
+    }
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_class_a_position() {
+  CheckLayout<AisClassAPositionLayout>("type 1", kItuClassAPosition);
+}
+void test_base_station() {
+  CheckLayout<AisBaseStationLayout>("type 4", kItuBaseStation);
+}
+void test_static_voyage() {
+  CheckLayout<AisStaticVoyageLayout>("type 5", kItuStaticVoyage);
+  TEST_ASSERT_EQUAL_INT(70, AisStaticVoyageLayout::kCallsign.offset);
+  TEST_ASSERT_EQUAL_INT(7, AisStaticVoyageLayout::kCallsign.chars);
+  TEST_ASSERT_EQUAL_INT(112, AisStaticVoyageLayout::kName.offset);
+  TEST_ASSERT_EQUAL_INT(20, AisStaticVoyageLayout::kName.chars);
+}
+void test_sar_aircraft() {
+  CheckLayout<AisSarAircraftLayout>("type 9", kItuSarAircraft);
+}
+void test_class_b_position() {
+  CheckLayout<AisClassBPositionLayout>("type 18", kItuClassBPosition);
+}
+void test_class_b_extended() {
+  CheckLayout<AisClassBExtendedLayout>("type 19", kItuClassBExtended);
+  TEST_ASSERT_EQUAL_INT(143, AisClassBExtendedLayout::kName.offset);
+  TEST_ASSERT_EQUAL_INT(20, AisClassBExtendedLayout::kName.chars);
+}
+void test_aton() {
+  CheckLayout<AisAtoNLayout>("type 21", kItuAtoN);
+  TEST_ASSERT_EQUAL_INT(43, AisAtoNLayout::kName.offset);
+  TEST_ASSERT_EQUAL_INT(20, AisAtoNLayout::kName.chars);
+}
+void test_class_b_static() {
+  CheckLayout<AisClassBStaticLayout>("type 24", kItuClassBStatic);
+  TEST_ASSERT_EQUAL_INT(40, AisClassBStaticLayout::kName.offset);
+  TEST_ASSERT_EQUAL_INT(20, AisClassBStaticLayout::kName.chars);
+  TEST_ASSERT_EQUAL_INT(90, AisClassBStaticLayout::kCallsign.offset);
+  TEST_ASSERT_EQUAL_INT(7, AisClassBStaticLayout::kCallsign.chars);
+}
+void test_long_range() {
+  CheckLayout<AisLongRangeLayout>("type 27", kItuLongRange);
+}
+
+void test_decodes_recorded_report() {
+  // A Type 1 report recorded off Seattle.
+  AisPayload p;
+  TEST_ASSERT_TRUE(p.load("177KQJ5000G?tO`K>RA1wUbN0TKH", 28));
+  using L = AisClassAPositionLayout;
+  AisRecord<L> r = AisDecode<L>(p);
+  TEST_ASSERT_EQUAL_UINT32(477553000, r.get_uint<L::kMmsi>());
+  TEST_ASSERT_EQUAL_INT32(5, r.get<L::kNavStatus>());
+  TEST_ASSERT_EQUAL_INT32(0, r.get<L::kRot>());
+  TEST_ASSERT_EQUAL_INT32(0, r.get<L::kSog>());
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, -122.345833f, r.get<L::kLon>() / 600000.0f);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 47.582833f, r.get<L::kLat>() / 600000.0f);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, 51.0f, r.scaled<L::kCog>());
+  TEST_ASSERT_EQUAL_INT32(181, r.get<L::kHeading>());
+  TEST_ASSERT_EQUAL_INT32(15, r.get<L::kSecond>());
+}
+
+void test_decodes_text() {
+  // Type 5 with "HALMET" in the name and "W1AW" in the callsign, padded
+  // with '@'.
+  char bits[AisPayload::kMaxBits] = {};
+  auto put = [&](int offset, int width, uint32_t v) {
+    for (int i = 0; i < width; i++)
+      bits[offset + i] = (v >> (width - 1 - i)) & 1;
+  };
+  auto put_text = [&](const AisText& t, const char* s) {
+    for (int i = 0; i < t.chars; i++) {
+      int c = (i < (int)strlen(s)) ? s[i] : '@';
+      put(t.offset + i * 6, 6, c & 0x3F);
+    }
+  };
+  put(0, 6, 5);
+  put_text(AisStaticVoyageLayout::kName, "HALMET");
+  put_text(AisStaticVoyageLayout::kCallsign, "W1AW");
+  std::string armored;
+  for (int i = 0; i < 424; i += 6) {
+    int v = 0;
+    for (int b = 0; b < 6; b++) v = (v << 1) | bits[i + b];
+    armored += (char)(v < 40 ? 48 + v : 56 + v);
+  }
+  AisPayload p;
+  TEST_ASSERT_TRUE(p.load(armored.c_str(), (int)armored.size()));
+  char name[21], callsign[8];
+  AisDecodeText(p, AisStaticVoyageLayout::kName, name);
+  AisDecodeText(p, AisStaticVoyageLayout::kCallsign, callsign);
+  TEST_ASSERT_EQUAL_STRING("HALMET", name);
+  TEST_ASSERT_EQUAL_STRING("W1AW", callsign);
+}
+
+// ----------------------------------------------------------------
+// DECODE COST
+// ----------------------------------------------------------------
+
+using Clock = std::chrono::steady_clock;
+static volatile int32_t s_sink;
+
+// Folds every field into the sink, so none can be optimised away.
+static int32_t Fold(const int32_t* raw, int n) {
+  int32_t v = 0;
+  for (int i = 0; i < n; i++) v ^= raw[i];
+  return v;
+}
+
+template <typename Fn>
+static double NsPerCall(Fn fn) {
+  constexpr int kCalls = 200000;
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < kCalls; i++) fn(i);
+  return std::chrono::duration<double, std::nano>(Clock::now() - t0)
+             .count() /
+         kCalls;
+}
+
+// The Type 1 and Type 5 branches of DecodeAIS before the layout tables,
+// writing the same raw values in the same order.
+static void HandClassAPosition(const AisPayload& p, int32_t* raw) {
+  raw[0] = (int32_t)p.get_uint(8, 30);
+  raw[1] = (int32_t)p.get_uint(38, 4);
+  raw[2] = p.get_int(42, 8);
+  raw[3] = (int32_t)p.get_uint(50, 10);
+  raw[4] = (int32_t)p.get_uint(60, 1);
+  raw[5] = p.get_int(61, 28);
+  raw[6] = p.get_int(89, 27);
+  raw[7] = (int32_t)p.get_uint(116, 12);
+  raw[8] = (int32_t)p.get_uint(128, 9);
+  raw[9] = (int32_t)p.get_uint(137, 6);
+  raw[10] = (int32_t)p.get_uint(148, 1);
+}
+
+static void HandStaticVoyage(const AisPayload& p, int32_t* raw,
+                             char (&name)[21], char (&callsign)[8]) {
+  raw[0] = (int32_t)p.get_uint(8, 30);
+  raw[1] = (int32_t)p.get_uint(40, 30);
+  raw[2] = (int32_t)p.get_uint(232, 8);
+  raw[3] = (int32_t)p.get_uint(240, 9);
+  raw[4] = (int32_t)p.get_uint(249, 9);
+  raw[5] = (int32_t)p.get_uint(258, 6);
+  raw[6] = (int32_t)p.get_uint(264, 6);
+  raw[7] = (int32_t)p.get_uint(270, 4);
+  p.get_string(112, 20, name, sizeof(name));
+  p.get_string(70, 7, callsign, sizeof(callsign));
+}
+
+void test_decode_cost() {
+  constexpr int kPayloads = 64;
+  static AisPayload payloads[kPayloads];
+  for (AisPayload& p : payloads) {
+    std::string armored;
+    for (int i = 0; i < AisPayload::kMaxChars; i++) {
+      int v = Rand() % 64;
+      armored += (char)(v < 40 ? 48 + v : 56 + v);
+    }
+    TEST_ASSERT_TRUE(p.load(armored.c_str(), (int)armored.size()));
+  }
+
+  using A = AisClassAPositionLayout;
+  using S = AisStaticVoyageLayout;
+  // Both decoders agree before they're timed.
+  for (const AisPayload& p : payloads) {
+    int32_t raw[A::kCount];
+    HandClassAPosition(p, raw);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(raw, AisDecode<A>(p).raw, A::kCount);
+    int32_t raw5[S::kCount];
+    char name[21], callsign[8], name2[21], callsign2[8];
+    HandStaticVoyage(p, raw5, name, callsign);
+    AisRecord<S> r = AisDecode<S>(p);
+    AisDecodeText(p, S::kName, name2);
+    AisDecodeText(p, S::kCallsign, callsign2);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(raw5, r.raw, S::kCount);
+    TEST_ASSERT_EQUAL_STRING(name, name2);
+    TEST_ASSERT_EQUAL_STRING(callsign, callsign2);
+  }
+
+  double hand1 = NsPerCall([&](int i) {
+    int32_t raw[A::kCount];
+    HandClassAPosition(payloads[i % kPayloads], raw);
+    s_sink = Fold(raw, A::kCount);
+  });
+  double table1 = NsPerCall([&](int i) {
+    AisRecord<A> r = AisDecode<A>(payloads[i % kPayloads]);
+    s_sink = Fold(r.raw, A::kCount);
+  });
+  double hand5 = NsPerCall([&](int i) {
+    int32_t raw[S::kCount];
+    char name[21], callsign[8];
+    HandStaticVoyage(payloads[i % kPayloads], raw, name, callsign);
+    s_sink = Fold(raw, S::kCount) ^ name[0] ^ callsign[0];
+  });
+  double table5 = NsPerCall([&](int i) {
+    const AisPayload& p = payloads[i % kPayloads];
+    AisRecord<S> r = AisDecode<S>(p);
+    char name[21], callsign[8];
+    AisDecodeText(p, S::kName, name);
+    AisDecodeText(p, S::kCallsign, callsign);
+    s_sink = Fold(r.raw, S::kCount) ^ name[0] ^ callsign[0];
+  });
+
+  TEST_MESSAGE("ns per message: hand-written / AisDecode<Layout>");
+  char msg[80];
+  snprintf(msg, sizeof(msg), "type 1 position       %6.1f / %6.1f", hand1,
+           table1);
+  TEST_MESSAGE(msg);
+  snprintf(msg, sizeof(msg), "type 5 static, text   %6.1f / %6.1f", hand5,
+           table5);
+  TEST_MESSAGE(msg);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_class_a_position);
+  RUN_TEST(test_base_station);
+  RUN_TEST(test_static_voyage);
+  RUN_TEST(test_sar_aircraft);
+  RUN_TEST(test_class_b_position);
+  RUN_TEST(test_class_b_extended);
+  RUN_TEST(test_aton);
+  RUN_TEST(test_class_b_static);
+  RUN_TEST(test_long_range);
+  RUN_TEST(test_decodes_recorded_report);
+  RUN_TEST(test_decodes_text);
+  RUN_TEST(test_decode_cost);
+  return UNITY_END();
+}
@@ -0,0 +1,206 @@
+// test/test_ais_payload/test_main.cpp
+//
+// AisPayload against the character-by-character extraction it replaced,
+// over random payloads split into random multi-part fragments.
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "ais_payload.h"
+
+using halmet::AisPayload;
+
+// ----------------------------------------------------------------
+// REFERENCE: the original per-bit extraction straight from the armored
+// characters.
+// ----------------------------------------------------------------
+
+static uint32_t vdm_uint(const char* p, int startBit, int numBits) {
+  uint32_t v = 0;
+  for (int i = startBit; i < startBit + numBits; i++) {
+    int c = (uint8_t)p[i / 6] - 48;
+    if (c > 40) c -= 8;
+    v = (v << 1) | ((c >> (5 - i % 6)) & 1);
+  }
+  return v;
+}
+
+static int32_t vdm_int(const char* p, int startBit, int numBits) {
+  uint32_t v = vdm_uint(p, startBit, numBits);
+  if (numBits < 32 && (v & (1u << (numBits - 1))))
+    v |= ~((1u << numBits) - 1u);
+  return (int32_t)v;
+}
+
+static void vdm_str(const char* p, int startBit, int nChars,
+                    char* out, int outLen) {
+  int n = (nChars < outLen - 1) ? nChars : outLen - 1;
+  for (int i = 0; i < n; i++) {
+    int c = (int)vdm_uint(p, startBit + i * 6, 6);
+    if (c < 32) c += 64;
+    out[i] = (char)c;
+  }
+  while (n > 0 && (out[n - 1] == '@' || out[n - 1] == ' ')) n--;
+  out[n] = '\0';
+}
+
+// ----------------------------------------------------------------
+
+static uint32_t s_rng = 0x9e3779b9;
+
+static uint32_t Rand() {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng;
+}
+
+static char Armor(int v) { return (char)(v < 40 ? 48 + v : 56 + v); }
+
+static int RandomPayload(char* s) {
+  int len = 1 + Rand() % AisPayload::kMaxChars;
+  for (int i = 0; i < len; i++) s[i] = Armor(Rand() % 64);
+  s[len] = '\0';
+  return len;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_fields_match_reference() {
+  char s[AisPayload::kMaxChars + 1];
+  for (int it = 0; it < 20000; it++) {
+    int len = RandomPayload(s);
+    // Up to three fragments, as a multi-part message arrives.
+    int a = Rand() % (len + 1);
+    int b = a + Rand() % (len - a + 1);
+    AisPayload p;
+    TEST_ASSERT_TRUE(p.load(s, a));
+    TEST_ASSERT_TRUE(p.append(s + a, b - a));
+    TEST_ASSERT_TRUE(p.append(s + b, len - b));
+    TEST_ASSERT_EQUAL_INT(len * 6, p.num_bits());
+
+    for (int k = 0; k < 40; k++) {
+      int n = 1 + Rand() % 32;
+      if (n > len * 6) continue;
+      int start = Rand() % (len * 6 - n + 1);
+      TEST_ASSERT_EQUAL_UINT32(vdm_uint(s, start, n), p.get_uint(start, n));
+      TEST_ASSERT_EQUAL_INT32(vdm_int(s, start, n), p.get_int(start, n));
+    }
+  }
+}
+
+void test_strings_match_reference() {
+  char s[AisPayload::kMaxChars + 1];
+  for (int it = 0; it < 5000; it++) {
+    int len = RandomPayload(s);
+    AisPayload p;
+    TEST_ASSERT_TRUE(p.load(s, len));
+    int chars = 1 + Rand() % 20;
+    if (chars * 6 > len * 6) continue;
+    int start = Rand() % (len * 6 - chars * 6 + 1);
+    char expected[21], actual[21];
+    vdm_str(s, start, chars, expected, sizeof(expected));
+    p.get_string(start, chars, actual, sizeof(actual));
+    TEST_ASSERT_EQUAL_STRING(expected, actual);
+  }
+}
+
+void test_string_trims_padding() {
+  // "AB" followed by '@' padding and a space: 1, 2, 0, 32, 0.
+  char s[6] = {Armor(1), Armor(2), Armor(0), Armor(32), Armor(0), 0};
+  AisPayload p;
+  TEST_ASSERT_TRUE(p.load(s, 5));
+  char out[8];
+  p.get_string(0, 5, out, sizeof(out));
+  TEST_ASSERT_EQUAL_STRING("AB", out);
+  p.get_string(6, 4, out, 3);  // "B@" once truncated to fit
+  TEST_ASSERT_EQUAL_STRING("B", out);
+}
+
+void test_bits_past_end_read_zero() {
+  AisPayload p;
+  TEST_ASSERT_TRUE(p.load("wwwww", 5));
+  TEST_ASSERT_EQUAL_UINT32(0x3F, p.get_uint(24, 6));
+  TEST_ASSERT_EQUAL_UINT32(0, p.get_uint(30, 32));
+  TEST_ASSERT_EQUAL_UINT32(0x3Fu << 26, p.get_uint(24, 32));
+  // A shorter reload leaves nothing of the old payload behind.
+  TEST_ASSERT_TRUE(p.load("0", 1));
+  TEST_ASSERT_EQUAL_UINT32(0, p.get_uint(0, 32));
+  // Out-of-range requests return 0 rather than reading past the buffer.
+  TEST_ASSERT_EQUAL_UINT32(0, p.get_uint(AisPayload::kMaxBits - 4, 8));
+  TEST_ASSERT_EQUAL_UINT32(0, p.get_uint(-1, 8));
+  TEST_ASSERT_EQUAL_UINT32(0, p.get_uint(0, 0));
+}
+
+void test_rejects_characters_outside_alphabet() {
+  AisPayload p;
+  // Both the aligned four-character path and the tail.
+  for (const char* bad : {"00X0", "0_00", "000/", "x", "0\x80", "0 "}) {
+    int len = (int)strlen(bad);
+    TEST_ASSERT_FALSE_MESSAGE(p.load(bad, len), bad);
+  }
+  TEST_ASSERT_TRUE(p.load("0Ww`", 4));
+  TEST_ASSERT_EQUAL_UINT32(0x00, p.get_uint(0, 6));
+  TEST_ASSERT_EQUAL_UINT32(39, p.get_uint(6, 6));
+  TEST_ASSERT_EQUAL_UINT32(63, p.get_uint(12, 6));
+  TEST_ASSERT_EQUAL_UINT32(40, p.get_uint(18, 6));
+}
+
+void test_rejects_oversized_message() {
+  char s[AisPayload::kMaxChars + 2];
+  memset(s, '0', sizeof(s));
+  AisPayload p;
+  TEST_ASSERT_TRUE(p.load(s, AisPayload::kMaxChars));
+  TEST_ASSERT_FALSE(p.append(s, 1));
+  TEST_ASSERT_FALSE(p.load(s, AisPayload::kMaxChars + 1));
+  TEST_ASSERT_FALSE(p.load(s, -1));
+}
+
+void test_decode_speed() {
+  // A Type 1 position report: the fields every report decodes.
+  const char* t = "15M67FC000G?ufbE`FepT@3n00Sa";
+  constexpr int kN = 1000000;
+  using Clock = std::chrono::steady_clock;
+  volatile uint32_t sink = 0;
+
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < kN; i++) {
+    sink = sink + vdm_uint(t, 8, 30) + vdm_uint(t, 38, 4) +
+           vdm_uint(t, 50, 10) + vdm_int(t, 61, 28) + vdm_int(t, 89, 27) +
+           vdm_uint(t, 116, 12) + vdm_uint(t, 128, 9);
+  }
+  Clock::time_point t1 = Clock::now();
+  for (int i = 0; i < kN; i++) {
+    AisPayload p;
+    p.load(t, 28);
+    sink = sink + p.get_uint(8, 30) + p.get_uint(38, 4) +
+           p.get_uint(50, 10) + p.get_int(61, 28) + p.get_int(89, 27) +
+           p.get_uint(116, 12) + p.get_uint(128, 9);
+  }
+  Clock::time_point t2 = Clock::now();
+
+  using Ns = std::chrono::duration<double, std::nano>;
+  double old_ns = Ns(t1 - t0).count() / kN;
+  double new_ns = Ns(t2 - t1).count() / kN;
+  char report[120];
+  snprintf(report, sizeof(report),
+           "Type 1 decode: per-bit %.1f ns, dearmored %.1f ns (%.1fx)",
+           old_ns, new_ns, old_ns / new_ns);
+  TEST_MESSAGE(report);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fields_match_reference);
+  RUN_TEST(test_strings_match_reference);
+  RUN_TEST(test_string_trims_padding);
+  RUN_TEST(test_bits_past_end_read_zero);
+  RUN_TEST(test_rejects_characters_outside_alphabet);
+  RUN_TEST(test_rejects_oversized_message);
+  RUN_TEST(test_decode_speed);
+  return UNITY_END();
+}
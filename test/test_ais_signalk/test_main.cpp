@@ -0,0 +1,326 @@
+// test/test_ais_signalk/test_main.cpp
+//
+// AisSignalKTargets: reports coalesce into one delta per changed target,
+// every delta fits kMaxDeltaLen, the table stays at kMaxTargets, silent
+// targets expire and capped flushes resume where they stopped. The last
+// tests replay the dense Solent log through the gateway with main.cpp's
+// flush schedule and report the flush cost, then time a flush of a full
+// table of worst-case targets.
+
+#include <unity.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ais_gateway.h"
+#include "ais_signalk.h"
+#include "host.h"
+
+using halmet::AisSignalKTargets;
+using Clock = std::chrono::steady_clock;
+
+static constexpr int32_t kLat = 507500000;  // 50.75 N
+static constexpr int32_t kLon = -12500000;  // 1.25 W
+
+static halmet::AISGatewayConfig s_config{"/test/ais"};
+
+static const std::string kContext = "{\"context\":\"vessels.urn:mrn:imo:mmsi:";
+
+static AisSignalKTargets s_targets;
+static std::vector<std::string> s_deltas;
+
+static void Collect(const char* json, size_t len) {
+  TEST_ASSERT_EQUAL_size_t(strlen(json), len);
+  s_deltas.emplace_back(json, len);
+}
+
+// Well formed as far as the writer's output goes: balanced, closed, not
+// cut short by the buffer, and one context per delta.
+static void CheckDelta(const std::string& d) {
+  TEST_ASSERT_TRUE_MESSAGE(d.size() < AisSignalKTargets::kMaxDeltaLen - 1,
+                           d.c_str());
+  TEST_ASSERT_TRUE(d.compare(0, kContext.size(), kContext) == 0);
+  TEST_ASSERT_TRUE(d.size() > 4 && d.compare(d.size() - 4, 4, "]}]}") == 0);
+  int depth = 0, quotes = 0;
+  for (char c : d) {
+    if (c == '"') quotes++;
+    if (quotes % 2) continue;
+    if (c == '{' || c == '[') depth++;
+    if (c == '}' || c == ']') depth--;
+    TEST_ASSERT_TRUE(depth >= 0);
+  }
+  TEST_ASSERT_EQUAL_INT(0, depth);
+  TEST_ASSERT_EQUAL_INT(0, quotes % 2);
+  TEST_ASSERT_TRUE(d.find("\"context\"", 2) == std::string::npos);
+}
+
+static uint32_t ContextMmsi(const std::string& d) {
+  return (uint32_t)strtoul(d.c_str() + kContext.size(), nullptr, 10);
+}
+
+static int Flush(uint32_t now_ms, int max_deltas = 1000) {
+  s_deltas.clear();
+  int n = s_targets.flush(now_ms, 0, Collect, max_deltas);
+  TEST_ASSERT_EQUAL_INT((int)s_deltas.size(), n);
+  for (const std::string& d : s_deltas) CheckDelta(d);
+  return n;
+}
+
+void setUp() {
+  s_targets = AisSignalKTargets();
+  s_deltas.clear();
+}
+void tearDown() {}
+
+void test_reports_coalesce_per_target() {
+  for (int i = 0; i < 10; i++) {
+    s_targets.update_position(235000001, kLat + i, kLon, 6.0f + i, 45.0f,
+                              44.0f, 0, 1000 + i * 100);
+  }
+  s_targets.update_static(235000001, "SOLENT \"TEST\"", "MABC1", 70, 120, 20,
+                          2000);
+  s_targets.update_position(235000002, kLat, kLon, -1.0f, -1.0f, -1.0f, 15,
+                            2000);
+  TEST_ASSERT_EQUAL_INT(2, Flush(2000));
+
+  const std::string& d = ContextMmsi(s_deltas[0]) == 235000001
+                             ? s_deltas[0]
+                             : s_deltas[1];
+  // The latest position only, with the static data alongside.
+  TEST_ASSERT_TRUE(d.find("\"latitude\":50.7500009") != std::string::npos);
+  TEST_ASSERT_TRUE(d.find("\"value\":7.72}") != std::string::npos);  // 15 kn
+  TEST_ASSERT_TRUE(d.find("\"name\":\"SOLENT  TEST \"") != std::string::npos);
+  TEST_ASSERT_TRUE(d.find("\"communication.callsignVhf\"") !=
+                   std::string::npos);
+  TEST_ASSERT_TRUE(d.find("\"value\":\"motoring\"") != std::string::npos);
+
+  const std::string& e = &d == &s_deltas[0] ? s_deltas[1] : s_deltas[0];
+  TEST_ASSERT_EQUAL_UINT32(235000002, ContextMmsi(e));
+  TEST_ASSERT_TRUE(e.find("speedOverGround") == std::string::npos);
+  TEST_ASSERT_TRUE(e.find("navigation.state") == std::string::npos);
+
+  TEST_ASSERT_EQUAL_UINT32(12, s_targets.stats().reports);
+  TEST_ASSERT_EQUAL_UINT32(2, s_targets.stats().deltas);
+  // Nothing changed since.
+  TEST_ASSERT_EQUAL_INT(0, Flush(2500));
+}
+
+void test_capped_flush_resumes() {
+  for (uint32_t i = 0; i < 100; i++) {
+    s_targets.update_position(200000000 + i * 7919, kLat, kLon, 5.0f, 90.0f,
+                              90.0f, 0, 1000);
+  }
+  std::set<uint32_t> seen;
+  for (int round = 0; round < 4; round++) {
+    TEST_ASSERT_EQUAL_INT(round < 3 ? 32 : 4, Flush(2000 + round * 1000, 32));
+    for (const std::string& d : s_deltas) {
+      TEST_ASSERT_TRUE(seen.insert(ContextMmsi(d)).second);
+    }
+  }
+  TEST_ASSERT_EQUAL_size_t(100, seen.size());
+  TEST_ASSERT_EQUAL_INT(0, Flush(6000, 32));
+}
+
+void test_table_is_bounded() {
+  constexpr uint32_t kReported = 1000;
+  for (uint32_t i = 0; i < kReported; i++) {
+    s_targets.update_position(211000000 + i, kLat, kLon, 5.0f, 90.0f, 90.0f,
+                              0, 1000 + i);
+  }
+  const halmet::AisSignalKStats& st = s_targets.stats();
+  TEST_ASSERT_TRUE(st.targets <= (uint32_t)AisSignalKTargets::kMaxTargets);
+  TEST_ASSERT_EQUAL_UINT32(kReported, st.targets + st.evicted);
+  TEST_ASSERT_EQUAL_INT((int)st.targets, Flush(5000));
+  // The most recently heard survive eviction.
+  std::set<uint32_t> mmsis;
+  for (const std::string& d : s_deltas) mmsis.insert(ContextMmsi(d));
+  TEST_ASSERT_TRUE(mmsis.count(211000000 + kReported - 1) == 1);
+}
+
+void test_silent_targets_expire() {
+  s_targets.update_position(235000001, kLat, kLon, 5.0f, 90.0f, 90.0f, 0,
+                            1000);
+  s_targets.update_position(235000002, kLat, kLon, 5.0f, 90.0f, 90.0f, 0,
+                            1000);
+  TEST_ASSERT_EQUAL_INT(2, Flush(1000));
+  s_targets.update_position(235000002, kLat, kLon, 5.0f, 90.0f, 90.0f, 0,
+                            1000 + AisSignalKTargets::kExpireMs);
+  TEST_ASSERT_EQUAL_INT(1, Flush(1001 + AisSignalKTargets::kExpireMs));
+  TEST_ASSERT_EQUAL_UINT32(235000002, ContextMmsi(s_deltas[0]));
+  TEST_ASSERT_EQUAL_UINT32(1, s_targets.stats().expired);
+  TEST_ASSERT_EQUAL_UINT32(1, s_targets.stats().targets);
+
+  // Back after expiry: a new entry, announced again.
+  s_targets.update_position(235000001, kLat, kLon, 5.0f, 90.0f, 90.0f, 0,
+                            2000 + AisSignalKTargets::kExpireMs);
+  TEST_ASSERT_EQUAL_INT(1, Flush(2000 + AisSignalKTargets::kExpireMs));
+}
+
+// Every field present and at its longest.
+static void FillWorstCase(AisSignalKTargets* targets, uint32_t now_ms) {
+  for (int i = 0; i < AisSignalKTargets::kMaxTargets * 4; i++) {
+    uint32_t mmsi = 999999999 - i * 104729;
+    targets->update_static(mmsi, "WWWWWWWWWWWWWWWWWWWW", "WWWWWWW", 99, 511,
+                           63, now_ms);
+    targets->update_position(mmsi, -899999999, -1799999999, 102.2f, 359.9f,
+                             359.0f, 3, now_ms);
+  }
+}
+
+void test_longest_delta_fits() {
+  FillWorstCase(&s_targets, 1000);
+  TEST_ASSERT_EQUAL_INT(AisSignalKTargets::kMaxTargets, Flush(1000));
+  size_t longest = 0;
+  for (const std::string& d : s_deltas) longest = std::max(longest, d.size());
+  // Again with the timestamp, the only optional part left.
+  s_deltas.clear();
+  FillWorstCase(&s_targets, 2000);
+  s_targets.flush(2000, 4102444799999000LL, Collect, 1000);  // 2099-12-31
+  for (const std::string& d : s_deltas) {
+    CheckDelta(d);
+    TEST_ASSERT_TRUE(d.find("\"timestamp\":\"2099-12-31T23:59:59.999Z\"") !=
+                     std::string::npos);
+    longest = std::max(longest, d.size());
+  }
+  char msg[80];
+  snprintf(msg, sizeof(msg), "longest delta %zu of %zu bytes", longest,
+           AisSignalKTargets::kMaxDeltaLen);
+  TEST_MESSAGE(msg);
+}
+
+// ----------------------------------------------------------------
+// FLUSH COST
+// ----------------------------------------------------------------
+
+struct LogLine {
+  uint32_t ms;
+  std::string sentence;
+};
+
+static std::vector<LogLine> LoadLog(const std::string& path) {
+  std::vector<LogLine> log;
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    size_t space = line.find(' ');
+    if (space == std::string::npos) continue;
+    log.push_back({(uint32_t)std::stoul(line.substr(0, space)),
+                   line.substr(space + 1)});
+  }
+  return log;
+}
+
+static std::string SolentLog() {
+  std::string file = __FILE__;
+  size_t slash = file.find_last_of('/');
+  std::string dir = slash == std::string::npos ? "." : file.substr(0, slash);
+  return dir + "/../test_replay/solent.log";
+}
+
+static size_t s_delta_bytes = 0;
+
+static void CountDelta(const char* json, size_t len) {
+  TEST_ASSERT_TRUE(len < AisSignalKTargets::kMaxDeltaLen - 1);
+  TEST_ASSERT_EQUAL_INT('}', json[len - 1]);
+  s_delta_bytes += len;
+}
+
+static double Percentile(std::vector<double>& v, double p) {
+  std::sort(v.begin(), v.end());
+  return v[(size_t)(p * (v.size() - 1))];
+}
+
+void test_solent_flush_cost() {
+  std::vector<LogLine> log = LoadLog(SolentLog());
+  TEST_ASSERT_TRUE(!log.empty());
+
+  // As main.cpp does: at most 32 deltas once a second.
+  constexpr uint32_t kIntervalMs = 1000;
+  constexpr int kMaxDeltas = 32;
+  constexpr int kPasses = 20;
+  uint64_t base_ms = 1000;
+  uint32_t reports_before = AISGatewayGetStats().signalk.reports;
+  uint32_t deltas_before = AISGatewayGetStats().signalk.deltas;
+  std::vector<double> flush_us;
+  int flushes = 0;
+  s_delta_bytes = 0;
+  for (int pass = 0; pass < kPasses; pass++) {
+    uint32_t next_flush = kIntervalMs;
+    for (const LogLine& l : log) {
+      while (l.ms >= next_flush) {
+        HostSetMicros((base_ms + next_flush) * 1000ULL);
+        Clock::time_point t0 = Clock::now();
+        int n = AISGatewayFlushSignalK(CountDelta, kMaxDeltas);
+        flush_us.push_back(
+            std::chrono::duration<double, std::micro>(Clock::now() - t0)
+                .count());
+        TEST_ASSERT_TRUE(n <= kMaxDeltas);
+        flushes++;
+        next_flush += kIntervalMs;
+      }
+      HostSetMicros((base_ms + l.ms) * 1000ULL);
+      AISGatewayFeedLine(l.sentence.c_str());
+    }
+    base_ms += log.back().ms + kIntervalMs;
+  }
+  const halmet::AisSignalKStats& st = AISGatewayGetStats().signalk;
+  uint32_t reports = st.reports - reports_before;
+  uint32_t deltas = st.deltas - deltas_before;
+  TEST_ASSERT_GREATER_THAN(0, deltas);
+  // Coalescing: fewer deltas than reports, at most one per target per
+  // flush.
+  TEST_ASSERT_TRUE(deltas < reports);
+  TEST_ASSERT_TRUE(deltas <= (uint32_t)flushes * st.targets);
+
+  double p99 = Percentile(flush_us, 0.99);
+  char report[240];
+  snprintf(report, sizeof(report),
+           "%d flushes: %lu reports -> %lu deltas (%.1f per flush, %.0f B "
+           "avg), flush p50 %.2f us, p99 %.2f us, max %.2f us",
+           flushes, (unsigned long)reports, (unsigned long)deltas,
+           (double)deltas / flushes, (double)s_delta_bytes / deltas,
+           Percentile(flush_us, 0.5), p99, flush_us.back());
+  TEST_MESSAGE(report);
+}
+
+void test_full_table_flush_cost() {
+  constexpr int kRounds = 200;
+  Clock::duration total{};
+  s_delta_bytes = 0;
+  for (int r = 0; r < kRounds; r++) {
+    FillWorstCase(&s_targets, 1000 + r);
+    Clock::time_point t0 = Clock::now();
+    int n = s_targets.flush(1000 + r, 1792238400000000LL, CountDelta, 1000);
+    total += Clock::now() - t0;
+    TEST_ASSERT_EQUAL_INT(AisSignalKTargets::kMaxTargets, n);
+  }
+  double us = std::chrono::duration<double, std::micro>(total).count();
+  char report[160];
+  snprintf(report, sizeof(report),
+           "%d worst-case targets: flush %.1f us (%.2f us per delta, "
+           "%.0f B avg)",
+           AisSignalKTargets::kMaxTargets, us / kRounds,
+           us / kRounds / AisSignalKTargets::kMaxTargets,
+           (double)s_delta_bytes / kRounds / AisSignalKTargets::kMaxTargets);
+  TEST_MESSAGE(report);
+}
+
+int main(int, char**) {
+  AISGatewayInit(&s_config);
+  UNITY_BEGIN();
+  RUN_TEST(test_reports_coalesce_per_target);
+  RUN_TEST(test_capped_flush_resumes);
+  RUN_TEST(test_table_is_bounded);
+  RUN_TEST(test_silent_targets_expire);
+  RUN_TEST(test_longest_delta_fits);
+  RUN_TEST(test_solent_flush_cost);
+  RUN_TEST(test_full_table_flush_cost);
+  return UNITY_END();
+}
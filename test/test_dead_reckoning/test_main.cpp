@@ -0,0 +1,224 @@
+// test/test_dead_reckoning/test_main.cpp
+//
+// DeadReckoner replayed against simulated own-ship tracks: 1 Hz GNSS fixes
+// and a 10 Hz compass with a fixed magnetic offset, predicted at 10 Hz in
+// between and compared with the true track. Also the timeouts that stop
+// extrapolation once motion or heading data goes stale.
+
+#include <unity.h>
+
+#include <cmath>
+#include <cstdio>
+
+#include "dead_reckoning.h"
+
+using halmet::DeadReckonedFix;
+using halmet::DeadReckoner;
+
+static constexpr double kDegToRad = M_PI / 180.0;
+static constexpr double kMetresPerDegLat = 1852.0 * 60.0;
+
+// Truth, integrated in double at 1 ms steps.
+struct Track {
+  double lat_deg;
+  double lon_deg;
+  double course_deg;  // true, equal to heading: no leeway or current
+  double sog_kn;
+  double turn_deg_s;
+
+  void step_ms() {
+    double d = sog_kn * 1852.0 / 3600.0 / 1000.0;  // metres
+    double c = course_deg * kDegToRad;
+    lat_deg += d * cos(c) / kMetresPerDegLat;
+    lon_deg += d * sin(c) / (kMetresPerDegLat * cos(lat_deg * kDegToRad));
+    if (lon_deg > 180.0) lon_deg -= 360.0;
+    if (lon_deg < -180.0) lon_deg += 360.0;
+    course_deg = fmod(course_deg + turn_deg_s / 1000.0 + 360.0, 360.0);
+  }
+};
+
+static int32_t E7(double deg) { return (int32_t)lround(deg * 1e7); }
+
+static double ErrorMetres(const Track& t, int32_t lat_e7, int32_t lon_e7) {
+  double dlat = lat_e7 * 1e-7 - t.lat_deg;
+  double dlon = lon_e7 * 1e-7 - t.lon_deg;
+  if (dlon > 180.0) dlon -= 360.0;
+  if (dlon < -180.0) dlon += 360.0;
+  double dy = dlat * kMetresPerDegLat;
+  double dx = dlon * kMetresPerDegLat * cos(t.lat_deg * kDegToRad);
+  return sqrt(dx * dx + dy * dy);
+}
+
+static double CourseError(double a, double b) {
+  double d = fmod(a - b + 540.0, 360.0) - 180.0;
+  return fabs(d);
+}
+
+struct ReplayResult {
+  double max_pos_m = 0;       // dead reckoned
+  double max_hold_m = 0;      // holding the last fix
+  double max_cog_deg = 0;     // compass-steered COG
+  double max_hold_cog_deg = 0;  // holding the fix COG
+  int predictions = 0;
+};
+
+// RMC rounds SOG and COG to 0.1; the compass reads true + offset.
+static ReplayResult Replay(Track t, double compass_offset_deg,
+                           uint32_t duration_ms) {
+  DeadReckoner dr;
+  ReplayResult r;
+  int32_t fix_lat = 0, fix_lon = 0;
+  double fix_cog = 0;
+  for (uint32_t ms = 1; ms <= duration_ms; ms++) {
+    t.step_ms();
+    if (ms % 100 == 0) {
+      dr.on_heading((float)fmod(t.course_deg + compass_offset_deg + 360.0,
+                                360.0),
+                    ms);
+    }
+    if (ms % 1000 == 0) {
+      fix_lat = E7(t.lat_deg);
+      fix_lon = E7(t.lon_deg);
+      fix_cog = round(t.course_deg * 10) / 10;
+      dr.on_fix(fix_lat, fix_lon, (float)(round(t.sog_kn * 10) / 10),
+                (float)fmod(fix_cog, 360.0), ms);
+      continue;
+    }
+    // Predict halfway between compass readings, as the rapid-update
+    // timer does not run in step with the compass.
+    if (ms % 100 != 50 || ms < 1000) continue;
+
+    DeadReckonedFix fix;
+    TEST_ASSERT_TRUE(dr.predict(ms, &fix));
+    r.predictions++;
+    double e = ErrorMetres(t, fix.lat_e7, fix.lon_e7);
+    double hold = ErrorMetres(t, fix_lat, fix_lon);
+    if (e > r.max_pos_m) r.max_pos_m = e;
+    if (hold > r.max_hold_m) r.max_hold_m = hold;
+    double ce = CourseError(fix.cog_deg, t.course_deg);
+    double hce = CourseError(fix_cog, t.course_deg);
+    if (ce > r.max_cog_deg) r.max_cog_deg = ce;
+    if (hce > r.max_hold_cog_deg) r.max_hold_cog_deg = hce;
+  }
+  return r;
+}
+
+static void Report(const char* name, const ReplayResult& r) {
+  char msg[200];
+  snprintf(msg, sizeof(msg),
+           "%s: %d predictions, max error %.2f m / %.2f deg "
+           "(holding the fix: %.2f m / %.2f deg)",
+           name, r.predictions, r.max_pos_m, r.max_cog_deg, r.max_hold_m,
+           r.max_hold_cog_deg);
+  TEST_MESSAGE(msg);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_straight_track() {
+  ReplayResult r = Replay({50.75, -1.25, 45.0, 6.23, 0.0}, -2.5, 120000);
+  Report("straight 6.23 kn", r);
+  TEST_ASSERT_TRUE(r.max_pos_m < 0.5);
+  TEST_ASSERT_TRUE(r.max_cog_deg < 0.1);
+  TEST_ASSERT_TRUE(r.max_hold_m > 2.5);  // the fix alone lags ~3 m
+}
+
+void test_steady_turn() {
+  // 9.96 kn at 2.7°/s: a circle every 133 s, through north, with the
+  // compass reading 7° low so it crosses 0/360 at a different moment.
+  ReplayResult r = Replay({50.75, -1.25, 300.0, 9.96, 2.7}, -7.0, 240000);
+  Report("turning 9.96 kn at 2.7 deg/s", r);
+  TEST_ASSERT_TRUE(r.max_pos_m < 0.5);
+  // The compass reading is 50 ms old at each prediction: 0.14° behind.
+  TEST_ASSERT_TRUE(r.max_cog_deg < 0.25);
+  TEST_ASSERT_TRUE(r.max_hold_cog_deg > 2.0);
+  TEST_ASSERT_TRUE(r.max_hold_m > 4.5);
+}
+
+void test_fast_turn_across_antimeridian() {
+  ReplayResult r = Replay({-16.5, 179.999, 60.0, 24.87, -5.3}, 11.0, 60000);
+  Report("turning 24.87 kn at 5.3 deg/s over 180E", r);
+  TEST_ASSERT_TRUE(r.max_pos_m < 1.0);
+  TEST_ASSERT_TRUE(r.max_cog_deg < 0.5);
+}
+
+void test_no_fix() {
+  DeadReckoner dr;
+  DeadReckonedFix fix;
+  TEST_ASSERT_FALSE(dr.predict(1000, &fix));
+  dr.on_fix(E7(50.75), E7(-1.25), 6.0f, 90.0f, 1000);
+  TEST_ASSERT_TRUE(dr.predict(1000 + DeadReckoner::kMaxExtrapolationMs, &fix));
+  TEST_ASSERT_FALSE(
+      dr.predict(1001 + DeadReckoner::kMaxExtrapolationMs, &fix));
+}
+
+void test_stale_motion_holds_position() {
+  DeadReckoner dr;
+  DeadReckonedFix fix;
+  int32_t lat = E7(50.75), lon = E7(-1.25);
+  dr.on_fix(lat, lon, 6.0f, 90.0f, 1000);
+  TEST_ASSERT_TRUE(dr.predict(1500, &fix));
+  TEST_ASSERT_TRUE(fix.lon_e7 > lon);  // moving east
+
+  // GGA fixes keep coming, but without SOG/COG.
+  for (uint32_t ms = 2000; ms <= 6000; ms += 1000) {
+    dr.on_fix(lat, lon, -1.0f, -1.0f, ms);
+    TEST_ASSERT_TRUE(dr.predict(ms + 500, &fix));
+    bool motion_fresh = ms + 500 - 1000 <= DeadReckoner::kMaxExtrapolationMs;
+    if (motion_fresh) {
+      TEST_ASSERT_FLOAT_WITHIN(1e-6f, 6.0f, fix.sog_kn);
+      TEST_ASSERT_FLOAT_WITHIN(1e-4f, 90.0f, fix.cog_deg);
+      TEST_ASSERT_TRUE(fix.lon_e7 > lon);
+    } else {
+      TEST_ASSERT_TRUE(fix.sog_kn < 0);
+      TEST_ASSERT_TRUE(fix.cog_deg < 0);
+      TEST_ASSERT_EQUAL_INT32(lat, fix.lat_e7);
+      TEST_ASSERT_EQUAL_INT32(lon, fix.lon_e7);
+    }
+  }
+}
+
+void test_sog_and_cog_age_separately() {
+  DeadReckoner dr;
+  DeadReckonedFix fix;
+  int32_t lat = E7(50.75), lon = E7(-1.25);
+  dr.on_fix(lat, lon, 6.0f, 90.0f, 1000);
+  // Fresh SOG, COG left empty from here on.
+  dr.on_fix(lat, lon, 6.0f, -1.0f, 2000);
+  dr.on_fix(lat, lon, 6.0f, -1.0f, 3000);
+  dr.on_fix(lat, lon, 6.0f, -1.0f, 4000);
+  TEST_ASSERT_TRUE(dr.predict(4500, &fix));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 6.0f, fix.sog_kn);
+  TEST_ASSERT_TRUE(fix.cog_deg < 0);
+  // Speed without a course can't move the position.
+  TEST_ASSERT_EQUAL_INT32(lat, fix.lat_e7);
+  TEST_ASSERT_EQUAL_INT32(lon, fix.lon_e7);
+}
+
+void test_compass_timeout_holds_course() {
+  DeadReckoner dr;
+  DeadReckonedFix fix;
+  dr.on_heading(350.0f, 900);
+  dr.on_fix(E7(50.75), E7(-1.25), 6.0f, 355.0f, 1000);
+  dr.on_heading(10.0f, 1200);  // turned 20° to starboard across north
+  TEST_ASSERT_TRUE(dr.predict(1300, &fix));
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, 15.0f, fix.cog_deg);
+
+  // Compass silent for longer than kHeadingTimeoutMs: back to the fix COG.
+  TEST_ASSERT_TRUE(
+      dr.predict(1201 + DeadReckoner::kHeadingTimeoutMs, &fix));
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, 355.0f, fix.cog_deg);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_straight_track);
+  RUN_TEST(test_steady_turn);
+  RUN_TEST(test_fast_turn_across_antimeridian);
+  RUN_TEST(test_no_fix);
+  RUN_TEST(test_stale_motion_holds_position);
+  RUN_TEST(test_sog_and_cog_age_separately);
+  RUN_TEST(test_compass_timeout_holds_course);
+  return UNITY_END();
+}
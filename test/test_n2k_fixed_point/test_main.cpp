@@ -0,0 +1,264 @@
+// test/test_n2k_fixed_point/test_main.cpp
+//
+// The integer unit conversions against the correctly rounded value
+// computed in long double, over their whole input range (sampled for the
+// 28-bit AIS coordinates), and their behaviour at the minimum, maximum and
+// "not available" inputs; and the cost of a 129038 position report built
+// from them against the double path it replaced.
+
+#include <unity.h>
+
+#include <N2kMessages.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "ais_messages.h"
+#include "n2k_ais_messages.h"
+#include "n2k_fixed_point.h"
+
+using namespace halmet;
+
+static const long double kPi = 3.141592653589793238462643383279502884L;
+static const long double kDegToRad = kPi / 180;
+
+// Round half away from zero, like the library's Add*Double().
+static int64_t Round(long double v) { return llroundl(v); }
+
+static uint16_t RefUInt16(long double v) {
+  int64_t r = Round(v);
+  return (r >= 0 && r < N2kUInt16OR) ? (uint16_t)r : N2kUInt16OR;
+}
+
+// Sweeps [first, last] and reports the first mismatch.
+template <typename Fn, typename Ref>
+static void Sweep(const char* name, int64_t first, int64_t last,
+                  int64_t step, Fn fn, Ref ref) {
+  for (int64_t v = first; v <= last; v += step) {
+    int64_t expected = ref(v), actual = fn(v);
+    if (expected != actual) {
+      char msg[120];
+      snprintf(msg, sizeof(msg), "%s(%lld): expected %lld, got %lld", name,
+               (long long)v, (long long)expected, (long long)actual);
+      TEST_FAIL_MESSAGE(msg);
+    }
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_div_round_away() {
+  TEST_ASSERT_EQUAL_INT64(3, DivRoundAway(5, 2));
+  TEST_ASSERT_EQUAL_INT64(-3, DivRoundAway(-5, 2));
+  TEST_ASSERT_EQUAL_INT64(2, DivRoundAway(7, 3));
+  TEST_ASSERT_EQUAL_INT64(-2, DivRoundAway(-7, 3));
+  TEST_ASSERT_EQUAL_INT64(0, DivRoundAway(0, 7));
+  TEST_ASSERT_EQUAL_INT64(0, DivRoundAway(-1, 3));
+}
+
+void test_to_uint16_saturates() {
+  TEST_ASSERT_EQUAL_UINT16(0, ToN2kUInt16(0));
+  TEST_ASSERT_EQUAL_UINT16(0xfffd, ToN2kUInt16(0xfffd));
+  TEST_ASSERT_EQUAL_UINT16(N2kUInt16OR, ToN2kUInt16(0xfffe));
+  TEST_ASSERT_EQUAL_UINT16(N2kUInt16OR, ToN2kUInt16(0x10000));
+  TEST_ASSERT_EQUAL_UINT16(N2kUInt16OR, ToN2kUInt16(-1));
+}
+
+void test_ais_coord() {
+  // ±180° longitude and ±90° latitude in 1/10000 minute.
+  TEST_ASSERT_EQUAL_INT32(1800000000, AisCoordToE7(108000000));
+  TEST_ASSERT_EQUAL_INT32(-1800000000, AisCoordToE7(-108000000));
+  TEST_ASSERT_EQUAL_INT32(900000000, AisCoordToE7(54000000));
+  TEST_ASSERT_EQUAL_INT32(-900000000, AisCoordToE7(-54000000));
+  TEST_ASSERT_EQUAL_INT32(0, AisCoordToE7(0));
+  TEST_ASSERT_EQUAL_INT32(17, AisCoordToE7(1));    // 16.67
+  TEST_ASSERT_EQUAL_INT32(-17, AisCoordToE7(-1));  // symmetric
+  // The 181° / 91° sentinels still convert without overflow.
+  TEST_ASSERT_EQUAL_INT32(1810000000, AisCoordToE7(kAisLon28NA));
+  TEST_ASSERT_EQUAL_INT32(910000000, AisCoordToE7(kAisLat27NA));
+
+  Sweep("AisCoordToE7", -108600000, 108600000, 997,
+        [](int64_t v) { return AisCoordToE7((int32_t)v); },
+        [](int64_t v) { return Round(v * 1e7L / 600000); });
+}
+
+void test_ais_long_range_coord() {
+  TEST_ASSERT_EQUAL_INT32(1800000000, AisLongRangeCoordToE7(108000));
+  TEST_ASSERT_EQUAL_INT32(-900000000, AisLongRangeCoordToE7(-54000));
+  TEST_ASSERT_EQUAL_INT32(1810000000, AisLongRangeCoordToE7(181 * 600));
+  Sweep("AisLongRangeCoordToE7", -108600, 108600, 1,
+        [](int64_t v) { return AisLongRangeCoordToE7((int32_t)v); },
+        [](int64_t v) { return Round(v * 1e7L / 600); });
+}
+
+void test_ais_sog() {
+  TEST_ASSERT_EQUAL_UINT16(0, AisSogToN2k(0));
+  TEST_ASSERT_EQUAL_UINT16(5258, AisSogToN2k(1022));  // 102.2 kn
+  TEST_ASSERT_EQUAL_UINT16(N2kUInt16NA, AisSogToN2k(1023));
+  TEST_ASSERT_EQUAL_UINT16(N2kUInt16NA, AisSogToN2k(0xFFFFFFFF));
+  Sweep("AisSogToN2k", 0, 1022, 1,
+        [](int64_t v) { return AisSogToN2k((uint32_t)v); },
+        [](int64_t v) { return RefUInt16(v * 0.1L * 0.514444L / 0.01L); });
+}
+
+void test_ais_cog() {
+  TEST_ASSERT_EQUAL_UINT16(0, AisCogToN2k(0));
+  TEST_ASSERT_EQUAL_UINT16(62814, AisCogToN2k(3599));  // 359.9°
+  TEST_ASSERT_EQUAL_UINT16(N2kUInt16NA, AisCogToN2k(3600));
+  TEST_ASSERT_EQUAL_UINT16(N2kUInt16NA, AisCogToN2k(4095));
+  Sweep("AisCogToN2k", 0, 3599, 1,
+        [](int64_t v) { return AisCogToN2k((uint32_t)v); },
+        [](int64_t v) { return RefUInt16(v * 0.1L * kDegToRad / 1e-4L); });
+}
+
+void test_degrees() {
+  TEST_ASSERT_EQUAL_UINT16(0, DegreesToN2k(0));
+  TEST_ASSERT_EQUAL_UINT16(62657, DegreesToN2k(359));
+  TEST_ASSERT_EQUAL_UINT16(N2kUInt16NA, DegreesToN2k(360));
+  TEST_ASSERT_EQUAL_UINT16(N2kUInt16NA, DegreesToN2k(kAisHeadingNA));
+  Sweep("DegreesToN2k", 0, 359, 1,
+        [](int64_t v) { return DegreesToN2k((uint32_t)v); },
+        [](int64_t v) { return RefUInt16(v * kDegToRad / 1e-4L); });
+}
+
+void test_long_range_knots() {
+  TEST_ASSERT_EQUAL_UINT16(0, KnotsToN2k(0));
+  TEST_ASSERT_EQUAL_UINT16(3190, KnotsToN2k(62));
+  Sweep("KnotsToN2k", 0, 63, 1,
+        [](int64_t v) { return KnotsToN2k((uint32_t)v); },
+        [](int64_t v) { return RefUInt16(v * 0.514444L / 0.01L); });
+}
+
+void test_nmea_sog() {
+  TEST_ASSERT_EQUAL_UINT16(0, KnotsHundredthsToN2k(0));
+  // The largest speed N2K can carry, and the first one it can't.
+  TEST_ASSERT_EQUAL_UINT16(0xfffd, KnotsHundredthsToN2k(127387));
+  TEST_ASSERT_EQUAL_UINT16(N2kUInt16OR, KnotsHundredthsToN2k(127388));
+  TEST_ASSERT_EQUAL_UINT16(N2kUInt16OR, KnotsHundredthsToN2k(INT32_MAX));
+  TEST_ASSERT_EQUAL_UINT16(N2kUInt16OR, KnotsHundredthsToN2k(-1));
+  Sweep("KnotsHundredthsToN2k", 0, 130000, 1,
+        [](int64_t v) { return KnotsHundredthsToN2k((int32_t)v); },
+        [](int64_t v) { return RefUInt16(v * 0.01L * 0.514444L / 0.01L); });
+}
+
+void test_nmea_cog() {
+  TEST_ASSERT_EQUAL_UINT16(0, DegreesHundredthsToN2k(0));
+  TEST_ASSERT_EQUAL_UINT16(62830, DegreesHundredthsToN2k(35999));
+  TEST_ASSERT_EQUAL_UINT16(62832, DegreesHundredthsToN2k(36000));
+  TEST_ASSERT_EQUAL_UINT16(N2kUInt16OR, DegreesHundredthsToN2k(-1));
+  TEST_ASSERT_EQUAL_UINT16(N2kUInt16OR, DegreesHundredthsToN2k(INT32_MAX));
+  Sweep("DegreesHundredthsToN2k", 0, 36000, 1,
+        [](int64_t v) { return DegreesHundredthsToN2k((int32_t)v); },
+        [](int64_t v) { return RefUInt16(v * 0.01L * kDegToRad / 1e-4L); });
+}
+
+// ----------------------------------------------------------------
+// POSITION REPORT COST
+// ----------------------------------------------------------------
+
+using Clock = std::chrono::steady_clock;
+static volatile uint8_t s_sink;
+
+template <typename Fn>
+static double NsPerCall(Fn fn) {
+  constexpr int kCalls = 200000;
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < kCalls; i++) fn(i);
+  return std::chrono::duration<double, std::nano>(Clock::now() - t0)
+             .count() /
+         kCalls;
+}
+
+static uint32_t s_rng = 0x2545f491;
+
+static uint32_t Rand() {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng;
+}
+
+// Raw Type 1 fields as AisDecode<AisClassAPositionLayout> returns them.
+struct RawReport {
+  int32_t lat, lon;
+  uint32_t sog, cog, heading;
+};
+
+// The gateway's Type 1 send before n2k_fixed_point.h: scale to degrees,
+// knots and radians in float/double, then the library's SetN2kPGN129038
+// (Add4ByteDouble and friends) scales back to integers.
+static void DoublePath(const RawReport& r, tN2kMsg& msg) {
+  constexpr double kRad = 0.017453292519943295;
+  float sog_kn = r.sog * 0.1f, cog_deg = r.cog * 0.1f;
+  float hdg_deg = r.heading == kAisHeadingNA ? 511.0f : (float)r.heading;
+  SetN2kPGN129038(
+      msg, 1, N2kaisr_Initial, 235000001, r.lat / 600000.0, r.lon / 600000.0,
+      false, false, 0xFF,
+      cog_deg >= 360.0f ? N2kDoubleNA : (double)cog_deg * kRad,
+      sog_kn >= 102.3f ? N2kDoubleNA : (double)sog_kn * 0.514444,
+      N2kaischannel_A_VDL_reception,
+      hdg_deg >= 360.0f ? N2kDoubleNA : (double)hdg_deg * kRad, N2kDoubleNA,
+      (tN2kAISNavStatus)0);
+}
+
+static void IntegerPath(const RawReport& r, tN2kMsg& msg) {
+  halmet::SetN2kPGN129038(
+      msg, 1, N2kaisr_Initial, 235000001, AisCoordToE7(r.lat),
+      AisCoordToE7(r.lon), false, false, 0xFF, AisCogToN2k(r.cog),
+      AisSogToN2k(r.sog), N2kaischannel_A_VDL_reception,
+      DegreesToN2k(r.heading), N2kInt16NA, (tN2kAISNavStatus)0);
+}
+
+void test_position_report_cost() {
+  constexpr int kReports = 256;
+  static RawReport reports[kReports];
+  for (RawReport& r : reports) {
+    r.lat = (int32_t)(Rand() % 108000001) - 54000000;
+    r.lon = (int32_t)(Rand() % 216000001) - 108000000;
+    r.sog = Rand() % 1024;
+    r.cog = Rand() % 3601;
+    r.heading = Rand() % 8 ? Rand() % 360 : kAisHeadingNA;
+  }
+
+  // Same length, and the same position bytes (user ID, lon, lat).
+  for (const RawReport& r : reports) {
+    tN2kMsg a, b;
+    DoublePath(r, a);
+    IntegerPath(r, b);
+    TEST_ASSERT_EQUAL_INT(a.DataLen, b.DataLen);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(a.Data, b.Data, 13));
+  }
+
+  double dbl = NsPerCall([&](int i) {
+    tN2kMsg msg;
+    DoublePath(reports[i % kReports], msg);
+    s_sink = msg.Data[9];
+  });
+  double fixed = NsPerCall([&](int i) {
+    tN2kMsg msg;
+    IntegerPath(reports[i % kReports], msg);
+    s_sink = msg.Data[9];
+  });
+  char msg[100];
+  snprintf(msg, sizeof(msg),
+           "ns per 129038 report: double %.1f / integer %.1f", dbl, fixed);
+  TEST_MESSAGE(msg);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_div_round_away);
+  RUN_TEST(test_to_uint16_saturates);
+  RUN_TEST(test_ais_coord);
+  RUN_TEST(test_ais_long_range_coord);
+  RUN_TEST(test_ais_sog);
+  RUN_TEST(test_ais_cog);
+  RUN_TEST(test_degrees);
+  RUN_TEST(test_long_range_knots);
+  RUN_TEST(test_nmea_sog);
+  RUN_TEST(test_nmea_cog);
+  RUN_TEST(test_position_report_cost);
+  return UNITY_END();
+}
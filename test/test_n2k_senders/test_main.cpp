@@ -0,0 +1,599 @@
+// test/test_n2k_senders/test_main.cpp
+//
+// Every sender in n2k_senders.h against the NMEA2000 library's own
+// encoder: the senders run on the shared scheduler with randomized
+// inputs, some of them expiring and coming back, and each message that
+// reaches the bus must be byte-identical to a fresh SetN2k* call with
+// the same inputs. The last test reports encode time per PGN for a full
+// encode (what every send used to cost), a one-field patch and an
+// unchanged resend, and the last counts the heap allocations of the
+// twin-engine sender set main.cpp builds.
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "host.h"
+#include "n2k_senders.h"
+
+using namespace halmet;
+
+// Exposes each sender's template and parameters to the test.
+template <typename S>
+class Exposed : public S {
+ public:
+  using S::S;
+  const tN2kMsg& update() { return this->msg_.update(this->params_); }
+  const N2kMsgTemplateStats& template_stats() const {
+    return this->msg_.stats();
+  }
+  uint32_t alarm_bits() const { return this->alarms_.bits(); }
+};
+
+using RapidSender = Exposed<N2kEngineParameterRapidSender>;
+using DynamicSender = Exposed<N2kEngineParameterDynamicSender>;
+using FluidSender = Exposed<N2kFluidLevelSender>;
+using RudderSender = Exposed<N2kRudderSender>;
+using TrimTabSender = Exposed<N2kTrimTabSender>;
+using TransmissionSender = Exposed<N2kTransmissionSender>;
+using HeadingSender = Exposed<N2kHeadingSender>;
+using AttitudeSender = Exposed<N2kAttitudeSender>;
+
+static constexpr uint8_t kTankInstance = 1;
+static constexpr double kTankCapacity = 200;  // liters
+static constexpr uint8_t kRudderInstance = 0;
+
+// Registered once, like main.cpp does: the scheduler keeps their tasks.
+static RapidSender* s_rapid[2];
+static DynamicSender* s_dynamic[2];
+static FluidSender* s_fluid;
+static RudderSender* s_rudder;
+static TrimTabSender* s_trim;
+static TransmissionSender* s_transmission[2];
+static HeadingSender* s_heading;
+static AttitudeSender* s_attitude;
+
+// ----------------------------------------------------------------
+// REFERENCE ENCODES
+//
+// What each sender sent before it kept a template: a fresh tN2kMsg
+// through the library encoder with the sender's current inputs.
+// ----------------------------------------------------------------
+
+static void EncodeRapid(RapidSender* s, uint8_t instance, tN2kMsg& msg) {
+  SetN2kEngineParamRapid(msg, instance,
+                         s->engine_speed_.value_or(N2kDoubleNA),
+                         s->engine_boost_pressure_.value_or(N2kDoubleNA),
+                         s->engine_tilt_trim_.value_or(N2kInt8NA));
+}
+
+static void EncodeDynamic(DynamicSender* s, uint8_t instance, tN2kMsg& msg) {
+  uint32_t bits = s->alarm_bits();
+  tN2kEngineDiscreteStatus1 status_1 = (uint16_t)(bits & 0xffff);
+  tN2kEngineDiscreteStatus2 status_2 = (uint16_t)(bits >> 16);
+  if (status_1.Status) status_1.Bits.CheckEngine = 1;
+  SetN2kEngineDynamicParam(msg, instance,
+                           s->oil_pressure_.value_or(N2kDoubleNA),
+                           s->oil_temperature_.value_or(N2kDoubleNA),
+                           s->temperature_.value_or(N2kDoubleNA),
+                           s->alternator_potential_.value_or(N2kDoubleNA),
+                           s->fuel_rate_.value_or(N2kDoubleNA),
+                           s->total_engine_hours_.value_or(N2kDoubleNA),
+                           s->coolant_pressure_.value_or(N2kDoubleNA),
+                           s->fuel_pressure_.value_or(N2kDoubleNA),
+                           s->engine_load_.value_or(N2kInt8NA),
+                           s->engine_torque_.value_or(N2kInt8NA), status_1,
+                           status_2);
+}
+
+static void EncodeFluid(tN2kMsg& msg) {
+  SetN2kFluidLevel(msg, kTankInstance, N2kft_Fuel,
+                   s_fluid->tank_level_.value_or(N2kDoubleNA), kTankCapacity);
+}
+
+static void EncodeRudder(tN2kMsg& msg) {
+  SetN2kPGN127245(msg, s_rudder->rudder_angle_deg_.value_or(N2kDoubleNA),
+                  kRudderInstance, N2kRDO_NoDirectionOrder, N2kDoubleNA);
+}
+
+static void EncodeTrim(tN2kMsg& msg) {
+  SetN2kPGN130576(msg, s_trim->trim_deg_port_.value_or(N2kInt8NA),
+                  s_trim->trim_deg_stbd_.value_or(N2kInt8NA));
+}
+
+static void EncodeTransmission(TransmissionSender* s, uint8_t instance,
+                               tN2kMsg& msg) {
+  SetN2kPGN127493(msg, instance,
+                  static_cast<tN2kTransmissionGear>(s->gear_.value_or(3)),
+                  s->oil_pressure_pa_.value_or(N2kDoubleNA),
+                  s->oil_temp_k_.value_or(N2kDoubleNA),
+                  s->discrete_status1_.value_or(0));
+}
+
+static void EncodeHeading(uint8_t sid, tN2kMsg& msg) {
+  SetN2kMagneticHeading(msg, sid, s_heading->heading_.value_or(N2kDoubleNA),
+                        0.0, 0.0);
+}
+
+static void EncodeAttitude(uint8_t sid, tN2kMsg& msg) {
+  SetN2kAttitude(msg, sid, N2kDoubleNA,
+                 s_attitude->pitch_.value_or(N2kDoubleNA),
+                 s_attitude->roll_.value_or(N2kDoubleNA));
+}
+
+// ----------------------------------------------------------------
+// BUS CAPTURE
+// ----------------------------------------------------------------
+
+static uint32_t s_sent = 0;
+static uint32_t s_mismatches = 0;
+static uint32_t s_sent_per_pgn[8] = {};
+static int s_heading_sid = -1;
+static int s_attitude_sid = -1;
+
+static std::string Hex(const tN2kMsg& msg) {
+  std::string s;
+  char b[4];
+  for (int i = 0; i < msg.DataLen; i++) {
+    snprintf(b, sizeof(b), "%02x", msg.Data[i]);
+    s += b;
+  }
+  return s;
+}
+
+static void Compare(int index, const tN2kMsg& sent,
+                    const std::function<void(tN2kMsg&)>& encode) {
+  tN2kMsg expected;
+  expected.Clear();
+  encode(expected);
+  s_sent_per_pgn[index]++;
+  if (sent.PGN == expected.PGN && sent.Priority == expected.Priority &&
+      sent.DataLen == expected.DataLen &&
+      memcmp(sent.Data, expected.Data, sent.DataLen) == 0) {
+    return;
+  }
+  if (s_mismatches++ == 0) {
+    char msg[200];
+    snprintf(msg, sizeof(msg), "PGN %lu at %u ms: sent %s, expected %s",
+             sent.PGN, (unsigned)millis(), Hex(sent).c_str(),
+             Hex(expected).c_str());
+    TEST_MESSAGE(msg);
+  }
+}
+
+// Checks a SID that advances by one per send, wrapping at 256.
+static void CheckSid(int* last, uint8_t sid) {
+  if (*last >= 0) TEST_ASSERT_EQUAL_UINT8((uint8_t)(*last + 1), sid);
+  *last = sid;
+}
+
+static bool CheckingSink(const tN2kMsg& msg) {
+  s_sent++;
+  uint8_t instance = msg.Data[0];
+  switch (msg.PGN) {
+    case 127488:
+      Compare(0, msg, [&](tN2kMsg& m) {
+        EncodeRapid(s_rapid[instance], instance, m);
+      });
+      break;
+    case 127489:
+      Compare(1, msg, [&](tN2kMsg& m) {
+        EncodeDynamic(s_dynamic[instance], instance, m);
+      });
+      break;
+    case 127505:
+      Compare(2, msg, EncodeFluid);
+      break;
+    case 127245:
+      Compare(3, msg, EncodeRudder);
+      break;
+    case 130576:
+      Compare(4, msg, EncodeTrim);
+      break;
+    case 127493:
+      Compare(5, msg, [&](tN2kMsg& m) {
+        EncodeTransmission(s_transmission[instance], instance, m);
+      });
+      break;
+    case 127250:
+      CheckSid(&s_heading_sid, msg.Data[0]);
+      Compare(6, msg, [&](tN2kMsg& m) { EncodeHeading(msg.Data[0], m); });
+      break;
+    case 127257:
+      CheckSid(&s_attitude_sid, msg.Data[0]);
+      Compare(7, msg, [&](tN2kMsg& m) { EncodeAttitude(msg.Data[0], m); });
+      break;
+    default:
+      TEST_FAIL_MESSAGE("unexpected PGN");
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------
+// RANDOMIZED INPUTS
+// ----------------------------------------------------------------
+
+static uint32_t s_seed = 2463534242u;
+
+static uint32_t Rand() {
+  s_seed ^= s_seed << 13;
+  s_seed ^= s_seed >> 17;
+  s_seed ^= s_seed << 5;
+  return s_seed;
+}
+
+static bool OneIn(uint32_t n) { return Rand() % n == 0; }
+
+// Uniform in [lo, hi], now and then exactly halfway between two steps of
+// `resolution` so the rounding direction is exercised too.
+static double Value(double lo, double hi, double resolution) {
+  double v = lo + (hi - lo) * (Rand() / 4294967295.0);
+  if (OneIn(8)) v = (std::floor(v / resolution) + 0.5) * resolution;
+  return v;
+}
+
+// Input groups go quiet for a while and come back, so fields expire to
+// N/A and return. Windows are in seconds of simulated time.
+static bool Live(uint32_t now_ms, uint32_t quiet_from_s, uint32_t quiet_s) {
+  uint32_t s = now_ms / 1000;
+  return s < quiet_from_s || s >= quiet_from_s + quiet_s;
+}
+
+static int s_gear[2] = {1, 1};  // neutral
+static unsigned char s_status[2] = {0, 0};
+
+static void FeedInputs(uint32_t now_ms) {
+  for (int e = 0; e < 2; e++) {
+    RapidSender* r = s_rapid[e];
+    if (Live(now_ms, 40 + e * 5, 20) && OneIn(7)) {
+      r->engine_speed_.set(Value(0, 70, 0.25 / 60));  // Hz
+    }
+    if (Live(now_ms, 90, 10) && OneIn(30)) {
+      r->engine_boost_pressure_.set(Value(0, 7e6, 100));  // some over range
+    }
+    if (OneIn(50)) r->engine_tilt_trim_.set((int8_t)(Rand() % 201 - 100));
+
+    DynamicSender* d = s_dynamic[e];
+    if (Live(now_ms, 30, 25) && OneIn(5)) {
+      d->oil_pressure_.set(Value(0, 7e6, 100));
+      d->oil_temperature_.set(Value(270, 420, 0.1));
+      d->temperature_.set(Value(270, 380, 0.01));
+      d->alternator_potential_.set(Value(-5, 30, 0.01));
+      d->engine_load_.set((int)(Rand() % 101));
+    }
+    if (Live(now_ms, 70, 15) && OneIn(11)) {
+      d->fuel_rate_.set(Value(-10, 120, 0.1));
+      d->total_engine_hours_.set(Value(0, 4.3e9, 1));  // some over range
+      d->coolant_pressure_.set(Value(0, 3e5, 100));
+      d->fuel_pressure_.set(Value(0, 7e7, 1000));
+      d->engine_torque_.set((int)(Rand() % 101));
+    }
+    if (OneIn(400)) d->over_temperature_.set(OneIn(2));
+    if (OneIn(700)) d->low_oil_pressure_.set(OneIn(2));
+    if (OneIn(900)) d->maintenance_needed_.set(OneIn(2));
+    if (OneIn(1500)) d->engine_shutting_down_.set(OneIn(2));
+
+    // Gear and status come from switches that repeat their state.
+    TransmissionSender* t = s_transmission[e];
+    if (OneIn(20000)) s_gear[e] = Rand() % 4;
+    if (OneIn(30000)) s_status[e] = Rand() & 0xff;
+    if (now_ms % 100 == 0) {
+      t->gear_.set(s_gear[e]);
+      t->discrete_status1_.set(s_status[e]);
+    }
+    if (Live(now_ms, 60, 20) && OneIn(9)) {
+      t->oil_pressure_pa_.set(Value(0, 3e6, 100));
+      t->oil_temp_k_.set(Value(270, 400, 0.1));
+    }
+  }
+
+  if (OneIn(3)) s_fluid->tank_level_.set(Value(0, 1, 0.004 / 100));
+  if (Live(now_ms, 50, 20) && OneIn(4)) {
+    s_rudder->rudder_angle_deg_.set(Value(-45, 45, 0.0001 / DEG_TO_RAD));
+  }
+  // 130576 carries whole units; the sender passes radians through.
+  if (OneIn(9)) s_trim->trim_deg_port_.set(Value(-360, 360, 1));
+  if (Live(now_ms, 100, 10) && OneIn(9)) {
+    s_trim->trim_deg_stbd_.set(Value(-360, 360, 1));
+  }
+  if (Live(now_ms, 20, 5) && OneIn(2)) {
+    s_heading->heading_.set(Value(0, 359.99, 0.0001 / DEG_TO_RAD));
+  }
+  if (OneIn(2)) {
+    s_attitude->pitch_.set(Value(-20, 20, 0.0001 / DEG_TO_RAD));
+    s_attitude->roll_.set(Value(-60, 60, 0.0001 / DEG_TO_RAD));
+  }
+}
+
+// ----------------------------------------------------------------
+// TESTS
+// ----------------------------------------------------------------
+
+void setUp() {}
+void tearDown() {}
+
+void test_sent_messages_match_library_encoder() {
+  constexpr uint32_t kRunMs = 180000;
+  HostSetN2kBusSink(CheckingSink);
+  // Inputs arrive every millisecond or so; main.cpp ticks the wheel every
+  // slot.
+  for (uint32_t ms = 1; ms <= kRunMs; ms++) {
+    HostSetMicros(ms * 1000ULL);
+    FeedInputs(ms);
+    if (ms % N2kScheduler::kSlotMs == 0) n2k_scheduler()->tick(ms);
+  }
+  HostSetN2kBusSink(nullptr);
+
+  static const char* const kNames[] = {
+      "127488", "127489", "127505", "127245",
+      "130576", "127493", "127250", "127257"};
+  char report[200];
+  int pos = snprintf(report, sizeof(report), "%lu sends:",
+                     (unsigned long)s_sent);
+  for (int i = 0; i < 8; i++) {
+    pos += snprintf(report + pos, sizeof(report) - pos, " %s x%lu", kNames[i],
+                    (unsigned long)s_sent_per_pgn[i]);
+    TEST_ASSERT_GREATER_THAN_MESSAGE(0, s_sent_per_pgn[i], kNames[i]);
+  }
+  TEST_MESSAGE(report);
+  TEST_ASSERT_EQUAL_UINT32(0, s_mismatches);
+}
+
+// The comparison above only means something if the patch and reuse paths
+// carried most of the sends.
+void test_templates_patch_and_reuse() {
+  struct {
+    const char* name;
+    N2kMsgTemplateStats stats;
+  } const rows[] = {
+      {"127488", s_rapid[0]->template_stats()},
+      {"127489", s_dynamic[0]->template_stats()},
+      {"127505", s_fluid->template_stats()},
+      {"127245", s_rudder->template_stats()},
+      {"130576", s_trim->template_stats()},
+      {"127493", s_transmission[0]->template_stats()},
+      {"127250", s_heading->template_stats()},
+      {"127257", s_attitude->template_stats()},
+  };
+  for (const auto& r : rows) {
+    char msg[120];
+    snprintf(msg, sizeof(msg), "%s: %lu encodes, %lu patches, %lu reuses",
+             r.name, (unsigned long)r.stats.encodes,
+             (unsigned long)r.stats.patches, (unsigned long)r.stats.reuses);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_GREATER_THAN_MESSAGE(0, r.stats.patches, r.name);
+    TEST_ASSERT_TRUE_MESSAGE(r.stats.encodes < r.stats.patches, r.name);
+  }
+  // Gear and status changes re-encode 127493 and nothing else does after
+  // the first send.
+  TEST_ASSERT_EQUAL_UINT32(1, s_rapid[0]->template_stats().encodes);
+  TEST_ASSERT_EQUAL_UINT32(1, s_heading->template_stats().encodes);
+  TEST_ASSERT_TRUE(s_transmission[0]->template_stats().encodes > 1);
+}
+
+// ----------------------------------------------------------------
+// ENCODE COST
+// ----------------------------------------------------------------
+
+using Clock = std::chrono::steady_clock;
+static volatile uint8_t s_sink;
+
+template <typename Fn>
+static double NsPerCall(Fn fn) {
+  constexpr int kCalls = 200000;
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < kCalls; i++) fn(i);
+  return std::chrono::duration<double, std::nano>(Clock::now() - t0)
+             .count() /
+         kCalls;
+}
+
+struct CostRow {
+  const char* name;
+  std::function<void(tN2kMsg&)> encode;  // the old path
+  std::function<const tN2kMsg&()> update;
+  std::function<void(int)> touch;  // changes one patched field
+};
+
+void test_encode_cost() {
+  HostSetMicros(200000 * 1000ULL);
+  const CostRow rows[] = {
+      {"127488 Engine Rapid",
+       [](tN2kMsg& m) { EncodeRapid(s_rapid[0], 0, m); },
+       []() -> const tN2kMsg& { return s_rapid[0]->update(); },
+       [](int i) { s_rapid[0]->engine_speed_.set(20 + (i & 255)); }},
+      {"127489 Engine Dynamic",
+       [](tN2kMsg& m) { EncodeDynamic(s_dynamic[0], 0, m); },
+       []() -> const tN2kMsg& { return s_dynamic[0]->update(); },
+       [](int i) { s_dynamic[0]->oil_pressure_.set(3e5 + (i & 255) * 100); }},
+      {"127505 Fluid Level", EncodeFluid,
+       []() -> const tN2kMsg& { return s_fluid->update(); },
+       [](int i) { s_fluid->tank_level_.set((i & 255) / 256.0); }},
+      {"127245 Rudder", EncodeRudder,
+       []() -> const tN2kMsg& { return s_rudder->update(); },
+       [](int i) { s_rudder->rudder_angle_deg_.set((i & 63) - 32); }},
+      {"130576 Trim Tab", EncodeTrim,
+       []() -> const tN2kMsg& { return s_trim->update(); },
+       [](int i) { s_trim->trim_deg_port_.set((i & 255) - 128); }},
+      {"127493 Transmission",
+       [](tN2kMsg& m) { EncodeTransmission(s_transmission[0], 0, m); },
+       []() -> const tN2kMsg& { return s_transmission[0]->update(); },
+       [](int i) { s_transmission[0]->oil_pressure_pa_.set(1e5 + i % 999); }},
+      {"127250 Heading", [](tN2kMsg& m) { EncodeHeading(0, m); },
+       []() -> const tN2kMsg& { return s_heading->update(); },
+       [](int i) { s_heading->heading_.set(i % 360); }},
+      {"127257 Attitude", [](tN2kMsg& m) { EncodeAttitude(0, m); },
+       []() -> const tN2kMsg& { return s_attitude->update(); },
+       [](int i) { s_attitude->roll_.set((i & 63) - 32); }},
+  };
+
+  TEST_MESSAGE("ns per send: full encode / one field patched / unchanged");
+  for (const CostRow& r : rows) {
+    r.touch(0);
+    r.update();
+    double full = NsPerCall([&](int) {
+      tN2kMsg msg;
+      r.encode(msg);
+      s_sink = msg.Data[1];
+    });
+    double one = NsPerCall([&](int i) {
+      r.touch(i);
+      s_sink = r.update().Data[1];
+    });
+    double none = NsPerCall([&](int) { s_sink = r.update().Data[1]; });
+    char msg[120];
+    snprintf(msg, sizeof(msg), "%-22s %7.1f / %6.1f / %5.1f", r.name, full,
+             one, none);
+    TEST_MESSAGE(msg);
+  }
+}
+
+// ----------------------------------------------------------------
+// HEAP ALLOCATIONS
+//
+// Every operator new in the binary goes through here; only the blocks
+// inside CountAllocations() are counted.
+// ----------------------------------------------------------------
+
+static bool s_counting = false;
+static size_t s_allocations = 0;
+static size_t s_allocated_bytes = 0;
+
+void* operator new(size_t size) {
+  if (s_counting) {
+    s_allocations++;
+    s_allocated_bytes += size;
+  }
+  void* p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+struct AllocCount {
+  size_t allocations;
+  size_t bytes;
+};
+
+template <typename Fn>
+static AllocCount CountAllocations(Fn fn) {
+  s_allocations = s_allocated_bytes = 0;
+  s_counting = true;
+  fn();
+  s_counting = false;
+  return {s_allocations, s_allocated_bytes};
+}
+
+static bool DiscardingSink(const tN2kMsg&) { return true; }
+
+void test_sender_set_allocations() {
+  HostSetMicros(300000 * 1000ULL);
+  tNMEA2000* bus = nullptr;
+  RudderSender* rudder;
+  TransmissionSender* transmission[2];
+  DynamicSender* dynamic[2];
+  RapidSender* rapid[2];
+  struct Row {
+    const char* name;
+    AllocCount count;
+    size_t object;
+  };
+  // main.cpp's set, with its config paths.
+  const Row rows[] = {
+      {"127245 Rudder", CountAllocations([&]() {
+         rudder = new RudderSender("/NMEA 2000/Rudder", 0, bus);
+       }),
+       sizeof(RudderSender)},
+      {"127493 Transmission x2", CountAllocations([&]() {
+         transmission[0] = new TransmissionSender(
+             "/NMEA 2000/Port Transmission", 0, bus);
+         transmission[1] = new TransmissionSender(
+             "/NMEA 2000/Stbd Transmission", 1, bus);
+       }),
+       2 * sizeof(TransmissionSender)},
+      {"127489 Engine Dynamic x2", CountAllocations([&]() {
+         dynamic[0] =
+             new DynamicSender("/NMEA 2000/Engine 1 Dynamic", 0, bus);
+         dynamic[1] =
+             new DynamicSender("/NMEA 2000/Engine 2 Dynamic", 1, bus);
+       }),
+       2 * sizeof(DynamicSender)},
+      {"127488 Engine Rapid x2", CountAllocations([&]() {
+         rapid[0] = new RapidSender("/NMEA 2000/Port Engine Rapid Update",
+                                    0, bus);
+         rapid[1] = new RapidSender("/NMEA 2000/Stbd Engine Rapid Update",
+                                    1, bus);
+       }),
+       2 * sizeof(RapidSender)},
+  };
+
+  TEST_MESSAGE("construction: allocations / bytes (sender objects)");
+  AllocCount total = {0, 0};
+  for (const Row& r : rows) {
+    char msg[100];
+    snprintf(msg, sizeof(msg), "%-26s %3zu / %6zu (%zu)", r.name,
+             r.count.allocations, r.count.bytes, r.object);
+    TEST_MESSAGE(msg);
+    total.allocations += r.count.allocations;
+    total.bytes += r.count.bytes;
+  }
+  char msg[100];
+  snprintf(msg, sizeof(msg), "%-26s %3zu / %6zu", "total", total.allocations,
+           total.bytes);
+  TEST_MESSAGE(msg);
+
+  // Inputs live inline in each sender's table: 34 of them cost the
+  // dynamic sender no more allocations than the rapid sender's 3.
+  TEST_ASSERT_EQUAL_size_t(rows[3].count.allocations,
+                           rows[2].count.allocations);
+
+  // Writing inputs, expiring them and sending allocate nothing.
+  HostSetN2kBusSink(DiscardingSink);
+  AllocCount running = CountAllocations([&]() {
+    for (uint32_t ms = 300000; ms < 320000; ms++) {
+      HostSetMicros(ms * 1000ULL);
+      if (ms < 310000 || ms % 7000 == 0) {
+        for (int e = 0; e < 2; e++) {
+          rapid[e]->engine_speed_.set(30 + (ms & 15));
+          dynamic[e]->oil_pressure_.set(3e5 + (ms & 255));
+          dynamic[e]->over_temperature_.set(ms & 1024);
+          transmission[e]->oil_pressure_pa_.set(2e5 + (ms & 63));
+        }
+        rudder->rudder_angle_deg_.set((int)(ms % 61) - 30);
+      }
+      if (ms % N2kScheduler::kSlotMs == 0) n2k_scheduler()->tick(ms);
+    }
+  });
+  HostSetN2kBusSink(nullptr);
+  TEST_ASSERT_EQUAL_size_t(0, running.allocations);
+}
+
+int main(int, char**) {
+  tNMEA2000* bus = nullptr;  // sends go to the host sink
+  for (uint8_t e = 0; e < 2; e++) {
+    s_rapid[e] = new RapidSender("/rapid", e, bus);
+    s_dynamic[e] = new DynamicSender("/dynamic", e, bus);
+    s_transmission[e] = new TransmissionSender("/transmission", e, bus);
+  }
+  s_fluid = new FluidSender("/tank", kTankInstance, N2kft_Fuel,
+                            kTankCapacity, bus);
+  s_rudder = new RudderSender("/rudder", kRudderInstance, bus);
+  s_trim = new TrimTabSender("/trim", bus);
+  s_heading = new HeadingSender("/heading", bus);
+  s_attitude = new AttitudeSender("/attitude", bus);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_sent_messages_match_library_encoder);
+  RUN_TEST(test_templates_patch_and_reuse);
+  RUN_TEST(test_encode_cost);
+  RUN_TEST(test_sender_set_allocations);
+  return UNITY_END();
+}
@@ -0,0 +1,179 @@
+// test/test_nmea0183_dispatch/test_main.cpp
+//
+// SentenceDispatcher: every talker variant of a registered formatter and
+// every proprietary address reaches its handler, nothing else does, and
+// the lookup cost against the equals() chain it replaced.
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "nmea0183_dispatch.h"
+
+using namespace halmet;
+
+// Handlers only identify themselves.
+using Handler = int (*)();
+static int Vdm() { return 1; }
+static int Rmc() { return 2; }
+static int Gga() { return 3; }
+static int Vtg() { return 4; }
+static int Hdt() { return 5; }
+static int Zda() { return 6; }
+static int Psrt() { return 7; }
+
+// The gateway's table.
+using Dispatcher = SentenceDispatcher<Handler, 16>;
+static constexpr Dispatcher::Entry kEntries[] = {
+    {"VDM", Vdm}, {"VDO", Vdm}, {"RMC", Rmc}, {"GGA", Gga},
+    {"VTG", Vtg}, {"HDT", Hdt}, {"ZDA", Zda}, {"PSRT", Psrt},
+};
+static constexpr Dispatcher kDispatcher{kEntries};
+static_assert(kDispatcher.valid(), "gateway sentence keys collide");
+
+// Lookups resolve at compile time too.
+static_assert(kDispatcher.find(SentenceKey("GNRMC", 5)) == Rmc);
+static_assert(kDispatcher.find(SentenceKey("GPGSV", 5)) == nullptr);
+
+// Registering a key twice can never be collision free.
+static constexpr Dispatcher::Entry kDuplicate[] = {{"RMC", Rmc},
+                                                   {"RMC", Gga}};
+static_assert(!Dispatcher{kDuplicate}.valid());
+
+static NmeaField Field(const std::string& s) {
+  NmeaField f;
+  f.p = s.c_str();
+  f.len = (uint8_t)s.size();
+  return f;
+}
+
+static Handler Find(const std::string& addr) {
+  return kDispatcher.find(SentenceKey(Field(addr)));
+}
+
+static const char* const kTalkers[] = {"GP", "GN", "GL", "GA", "GB", "BD",
+                                       "GQ", "AI", "AB", "AN", "II", "IN",
+                                       "HE", "HC", "EC", "SD"};
+
+void setUp() {}
+void tearDown() {}
+
+void test_keys() {
+  TEST_ASSERT_EQUAL_UINT32(SentenceKey("RMC"), SentenceKey("GPRMC", 5));
+  TEST_ASSERT_EQUAL_UINT32(SentenceKey("RMC"), SentenceKey("GNRMC", 5));
+  TEST_ASSERT_EQUAL_UINT32(SentenceKey("PSRT"), SentenceKey("PSRT", 4));
+  TEST_ASSERT_EQUAL_UINT32(0x00524D43, SentenceKey("RMC"));
+  // A five-character proprietary address keeps its 'P'.
+  TEST_ASSERT_EQUAL_UINT32(SentenceKey("PGRM"), SentenceKey("PGRMZ", 5));
+  // Neither a talker sentence nor proprietary: no key.
+  TEST_ASSERT_EQUAL_UINT32(0, SentenceKey("", 0));
+  TEST_ASSERT_EQUAL_UINT32(0, SentenceKey("RMC", 3));
+  TEST_ASSERT_EQUAL_UINT32(0, SentenceKey("GPRMCX", 6));
+}
+
+void test_talker_variants() {
+  struct {
+    const char* formatter;
+    Handler handler;
+  } const expected[] = {{"VDM", Vdm}, {"VDO", Vdm}, {"RMC", Rmc},
+                        {"GGA", Gga}, {"VTG", Vtg}, {"HDT", Hdt},
+                        {"ZDA", Zda}};
+  for (const char* talker : kTalkers) {
+    for (const auto& e : expected) {
+      std::string addr = std::string(talker) + e.formatter;
+      TEST_ASSERT_TRUE_MESSAGE(Find(addr) == e.handler, addr.c_str());
+    }
+  }
+  TEST_ASSERT_TRUE(Find("PSRT") == Psrt);
+}
+
+void test_only_registered_formatters_match() {
+  // Every three-letter formatter from one talker.
+  int matched = 0;
+  for (char a = 'A'; a <= 'Z'; a++) {
+    for (char b = 'A'; b <= 'Z'; b++) {
+      for (char c = 'A'; c <= 'Z'; c++) {
+        std::string addr = std::string("GP") + a + b + c;
+        if (Find(addr)) matched++;
+      }
+    }
+  }
+  TEST_ASSERT_EQUAL_INT(7, matched);
+
+  for (const char* addr : {"", "P", "RMC", "GPRM", "GPRMCX", "PSR", "PSRX",
+                           "PGRMZ", "AIVDMA", "gprmc", "GP\x01MC"}) {
+    TEST_ASSERT_TRUE_MESSAGE(Find(addr) == nullptr, addr);
+  }
+}
+
+// ----------------------------------------------------------------
+// LOOKUP COST
+// ----------------------------------------------------------------
+
+// The chain ParseSentence() used before the dispatcher, widened to the
+// same sentences.
+static Handler FindByChain(const NmeaField& addr) {
+  if (addr.equals("AIVDM") || addr.equals("AIVDO")) return Vdm;
+  if (addr.equals("GPRMC")) return Rmc;
+  if (addr.equals("GPGGA")) return Gga;
+  if (addr.equals("GPVTG")) return Vtg;
+  if (addr.equals("GPHDT")) return Hdt;
+  if (addr.equals("GPZDA")) return Zda;
+  if (addr.equals("PSRT")) return Psrt;
+  return nullptr;
+}
+
+void test_lookup_cost() {
+  // A transponder stream: mostly VDM, own-ship sentences once a second
+  // and the odd sentence nobody handles.
+  std::vector<std::string> mix;
+  for (int i = 0; i < 20; i++) mix.push_back("AIVDM");
+  for (const char* s : {"AIVDO", "GPRMC", "GPGGA", "GPVTG", "GPHDT",
+                        "GPZDA", "PSRT", "GPGSV", "GPGSA", "GPGLL"}) {
+    mix.push_back(s);
+  }
+  std::vector<NmeaField> fields;
+  for (const std::string& s : mix) fields.push_back(Field(s));
+
+  for (const NmeaField& f : fields) {
+    TEST_ASSERT_TRUE(FindByChain(f) ==
+                     kDispatcher.find(SentenceKey(f)));
+  }
+
+  constexpr int kRounds = 200000;
+  using Clock = std::chrono::steady_clock;
+  volatile uintptr_t sink = 0;
+  Clock::time_point t0 = Clock::now();
+  for (int r = 0; r < kRounds; r++) {
+    for (const NmeaField& f : fields) sink = sink + (uintptr_t)FindByChain(f);
+  }
+  Clock::time_point t1 = Clock::now();
+  for (int r = 0; r < kRounds; r++) {
+    for (const NmeaField& f : fields) {
+      sink = sink + (uintptr_t)kDispatcher.find(SentenceKey(f));
+    }
+  }
+  Clock::time_point t2 = Clock::now();
+
+  double n = (double)kRounds * fields.size();
+  using Ns = std::chrono::duration<double, std::nano>;
+  double chain_ns = Ns(t1 - t0).count() / n;
+  double hash_ns = Ns(t2 - t1).count() / n;
+  char report[120];
+  snprintf(report, sizeof(report),
+           "per lookup: equals() chain %.1f ns, perfect hash %.1f ns (%.1fx)",
+           chain_ns, hash_ns, chain_ns / hash_ns);
+  TEST_MESSAGE(report);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_keys);
+  RUN_TEST(test_talker_variants);
+  RUN_TEST(test_only_registered_formatters_match);
+  RUN_TEST(test_lookup_cost);
+  return UNITY_END();
+}
@@ -0,0 +1,365 @@
+// test/test_nmea0183_sentence/test_main.cpp
+//
+// Nmea0183Sentence tokenizer edge cases and the bounded number parsers,
+// and their cost against the strchr/atof cascade they replaced.
+
+#include <unity.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "nmea0183_sentence.h"
+
+using halmet::Nmea0183Sentence;
+using halmet::NmeaField;
+
+// "<start><body>*HH" with a correct checksum; lowercase hex on request.
+static std::string Frame(const std::string& body, char start = '$',
+                         bool lower = false) {
+  uint8_t cksum = 0;
+  for (char c : body) cksum ^= (uint8_t)c;
+  char hex[4];
+  snprintf(hex, sizeof(hex), lower ? "%02x" : "%02X", cksum);
+  return std::string(1, start) + body + "*" + hex;
+}
+
+static NmeaField Field(const char* s) {
+  NmeaField f;
+  f.p = s;
+  f.len = (uint8_t)strlen(s);
+  return f;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// ----------------------------------------------------------------
+// TOKENIZER
+// ----------------------------------------------------------------
+
+void test_splits_fields() {
+  Nmea0183Sentence s;
+  std::string line = Frame("GPRMC,123519,A,,,");
+  TEST_ASSERT_TRUE(s.parse(line.c_str()));
+  TEST_ASSERT_EQUAL_INT('$', s.start());
+  TEST_ASSERT_EQUAL_INT(6, s.num_fields());
+  TEST_ASSERT_TRUE(s.address().equals("GPRMC"));
+  TEST_ASSERT_TRUE(s.field(1).equals("123519"));
+  TEST_ASSERT_EQUAL_INT('A', s.field(2).ch());
+  for (int i = 3; i < 6; i++) TEST_ASSERT_TRUE(s.field(i).empty());
+  // Past the end and negative indices read as empty fields.
+  TEST_ASSERT_TRUE(s.field(6).empty());
+  TEST_ASSERT_TRUE(s.field(-1).empty());
+  TEST_ASSERT_EQUAL_INT('\0', s.field(6).ch());
+}
+
+void test_accepts_encapsulation_start() {
+  Nmea0183Sentence s;
+  std::string line = Frame("AIVDM,1,1,,A,15M67FC000G?ufbE`FepT@3n00Sa,0", '!');
+  TEST_ASSERT_TRUE(s.parse(line.c_str()));
+  TEST_ASSERT_EQUAL_INT('!', s.start());
+  TEST_ASSERT_EQUAL_INT(7, s.num_fields());
+}
+
+void test_accepts_lowercase_checksum() {
+  Nmea0183Sentence s;
+  // ASCII bodies keep the high digit below 8, so only the low one can be
+  // a letter.
+  TEST_ASSERT_TRUE(s.parse("$GPTXT,h*0b"));
+  TEST_ASSERT_TRUE(s.parse("$GPTXT,h*0B"));
+  TEST_ASSERT_TRUE(s.parse(Frame("GPTXT,o", '$', true).c_str()));
+}
+
+void test_rejects_bad_framing() {
+  Nmea0183Sentence s;
+  std::string good = Frame("GPGLL,4916.45,N");
+  std::string body = good.substr(1, good.size() - 4);
+  std::string hex = good.substr(good.size() - 2);
+
+  const std::string bad[] = {
+      "",
+      body + "*" + hex,                          // no start character
+      "#" + body + "*" + hex,                    // wrong start character
+      "$" + body,                                // no checksum
+      "$" + body + "*",                          // empty checksum
+      "$" + body + "*" + hex.substr(0, 1),       // one hex digit
+      "$" + body + "*G" + hex.substr(1),         // not hex
+      "$" + body + "*" + hex.substr(0, 1) + "g", // not hex
+      "$" + body + "*00",                        // wrong checksum
+      "$" + body + "X*" + hex,                   // body changed
+  };
+  for (const std::string& line : bad) {
+    // A failed parse leaves no fields from an earlier sentence behind.
+    TEST_ASSERT_TRUE(s.parse(good.c_str()));
+    TEST_ASSERT_FALSE_MESSAGE(s.parse(line.c_str()), line.c_str());
+    TEST_ASSERT_EQUAL_INT(0, s.num_fields());
+    TEST_ASSERT_TRUE(s.address().empty());
+  }
+}
+
+void test_field_count_limit() {
+  Nmea0183Sentence s;
+  std::string body = "GPXXX";
+  for (int i = 1; i < Nmea0183Sentence::kMaxFields; i++) body += ",";
+  TEST_ASSERT_TRUE(s.parse(Frame(body).c_str()));
+  TEST_ASSERT_EQUAL_INT(Nmea0183Sentence::kMaxFields, s.num_fields());
+
+  TEST_ASSERT_FALSE(s.parse(Frame(body + ",").c_str()));
+  TEST_ASSERT_EQUAL_INT(0, s.num_fields());
+}
+
+void test_field_length_limit() {
+  Nmea0183Sentence s;
+  std::string max(255, '7'), over(256, '7');
+
+  // Fields keep their length in a uint8_t: 255 bytes is the most that
+  // fits, wherever the field sits.
+  TEST_ASSERT_TRUE(s.parse(Frame(max + ",A").c_str()));
+  TEST_ASSERT_EQUAL_INT(255, s.address().len);
+  TEST_ASSERT_TRUE(s.parse(Frame("GPTXT," + max + ",A").c_str()));
+  TEST_ASSERT_EQUAL_INT(255, s.field(1).len);
+  TEST_ASSERT_TRUE(s.parse(Frame("GPTXT,A," + max).c_str()));
+  TEST_ASSERT_EQUAL_INT(255, s.field(2).len);
+
+  const std::string bad[] = {
+      Frame(over + ",A"),
+      Frame("GPTXT," + over + ",A"),
+      Frame("GPTXT,A," + over),
+      // 512 bytes would wrap to a plausible length of 0.
+      Frame("GPTXT," + std::string(512, '7') + ",A"),
+  };
+  for (const std::string& line : bad) {
+    TEST_ASSERT_FALSE(s.parse(line.c_str()));
+    TEST_ASSERT_EQUAL_INT(0, s.num_fields());
+  }
+}
+
+// ----------------------------------------------------------------
+// NUMBER PARSERS
+// ----------------------------------------------------------------
+
+void test_parse_unsigned() {
+  uint32_t v = 7;
+  TEST_ASSERT_TRUE(halmet::ParseUnsigned(Field("0"), &v));
+  TEST_ASSERT_EQUAL_UINT32(0, v);
+  TEST_ASSERT_TRUE(halmet::ParseUnsigned(Field("999999999"), &v));
+  TEST_ASSERT_EQUAL_UINT32(999999999, v);
+  TEST_ASSERT_TRUE(halmet::ParseUnsigned(Field("007"), &v));
+  TEST_ASSERT_EQUAL_UINT32(7, v);
+
+  v = 42;
+  for (const char* bad : {"", "1000000000", "-1", "+1", "1.0", " 1", "1a"}) {
+    TEST_ASSERT_FALSE_MESSAGE(halmet::ParseUnsigned(Field(bad), &v), bad);
+  }
+  TEST_ASSERT_EQUAL_UINT32(42, v);  // untouched on failure
+
+  // Stops at the field boundary even when the buffer goes on.
+  NmeaField f = Field("12,34");
+  f.len = 2;
+  TEST_ASSERT_TRUE(halmet::ParseUnsigned(f, &v));
+  TEST_ASSERT_EQUAL_UINT32(12, v);
+}
+
+void test_parse_fixed() {
+  struct Case {
+    const char* s;
+    int decimals;
+    int32_t expected;
+  };
+  const Case cases[] = {
+      {"12.3456", 2, 1234},  {"12.3456", 4, 123456}, {"12.3", 4, 123000},
+      {"12", 1, 120},        {"-0.5", 1, -5},        {"+3.25", 2, 325},
+      {".5", 1, 5},          {"5.", 1, 50},          {"0.0", 0, 0},
+      {"2147483647", 0, INT32_MAX},
+      {"-2147483647", 0, -INT32_MAX},
+      {"359.99", 1, 3599},   {"-12.999", 2, -1299},
+  };
+  for (const Case& c : cases) {
+    int32_t v = 0;
+    TEST_ASSERT_TRUE_MESSAGE(halmet::ParseFixed(Field(c.s), c.decimals, &v),
+                             c.s);
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(c.expected, v, c.s);
+  }
+
+  int32_t v = 42;
+  const Case bad[] = {
+      {"", 1, 0},    {"-", 1, 0},     {".", 1, 0},     {"-.", 1, 0},
+      {"1e3", 0, 0}, {"1.2.3", 1, 0}, {"1,2", 1, 0},   {"12 ", 0, 0},
+      {"2147483648", 0, 0},           {"21474836.48", 2, 0},
+      {"12345678901", 0, 0},          {"0.5", 10, 0},
+  };
+  for (const Case& c : bad) {
+    TEST_ASSERT_FALSE_MESSAGE(halmet::ParseFixed(Field(c.s), c.decimals, &v),
+                              c.s);
+  }
+  TEST_ASSERT_EQUAL_INT32(42, v);  // untouched on failure
+}
+
+void test_parse_lat_lon() {
+  int32_t e7 = 0;
+  TEST_ASSERT_TRUE(halmet::ParseLatLonE7(Field("4807.038"), Field("N"), &e7));
+  TEST_ASSERT_EQUAL_INT32(481173000, e7);
+  TEST_ASSERT_TRUE(
+      halmet::ParseLatLonE7(Field("01131.00000"), Field("W"), &e7));
+  TEST_ASSERT_EQUAL_INT32(-115166667, e7);
+  TEST_ASSERT_TRUE(halmet::ParseLatLonE7(Field("3351.0000"), Field("S"), &e7));
+  TEST_ASSERT_EQUAL_INT32(-338500000, e7);
+  TEST_ASSERT_TRUE(
+      halmet::ParseLatLonE7(Field("18000.00000"), Field("E"), &e7));
+  TEST_ASSERT_EQUAL_INT32(1800000000, e7);
+  TEST_ASSERT_TRUE(halmet::ParseLatLonE7(Field("0000.00001"), Field("N"), &e7));
+  TEST_ASSERT_EQUAL_INT32(2, e7);  // 1e-5 min = 1.67e-7 deg, rounded
+  // Minute digits past the fifth are truncated.
+  TEST_ASSERT_TRUE(
+      halmet::ParseLatLonE7(Field("4807.0380099"), Field("N"), &e7));
+  TEST_ASSERT_EQUAL_INT32(481173000, e7);
+
+  e7 = 42;
+  TEST_ASSERT_FALSE(halmet::ParseLatLonE7(Field(""), Field("N"), &e7));
+  TEST_ASSERT_FALSE(halmet::ParseLatLonE7(Field("4860.000"), Field("N"), &e7));
+  TEST_ASSERT_FALSE(halmet::ParseLatLonE7(Field("18100.000"), Field("E"), &e7));
+  TEST_ASSERT_FALSE(halmet::ParseLatLonE7(Field("-4807.038"), Field("N"), &e7));
+  TEST_ASSERT_FALSE(halmet::ParseLatLonE7(Field("48O7.038"), Field("N"), &e7));
+  TEST_ASSERT_EQUAL_INT32(42, e7);
+}
+
+void test_parse_lat_lon_hemisphere_bounds() {
+  int32_t e7 = 0;
+  TEST_ASSERT_TRUE(halmet::ParseLatLonE7(Field("9000.000"), Field("N"), &e7));
+  TEST_ASSERT_EQUAL_INT32(900000000, e7);
+  TEST_ASSERT_TRUE(halmet::ParseLatLonE7(Field("9000.000"), Field("S"), &e7));
+  TEST_ASSERT_EQUAL_INT32(-900000000, e7);
+  TEST_ASSERT_TRUE(
+      halmet::ParseLatLonE7(Field("17959.99999"), Field("W"), &e7));
+  TEST_ASSERT_EQUAL_INT32(-1799999998, e7);
+
+  // A latitude past the pole, or a longitude past the antimeridian, even
+  // by the smallest minute step.
+  e7 = 42;
+  const char* bad[][2] = {
+      {"9100.000", "N"},    {"12000.000", "S"},   {"9000.00001", "N"},
+      {"17959.999", "S"},   {"18000.00001", "E"}, {"18000.00001", "W"},
+  };
+  for (const auto& b : bad) {
+    TEST_ASSERT_FALSE_MESSAGE(
+        halmet::ParseLatLonE7(Field(b[0]), Field(b[1]), &e7), b[0]);
+  }
+  TEST_ASSERT_EQUAL_INT32(42, e7);
+}
+
+// ----------------------------------------------------------------
+// PARSE COST
+// ----------------------------------------------------------------
+
+using Clock = std::chrono::steady_clock;
+static volatile int32_t s_sink;
+
+template <typename Fn>
+static double NsPerCall(Fn fn) {
+  constexpr int kCalls = 200000;
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < kCalls; i++) fn(i);
+  return std::chrono::duration<double, std::nano>(Clock::now() - t0)
+             .count() /
+         kCalls;
+}
+
+struct RmcFix {
+  double lat, lon, sog_kn, cog_deg;
+};
+
+// The RMC branch of ParseNMEA before the tokenizer: no checksum check,
+// and a short sentence dereferences strchr()'s NULL.
+static double LegacyToDeg(const char* s) {
+  double raw = atof(s);
+  int deg = (int)(raw / 100);
+  return deg + (raw - deg * 100.0) / 60.0;
+}
+
+static bool LegacyRmc(const char* line, RmcFix* fix) {
+  if (strncmp(line, "$GPRMC", 6) != 0) return false;
+  const char* p = strchr(line, ',');
+  if (!p) return false;
+  p = strchr(p + 1, ',');  // skip time field
+  if (!p) return false;
+  if (*(p + 1) != 'A') return false;
+  p = strchr(p + 1, ',') + 1;
+  fix->lat = LegacyToDeg(p);
+  p = strchr(p, ',') + 1;
+  if (*p == 'S') fix->lat = -fix->lat;
+  p = strchr(p, ',') + 1;
+  fix->lon = LegacyToDeg(p);
+  p = strchr(p, ',') + 1;
+  if (*p == 'W') fix->lon = -fix->lon;
+  p = strchr(p, ',') + 1;
+  fix->sog_kn = atof(p);
+  p = strchr(p, ',') + 1;
+  fix->cog_deg = atof(p);
+  return true;
+}
+
+// The same fields the way HandleRmc reads them now.
+static bool TokenizedRmc(const char* line, RmcFix* fix) {
+  Nmea0183Sentence s;
+  if (!s.parse(line) || s.field(2).ch() != 'A') return false;
+  int32_t lat, lon, sog_c, cog_c;
+  if (!halmet::ParseLatLonE7(s.field(3), s.field(4), &lat) ||
+      !halmet::ParseLatLonE7(s.field(5), s.field(6), &lon) ||
+      !halmet::ParseFixed(s.field(7), 2, &sog_c) ||
+      !halmet::ParseFixed(s.field(8), 2, &cog_c)) {
+    return false;
+  }
+  fix->lat = lat * 1e-7;
+  fix->lon = lon * 1e-7;
+  fix->sog_kn = sog_c / 100.0;
+  fix->cog_deg = cog_c / 100.0;
+  return true;
+}
+
+void test_rmc_parse_cost() {
+  const std::string line =
+      Frame("GPRMC,123519.00,A,4807.03812,N,01131.00047,W,5.42,084.4,"
+            "230394,003.1,W,A");
+  RmcFix legacy, tokenized;
+  TEST_ASSERT_TRUE(LegacyRmc(line.c_str(), &legacy));
+  TEST_ASSERT_TRUE(TokenizedRmc(line.c_str(), &tokenized));
+  TEST_ASSERT_TRUE(std::fabs(legacy.lat - tokenized.lat) < 1e-7);
+  TEST_ASSERT_TRUE(std::fabs(legacy.lon - tokenized.lon) < 1e-7);
+  TEST_ASSERT_TRUE(legacy.sog_kn == tokenized.sog_kn);
+  TEST_ASSERT_TRUE(legacy.cog_deg == tokenized.cog_deg);
+
+  double old_ns = NsPerCall([&](int) {
+    RmcFix fix;
+    LegacyRmc(line.c_str(), &fix);
+    s_sink = (int32_t)fix.lat;
+  });
+  double new_ns = NsPerCall([&](int) {
+    RmcFix fix;
+    TokenizedRmc(line.c_str(), &fix);
+    s_sink = (int32_t)fix.lat;
+  });
+  char msg[100];
+  snprintf(msg, sizeof(msg),
+           "ns per RMC: strchr/atof %.1f / tokenizer + fixed point %.1f",
+           old_ns, new_ns);
+  TEST_MESSAGE(msg);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_splits_fields);
+  RUN_TEST(test_accepts_encapsulation_start);
+  RUN_TEST(test_accepts_lowercase_checksum);
+  RUN_TEST(test_rejects_bad_framing);
+  RUN_TEST(test_field_count_limit);
+  RUN_TEST(test_field_length_limit);
+  RUN_TEST(test_parse_unsigned);
+  RUN_TEST(test_parse_fixed);
+  RUN_TEST(test_parse_lat_lon);
+  RUN_TEST(test_parse_lat_lon_hemisphere_bounds);
+  RUN_TEST(test_rmc_parse_cost);
+  return UNITY_END();
+}
@@ -0,0 +1,298 @@
+// test/test_nmea0183_tcp_server/test_main.cpp
+//
+// Nmea0183TcpServer over loopback: eight clients receive every sentence in
+// order, a ninth is turned away, a client that stops reading loses its own
+// oldest lines without holding up the rest, and closed connections free
+// their slot. The last test reports fan-out throughput.
+
+#include <unity.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "nmea0183_tcp_server.h"
+
+using halmet::Nmea0183TcpServer;
+using Clock = std::chrono::steady_clock;
+
+// Clear of the real port so a running gateway on this host doesn't clash.
+static constexpr uint16_t kPort = Nmea0183TcpServer::kDefaultPort + 10000;
+
+struct TestClient {
+  int fd = -1;
+  std::string pending;      // bytes not yet split into lines
+  uint32_t next_seq = 0;    // sequence number expected next
+  uint32_t lines = 0;
+  bool in_order = true;
+  bool closed = false;
+};
+
+static Nmea0183TcpServer* s_server = nullptr;
+
+static int Connect(int rcvbuf = 0) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (rcvbuf > 0) {
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+  }
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(kPort);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+    close(fd);
+    return -1;
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  return fd;
+}
+
+static int FormatLine(char* buf, size_t size, uint32_t seq) {
+  return snprintf(buf, size, "$HMTST,%08u,A,5045.0002,N,00114.9997,W*00",
+                  (unsigned)seq);
+}
+
+// Reads what has arrived and checks each line carries the next sequence
+// number.
+static void Read(TestClient& c) {
+  char buf[16384];
+  for (;;) {
+    ssize_t n = recv(c.fd, buf, sizeof(buf), 0);
+    if (n == 0) c.closed = true;
+    if (n <= 0) break;
+    c.pending.append(buf, n);
+  }
+  size_t start = 0, end;
+  while ((end = c.pending.find("\r\n", start)) != std::string::npos) {
+    unsigned seq = 0;
+    if (sscanf(c.pending.c_str() + start, "$HMTST,%8u,", &seq) != 1 ||
+        seq != c.next_seq) {
+      c.in_order = false;
+    }
+    c.next_seq = seq + 1;
+    c.lines++;
+    start = end + 2;
+  }
+  c.pending.erase(0, start);
+}
+
+// Calls loop() until `done` or the timeout.
+template <typename Done>
+static bool Pump(Done done, int timeout_ms = 5000) {
+  Clock::time_point deadline =
+      Clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (!done()) {
+    if (Clock::now() > deadline) return false;
+    s_server->loop();
+  }
+  return true;
+}
+
+static std::vector<TestClient> ConnectClients(int n) {
+  std::vector<TestClient> clients(n);
+  int before = s_server->clients();
+  for (TestClient& c : clients) {
+    c.fd = Connect();
+    TEST_ASSERT_TRUE(c.fd >= 0);
+  }
+  TEST_ASSERT_TRUE(Pump([&] { return s_server->clients() == before + n; }));
+  return clients;
+}
+
+static void CloseClients(std::vector<TestClient>& clients) {
+  for (TestClient& c : clients) close(c.fd);
+  // The server notices on its next sends.
+  TEST_ASSERT_TRUE(Pump([] {
+    char line[96];
+    s_server->push(line, FormatLine(line, sizeof(line), 0));
+    return s_server->clients() == 0;
+  }));
+}
+
+void setUp() {
+  s_server = new Nmea0183TcpServer(kPort);
+  s_server->begin();
+}
+
+void tearDown() {
+  delete s_server;
+  s_server = nullptr;
+}
+
+void test_every_client_gets_every_line_in_order() {
+  std::vector<TestClient> clients =
+      ConnectClients(Nmea0183TcpServer::kMaxClients);
+
+  constexpr uint32_t kLines = 20000;
+  char line[96];
+  for (uint32_t seq = 0; seq < kLines; seq++) {
+    s_server->push(line, FormatLine(line, sizeof(line), seq));
+    // Within the ring's 64 lines, so nobody should fall behind.
+    if (seq % 16 == 15) {
+      s_server->loop();
+      for (TestClient& c : clients) Read(c);
+    }
+  }
+  TEST_ASSERT_TRUE(Pump([&] {
+    bool all = true;
+    for (TestClient& c : clients) {
+      Read(c);
+      all = all && c.lines == kLines;
+    }
+    return all;
+  }));
+  for (TestClient& c : clients) TEST_ASSERT_TRUE(c.in_order);
+  TEST_ASSERT_EQUAL_UINT32(0, s_server->stats().lines_dropped);
+  TEST_ASSERT_EQUAL_UINT32(0, s_server->disconnects());
+  CloseClients(clients);
+}
+
+void test_extra_client_is_turned_away() {
+  std::vector<TestClient> clients =
+      ConnectClients(Nmea0183TcpServer::kMaxClients);
+  TestClient extra;
+  extra.fd = Connect();
+  TEST_ASSERT_TRUE(extra.fd >= 0);
+  TEST_ASSERT_TRUE(Pump([&] {
+    Read(extra);
+    return extra.closed;
+  }));
+  TEST_ASSERT_EQUAL_INT(Nmea0183TcpServer::kMaxClients, s_server->clients());
+  close(extra.fd);
+  CloseClients(clients);
+}
+
+void test_stalled_client_does_not_hold_up_the_rest() {
+  std::vector<TestClient> clients = ConnectClients(3);
+  TestClient stalled;
+  stalled.fd = Connect(4096);
+  TEST_ASSERT_TRUE(Pump([] { return s_server->clients() == 4; }));
+
+  // Enough to fill the stalled client's socket buffers several times
+  // over; it never reads.
+  constexpr uint32_t kLines = 200000;
+  char line[96];
+  Clock::time_point t0 = Clock::now();
+  for (uint32_t seq = 0; seq < kLines; seq++) {
+    s_server->push(line, FormatLine(line, sizeof(line), seq));
+    if (seq % 16 == 15) {
+      s_server->loop();
+      for (TestClient& c : clients) Read(c);
+    }
+  }
+  TEST_ASSERT_TRUE(Pump([&] {
+    bool all = true;
+    for (TestClient& c : clients) {
+      Read(c);
+      all = all && c.lines == kLines;
+    }
+    return all;
+  }));
+  double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+  TEST_ASSERT_TRUE(seconds < 10.0);  // never blocked on the stalled socket
+
+  for (TestClient& c : clients) TEST_ASSERT_TRUE(c.in_order);
+  TEST_ASSERT_TRUE(s_server->stats().lines_dropped > 0);
+  TEST_ASSERT_EQUAL_INT(4, s_server->clients());
+
+  // What it did get before stalling is still there to read.
+  Read(stalled);
+  TEST_ASSERT_TRUE(stalled.lines > 0);
+  TEST_ASSERT_TRUE(stalled.lines < kLines);
+
+  clients.push_back(stalled);
+  CloseClients(clients);
+}
+
+void test_closed_client_frees_its_slot() {
+  std::vector<TestClient> clients =
+      ConnectClients(Nmea0183TcpServer::kMaxClients);
+  close(clients[2].fd);
+  char line[96];
+  TEST_ASSERT_TRUE(Pump([&] {
+    s_server->push(line, FormatLine(line, sizeof(line), 0));
+    for (TestClient& c : clients) {
+      if (&c != &clients[2]) Read(c);
+    }
+    return s_server->clients() == Nmea0183TcpServer::kMaxClients - 1;
+  }));
+  TEST_ASSERT_EQUAL_UINT32(1, s_server->disconnects());
+
+  // A new client takes the slot and starts at the next line pushed.
+  TestClient replacement;
+  replacement.fd = Connect();
+  TEST_ASSERT_TRUE(Pump([] {
+    return s_server->clients() == Nmea0183TcpServer::kMaxClients;
+  }));
+  s_server->push(line, FormatLine(line, sizeof(line), 0));
+  TEST_ASSERT_TRUE(Pump([&] {
+    Read(replacement);
+    return replacement.lines == 1;
+  }));
+  TEST_ASSERT_TRUE(replacement.in_order);
+
+  clients[2] = replacement;
+  CloseClients(clients);
+}
+
+void test_fanout_throughput() {
+  std::vector<TestClient> clients =
+      ConnectClients(Nmea0183TcpServer::kMaxClients);
+
+  constexpr uint32_t kLines = 200000;
+  char line[96];
+  int len = FormatLine(line, sizeof(line), 0);
+  Clock::time_point t0 = Clock::now();
+  Clock::duration in_loop{};
+  for (uint32_t seq = 0; seq < kLines; seq++) {
+    s_server->push(line, FormatLine(line, sizeof(line), seq));
+    if (seq % 16 == 15) {
+      Clock::time_point l0 = Clock::now();
+      s_server->loop();
+      in_loop += Clock::now() - l0;
+      for (TestClient& c : clients) Read(c);
+    }
+  }
+  TEST_ASSERT_TRUE(Pump([&] {
+    bool all = true;
+    for (TestClient& c : clients) {
+      Read(c);
+      all = all && c.lines == kLines;
+    }
+    return all;
+  }));
+  double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+  double loop_us = std::chrono::duration<double, std::micro>(in_loop).count();
+  for (TestClient& c : clients) TEST_ASSERT_TRUE(c.in_order);
+
+  char report[200];
+  snprintf(report, sizeof(report),
+           "%d clients x %u lines: %.0f lines/s, %.1f MB/s delivered, "
+           "loop() %.2f us per 16 lines",
+           Nmea0183TcpServer::kMaxClients, (unsigned)kLines,
+           kLines / seconds,
+           (double)kLines * (len + 2) * clients.size() / seconds / 1e6,
+           loop_us / (kLines / 16));
+  TEST_MESSAGE(report);
+  CloseClients(clients);
+}
+
+int main(int, char**) {
+  // A send to a peer that has gone away must fail, not kill the process.
+  signal(SIGPIPE, SIG_IGN);
+  UNITY_BEGIN();
+  RUN_TEST(test_every_client_gets_every_line_in_order);
+  RUN_TEST(test_extra_client_is_turned_away);
+  RUN_TEST(test_stalled_client_does_not_hold_up_the_rest);
+  RUN_TEST(test_closed_client_frees_its_slot);
+  RUN_TEST(test_fanout_throughput);
+  return UNITY_END();
+}
@@ -0,0 +1,295 @@
+// test/test_replay/test_main.cpp
+//
+// Replays recorded NMEA 0183 logs through the AIS gateway exactly as if
+// they had arrived on Serial2, and compares every N2K message it sends
+// byte for byte with the golden file next to each log. After an intended
+// output change, re-record them with
+//
+//   HALMET_UPDATE_GOLDEN=1 pio test -e native -f test_replay
+//
+// and review the diff. On a mismatch the output is written to
+// <log>.actual instead.
+//
+// Log lines are "<ms since start> <sentence>"; lines starting with '#' are
+// comments. Golden lines are "<ms> <pgn> <priority> <length> <hex data>".
+//
+// The last test replays the dense log repeatedly and reports sentence
+// throughput and per-sentence handling latency.
+
+#include <unity.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <N2kMsg.h>
+
+#include "ais_gateway.h"
+#include "host.h"
+
+struct LogLine {
+  uint32_t ms;
+  std::string sentence;
+};
+
+static halmet::AISGatewayConfig s_config{"/test/ais"};
+
+// Replays advance this so every log starts on a fresh, later clock.
+static uint64_t s_clock_base_ms = 0;
+
+static std::vector<std::string> s_captured;
+static uint32_t s_sent = 0;
+
+static std::string TestDir() {
+  std::string file = __FILE__;
+  size_t slash = file.find_last_of('/');
+  return slash == std::string::npos ? "." : file.substr(0, slash);
+}
+
+static std::vector<LogLine> LoadLog(const std::string& path) {
+  std::vector<LogLine> log;
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    size_t space = line.find(' ');
+    if (space == std::string::npos) continue;
+    log.push_back({(uint32_t)std::stoul(line.substr(0, space)),
+                   line.substr(space + 1)});
+  }
+  return log;
+}
+
+static std::string ReadFile(const std::string& path) {
+  std::ifstream in(path);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+static void WriteFile(const std::string& path, const std::string& text) {
+  std::ofstream out(path);
+  out << text;
+}
+
+static bool CaptureSink(const tN2kMsg& msg) {
+  char head[48];
+  snprintf(head, sizeof(head), "%lu %lu %u %d ",
+           (unsigned long)(millis() - s_clock_base_ms), msg.PGN,
+           (unsigned)msg.Priority, msg.DataLen);
+  std::string line = head;
+  for (int i = 0; i < msg.DataLen; i++) {
+    char hex[3];
+    snprintf(hex, sizeof(hex), "%02x", msg.Data[i]);
+    line += hex;
+  }
+  s_captured.push_back(line);
+  return true;
+}
+
+static bool CountSink(const tN2kMsg&) {
+  s_sent++;
+  return true;
+}
+
+static uint32_t LogDurationMs(const std::vector<LogLine>& log) {
+  return log.empty() ? 0 : log.back().ms;
+}
+
+// Feeds the log with the clock following its timestamps, then moves the
+// clock base past it and well beyond every target timeout.
+static void Replay(const std::vector<LogLine>& log) {
+  for (const LogLine& l : log) {
+    HostSetMicros((s_clock_base_ms + l.ms) * 1000ULL);
+    AISGatewayFeedLine(l.sentence.c_str());
+  }
+  s_clock_base_ms += LogDurationMs(log) + 3600000;
+}
+
+static void CheckGolden(const char* name) {
+  std::string log_path = TestDir() + "/" + name + ".log";
+  std::string golden_path = TestDir() + "/" + name + ".golden";
+  std::vector<LogLine> log = LoadLog(log_path);
+  TEST_ASSERT_TRUE_MESSAGE(!log.empty(), log_path.c_str());
+
+  s_captured.clear();
+  AISGatewaySetN2kSink(CaptureSink);
+  Replay(log);
+  AISGatewaySetN2kSink(nullptr);
+
+  std::string actual;
+  for (const std::string& line : s_captured) actual += line + "\n";
+
+  const char* update = getenv("HALMET_UPDATE_GOLDEN");
+  if (update && *update && *update != '0') {
+    WriteFile(golden_path, actual);
+    TEST_MESSAGE(("re-recorded " + golden_path).c_str());
+    return;
+  }
+
+  std::string expected = ReadFile(golden_path);
+  if (expected != actual) {
+    WriteFile(log_path + ".actual", actual);
+    // Point at the first differing message to make the failure readable.
+    std::istringstream e(expected), a(actual);
+    std::string el, al;
+    int n = 1;
+    while (std::getline(e, el) && std::getline(a, al) && el == al) n++;
+    std::string msg = "N2K output differs from " + golden_path +
+                      " at message " + std::to_string(n) + "; see " +
+                      log_path + ".actual";
+    TEST_FAIL_MESSAGE(msg.c_str());
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Own ship moving through dense traffic: Class A and B positions, a base
+// station and 1 Hz RMC fixes.
+void test_solent_matches_golden() { CheckGolden("solent"); }
+
+// Range extremes, "not available" fields, the midnight rollover,
+// multi-part and VDO framing, and lines the gateway must drop.
+void test_edge_cases_match_golden() { CheckGolden("edge_cases"); }
+
+static std::vector<tN2kMsg> s_messages;
+
+static bool KeepSink(const tN2kMsg& msg) {
+  s_messages.push_back(msg);
+  return true;
+}
+
+static uint32_t Le(const tN2kMsg& msg, int offset, int bytes) {
+  uint32_t v = 0;
+  for (int i = bytes - 1; i >= 0; i--) v = v << 8 | msg.Data[offset + i];
+  return v;
+}
+
+// A GGA-only receiver never sets the timebase: 129029 must say the date
+// is unknown rather than claim 1970-01-01. Runs before any log has
+// replayed an RMC.
+void test_gga_before_time_reference() {
+  s_messages.clear();
+  AISGatewaySetN2kSink(KeepSink);
+  HostSetMicros((s_clock_base_ms + 1) * 1000ULL);
+  AISGatewayFeedLine(
+      "$GPGGA,113000.15,5045.0002,N,00114.9997,W,1,08,0.9,12.3,M,47.0,M,,*47");
+  AISGatewayFeedLine(
+      "$GPGGA,,5045.0002,N,00114.9997,W,1,08,0.9,12.3,M,47.0,M,,*6E");
+  AISGatewaySetN2kSink(nullptr);
+  s_clock_base_ms += 3600000;
+
+  std::vector<const tN2kMsg*> fixes;
+  for (const tN2kMsg& m : s_messages) {
+    if (m.PGN == 129029) fixes.push_back(&m);
+  }
+  TEST_ASSERT_EQUAL_INT(2, (int)fixes.size());
+  TEST_ASSERT_EQUAL_UINT32(0xffff, Le(*fixes[0], 1, 2));       // days N/A
+  TEST_ASSERT_EQUAL_UINT32(414001500, Le(*fixes[0], 3, 4));    // 11:30:00.15
+  TEST_ASSERT_EQUAL_UINT32(0xffff, Le(*fixes[1], 1, 2));
+  TEST_ASSERT_EQUAL_UINT32(0xffffffff, Le(*fixes[1], 3, 4));   // no time
+}
+
+// "!AIVDM,1,1,,A,<payload>,0*hh" for a 168-bit message of the given type
+// and MMSI, every other field zero.
+static std::string Vdm(int type, uint32_t mmsi) {
+  uint8_t bits[168] = {};
+  auto put = [&](int offset, int width, uint32_t v) {
+    for (int i = 0; i < width; i++)
+      bits[offset + i] = (v >> (width - 1 - i)) & 1;
+  };
+  put(0, 6, type);
+  put(8, 30, mmsi);
+  std::string body = "AIVDM,1,1,,A,";
+  for (int i = 0; i < 168; i += 6) {
+    int v = 0;
+    for (int b = 0; b < 6; b++) v = (v << 1) | bits[i + b];
+    body += (char)(v < 40 ? 48 + v : 56 + v);
+  }
+  body += ",0";
+  uint8_t cksum = 0;
+  for (char c : body) cksum ^= (uint8_t)c;
+  char hex[4];
+  snprintf(hex, sizeof(hex), "%02X", cksum);
+  return "!" + body + "*" + hex;
+}
+
+// Base stations, SAR aircraft and AtoNs are forwarded but never take a
+// target table slot; vessel reports do.
+void test_only_vessels_take_target_slots() {
+  AISGatewaySetN2kSink(CountSink);
+  HostSetMicros((s_clock_base_ms + 1) * 1000ULL);
+  uint32_t before = AISGatewayGetStats().targets.size;
+  s_sent = 0;
+  for (uint32_t i = 0; i < 50; i++) {
+    AISGatewayFeedLine(Vdm(4, 2320000 + i).c_str());    // base station
+    AISGatewayFeedLine(Vdm(9, 111232000 + i).c_str());  // SAR aircraft
+    AISGatewayFeedLine(Vdm(21, 992320000 + i).c_str()); // AtoN
+  }
+  TEST_ASSERT_EQUAL_UINT32(150, s_sent);
+  TEST_ASSERT_EQUAL_UINT32(before, AISGatewayGetStats().targets.size);
+
+  AISGatewayFeedLine(Vdm(1, 232999001).c_str());
+  AISGatewaySetN2kSink(nullptr);
+  s_clock_base_ms += 3600000;
+  TEST_ASSERT_EQUAL_UINT32(before + 1, AISGatewayGetStats().targets.size);
+}
+
+void test_solent_throughput() {
+  std::vector<LogLine> log = LoadLog(TestDir() + "/solent.log");
+  TEST_ASSERT_TRUE(!log.empty());
+
+  constexpr int kPasses = 20;
+  std::vector<float> latency_us;
+  latency_us.reserve(log.size() * kPasses);
+
+  s_sent = 0;
+  AISGatewaySetN2kSink(CountSink);
+  using Clock = std::chrono::steady_clock;
+  Clock::duration total{};
+  for (int pass = 0; pass < kPasses; pass++) {
+    for (const LogLine& l : log) {
+      HostSetMicros((s_clock_base_ms + l.ms) * 1000ULL);
+      Clock::time_point t0 = Clock::now();
+      AISGatewayFeedLine(l.sentence.c_str());
+      Clock::duration dt = Clock::now() - t0;
+      total += dt;
+      latency_us.push_back(
+          std::chrono::duration<float, std::micro>(dt).count());
+    }
+    s_clock_base_ms += LogDurationMs(log) + 1000;
+  }
+  AISGatewaySetN2kSink(nullptr);
+  TEST_ASSERT_GREATER_THAN(0, s_sent);
+
+  std::sort(latency_us.begin(), latency_us.end());
+  auto pct = [&](double p) {
+    return latency_us[(size_t)(p * (latency_us.size() - 1))];
+  };
+  double seconds = std::chrono::duration<double>(total).count();
+  char report[200];
+  snprintf(report, sizeof(report),
+           "%zu sentences, %lu N2K messages: %.0f sentences/s, "
+           "latency p50 %.2f us, p99 %.2f us, max %.2f us",
+           latency_us.size(), (unsigned long)s_sent,
+           latency_us.size() / seconds, pct(0.50), pct(0.99),
+           latency_us.back());
+  TEST_MESSAGE(report);
+}
+
+int main(int, char**) {
+  AISGatewayInit(&s_config);
+  UNITY_BEGIN();
+  RUN_TEST(test_gga_before_time_reference);
+  RUN_TEST(test_solent_matches_golden);
+  RUN_TEST(test_edge_cases_match_golden);
+  RUN_TEST(test_only_vessels_take_target_slots);
+  RUN_TEST(test_solent_throughput);
+  return UNITY_END();
+}